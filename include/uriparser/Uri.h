@@ -178,6 +178,141 @@ typedef struct URI_TYPE(ParserStateStruct) {
     void * reserved; /**< Reserved to the parser */
 } URI_TYPE(ParserState); /**< @copydoc UriParserStateStructA */
 
+/**
+ * Represents the state of an incremental parser that is fed
+ * its input in chunks, see uriParseChunkA.
+ * The state is opaque: it is created by uriAllocChunkParserStateMmA
+ * and read through accessor functions only, so that it can change
+ * without breaking the ABI.
+ *
+ * @see uriAllocChunkParserStateMmA
+ * @see uriParseChunkA
+ * @see uriGetChunkParserUriA
+ * @see uriGetChunkParserErrorCodeA
+ * @see uriGetChunkParserErrorOffsetA
+ * @see uriFreeChunkParserStateA
+ * @since 1.1.0
+ */
+typedef struct URI_TYPE(ChunkParserStateStruct) URI_TYPE(ChunkParserState);
+
+/**
+ * Represents the state of decoding percent-encoded text that
+ * arrives in chunks, see uriUnescapeChunkExA.
+ * Members are internal and should not be accessed directly.
+ *
+ * @see uriInitUnescapeStateA
+ * @see uriUnescapeChunkExA
+ * @since 1.1.0
+ */
+typedef struct URI_TYPE(UnescapeStateStruct) {
+    URI_CHAR pending[2]; /**< Start of a percent group cut off by the end of a chunk */
+    unsigned char pendingCount; /**< Number of characters held in pending */
+    UriBool prevWasCr; /**< Whether the last character decoded was a CR */
+} URI_TYPE(UnescapeState); /**< @copydoc UriUnescapeStateStructA */
+
+/**
+ * Holds all path segments of a %URI in a single block of memory,
+ * together with its IPv4 or IPv6 host data,
+ * see uriParseSingleUriExFlatMmA and UriUriInlineA.
+ * Pointed to by <c>reserved</c> of the %URI.
+ * All members are internal and should not be accessed directly.
+ *
+ * @since 1.1.0
+ */
+typedef struct URI_TYPE(PathSegmentBlockStruct) {
+    union {
+        UriIp4 ip4; /**< IPv4 host data */
+        UriIp6 ip6; /**< IPv6 host data */
+    } host; /**< Pointed to by .hostData.ip4 or .hostData.ip6, if in use */
+    size_t capacity; /**< Number of segments in the block */
+    size_t used; /**< Number of segments handed out so far */
+    UriBool isInline; /**< Part of a UriUriInlineA rather than allocated */
+    URI_TYPE(PathSegment) * segments; /**< First segment of the block */
+} URI_TYPE(PathSegmentBlock); /**< @copydoc UriPathSegmentBlockStructA */
+
+/**
+ * Represents an RFC 3986 %URI together with inline storage for
+ * its first URI_INLINE_SEGMENT_COUNT path segments and its IPv4 or IPv6
+ * host data, see uriParseSingleUriInlineMmA.
+ * So parsing a %URI with a short path takes no allocation at all;
+ * longer paths take an allocation per path segment beyond those.
+ *
+ * Pass <c>&amp;x.uri</c> to all other functions. Members other than
+ * <c>uri</c> are internal and should not be accessed directly.
+ * The structure must not be copied byte-wise or moved while
+ * <c>uri</c> is in use, because <c>uri</c> points into the structure.
+ *
+ * @see uriParseSingleUriInlineMmA
+ * @since 1.1.0
+ */
+typedef struct URI_TYPE(UriInlineStruct) {
+    URI_TYPE(Uri) uri; /**< %URI to pass to other functions */
+    URI_TYPE(PathSegmentBlock) block; /**< Inline block, see UriPathSegmentBlockA */
+    URI_TYPE(PathSegment) segments[URI_INLINE_SEGMENT_COUNT]; /**< Inline segments */
+} URI_TYPE(UriInline); /**< @copydoc UriUriInlineStructA */
+
+/**
+ * Represents a parser that is reused for parsing %URI after %URI,
+ * see uriParseSingleUriContextA.
+ * Path segments and host data freed by uriFreeUriMembersContextA
+ * are kept for reuse by the next parse rather than returned
+ * to the memory manager, so that parsing in steady state takes hardly
+ * any allocator traffic.
+ * Members are internal and should not be accessed directly,
+ * and a parser context must not be copied byte-wise
+ * because <c>memory</c> refers to <c>recycler</c>.
+ *
+ * @see uriInitParserContextMmA
+ * @see uriParseSingleUriContextA
+ * @see uriFreeUriMembersContextA
+ * @see uriFreeParserContextA
+ * @since 1.1.0
+ */
+typedef struct URI_TYPE(ParserContextStruct) {
+    UriMemoryManager memory; /**< Recycling memory manager used for parsing */
+    UriMemoryRecycler recycler; /**< Freed allocations kept for reuse */
+} URI_TYPE(ParserContext); /**< @copydoc UriParserContextStructA */
+
+/**
+ * Holds a %URI in compact form: The text of all components
+ * is stored back to back in a single block of memory together
+ * with this structure, components are delimited by 32-bit offsets
+ * into that text, and IP addresses are stored inline.
+ * So a compact %URI takes a single allocation and no pointers
+ * to follow, unlike UriUriA with its path segment list.
+ *
+ * Components are stored in this order, each ending where the next begins:
+ * scheme (starting at offset 0), user info, host text, port, path, query,
+ * and fragment. Text is stored without delimiters like ":" or "//",
+ * except for the slashes between path segments.
+ * Path segment <c>i</c> ends at <c>segmentEnds[i]</c>
+ * and starts at <c>portTextEnd</c> for the first segment,
+ * or one after the end of the previous segment otherwise.
+ *
+ * Compact URIs are made by uriCompactFromUriMmA
+ * and freed by uriFreeCompactMmA; they must not be copied byte-wise
+ * because <c>text</c> and <c>segmentEnds</c> point into the block itself.
+ *
+ * @see uriCompactFromUriMmA
+ * @see uriUriFromCompactMmA
+ * @see uriFreeCompactMmA
+ * @since 1.1.0
+ */
+typedef struct URI_TYPE(CompactStruct) {
+    const URI_CHAR * text; /**< Text of all components, zero-terminated */
+    const uint32_t * segmentEnds; /**< End offsets of all path segments */
+    uint32_t segmentCount; /**< Number of path segments, 0 for no path */
+    uint32_t schemeEnd; /**< Offset after the scheme */
+    uint32_t userInfoEnd; /**< Offset after the user info */
+    uint32_t hostTextEnd; /**< Offset after the host text */
+    uint32_t portTextEnd; /**< Offset after the port */
+    uint32_t pathEnd; /**< Offset after the path */
+    uint32_t queryEnd; /**< Offset after the query */
+    uint32_t fragmentEnd; /**< Offset after the fragment */
+    unsigned short flags; /**< Combination of UriCompactFlags */
+    unsigned char ipData[16]; /**< IPv4 or IPv6 address bytes, see flags */
+} URI_TYPE(Compact); /**< @copydoc UriCompactStructA */
+
 /**
  * Represents a query element.
  * More precisely it is a node in a linked
@@ -344,6 +479,692 @@ URI_PUBLIC int URI_FUNC(ParseSingleUriExMm)(URI_TYPE(Uri) * uri, const URI_CHAR
         const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
         UriMemoryManager * memory);
 
+/**
+ * Parses a single RFC 3986 %URI, like uriParseSingleUriExMmA does,
+ * but with all path segments stored in a single flat block of memory
+ * rather than allocating each path segment on its own.
+ * The same block also holds <c>uri->hostData.ip4</c> or
+ * <c>uri->hostData.ip6</c> for IPv4 and IPv6 hosts.
+ * So parsing a %URI takes a single allocation for the whole path
+ * and host data (or none, if there is neither a path nor an IP host).
+ *
+ * The path is still available as a linked list
+ * from <c>uri->pathHead</c> to <c>uri->pathTail</c>,
+ * and all functions of uriparser can be used on the resulting %URI.
+ * The block of path segments is freed by uriFreeUriMembersMmA as usual.
+ *
+ * NOTE: Path segments and IP host data of such a %URI must not be
+ *       freed individually by the caller.
+ *
+ * @param uri         <b>OUT</b>: Output %URI, must not be NULL
+ * @param first       <b>IN</b>: Pointer to the first character to parse,
+ *                               must not be NULL
+ * @param afterLast   <b>IN</b>: Pointer to the character after the last to
+ *                               parse, must not be NULL
+ * @param errorPos    <b>OUT</b>: Pointer to a pointer to the first character
+ *                                causing a syntax error, can be NULL;
+ *                                only set when URI_ERROR_SYNTAX was returned
+ * @param memory      <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return            0 on success, error code otherwise
+ *
+ * @see uriParseSingleUriExMmA
+ * @see uriFreeUriMembersMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ParseSingleUriExFlatMm)(URI_TYPE(Uri) * uri,
+        const URI_CHAR * first, const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
+        UriMemoryManager * memory);
+
+/**
+ * Parses a single RFC 3986 %URI, like uriParseSingleUriExFlatMmA does,
+ * but storing the first URI_INLINE_SEGMENT_COUNT path segments and
+ * IPv4 or IPv6 host data inside <c>uriInline</c>, see UriUriInlineA.
+ * Path segments beyond those are allocated one by one.
+ * So parsing a %URI with a short path takes no allocation at all.
+ *
+ * <c>uriInline-&gt;uri</c> can be used with all functions of uriparser
+ * and is freed by uriFreeUriMembersMmA as usual.
+ *
+ * @param uriInline   <b>OUT</b>: Output %URI with inline storage,
+ *                                must not be NULL
+ * @param first       <b>IN</b>: Pointer to the first character to parse,
+ *                               must not be NULL
+ * @param afterLast   <b>IN</b>: Pointer to the character after the last to
+ *                               parse, must not be NULL
+ * @param errorPos    <b>OUT</b>: Pointer to a pointer to the first character
+ *                                causing a syntax error, can be NULL;
+ *                                only set when URI_ERROR_SYNTAX was returned
+ * @param memory      <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return            0 on success, error code otherwise
+ *
+ * @see UriUriInlineA
+ * @see uriParseSingleUriExFlatMmA
+ * @see uriFreeUriMembersMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ParseSingleUriInlineMm)(URI_TYPE(UriInline) * uriInline,
+        const URI_CHAR * first, const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
+        UriMemoryManager * memory);
+
+/**
+ * Parses a single RFC 3986 %URI, like uriParseSingleUriExMmA does,
+ * but without splitting the path into segments: The raw path text
+ * (without a leading slash) is kept as a single path segment
+ * that may contain slashes, until the path segments are needed.
+ * So parsing a %URI takes a single allocation for the whole path
+ * (or none, if the path is empty).
+ *
+ * Call uriEnsurePathSegmentsMmA before walking the list
+ * from <c>uri->pathHead</c> to <c>uri->pathTail</c> yourself.
+ * Functions of uriparser that need path segments split the path
+ * on their own, e.g. uriNormalizeSyntaxExMmA and uriAddBaseUriExMmA;
+ * uriToStringA and uriEqualsUriA work on the raw path as is.
+ * Copies made by uriCopyUriMmA keep the path unsplit.
+ *
+ * @param uri         <b>OUT</b>: Output %URI, must not be NULL
+ * @param first       <b>IN</b>: Pointer to the first character to parse,
+ *                               must not be NULL
+ * @param afterLast   <b>IN</b>: Pointer to the character after the last to
+ *                               parse, must not be NULL
+ * @param errorPos    <b>OUT</b>: Pointer to a pointer to the first character
+ *                                causing a syntax error, can be NULL;
+ *                                only set when URI_ERROR_SYNTAX was returned
+ * @param memory      <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return            0 on success, error code otherwise
+ *
+ * @see uriEnsurePathSegmentsMmA
+ * @see uriParseSingleUriExMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ParseSingleUriExLazyMm)(URI_TYPE(Uri) * uri,
+        const URI_CHAR * first, const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
+        UriMemoryManager * memory);
+
+/**
+ * Splits the raw path of a %URI parsed by uriParseSingleUriExLazyMmA
+ * into regular path segments, in place.
+ * For any other %URI or a path split before, nothing is done,
+ * so it is safe to call on any %URI.
+ *
+ * @param uri     <b>INOUT</b>: %URI to split the path of, must not be NULL
+ * @param memory  <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return        0 on success, error code otherwise
+ *
+ * @see uriEnsurePathSegmentsA
+ * @see uriParseSingleUriExLazyMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(EnsurePathSegmentsMm)(
+        URI_TYPE(Uri) * uri, UriMemoryManager * memory);
+
+/**
+ * Splits the raw path of a %URI parsed by uriParseSingleUriExLazyMmA
+ * into regular path segments, in place, using the default memory manager.
+ *
+ * @param uri     <b>INOUT</b>: %URI to split the path of, must not be NULL
+ * @return        0 on success, error code otherwise
+ *
+ * @see uriEnsurePathSegmentsMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(EnsurePathSegments)(URI_TYPE(Uri) * uri);
+
+/**
+ * Parses a single RFC 3986 %URI, like uriParseSingleUriExMmA does,
+ * but skipping the work that options ask to skip, so that callers
+ * only pay for the components they consume:
+ *
+ * - With URI_PARSE_SKIP_HOST_DATA, the binary form of IPv4 and IPv6
+ *   hosts is not decoded, while <c>uri->hostText</c> is set as usual.
+ *   <c>uri->hostData.ip4</c> and <c>uri->hostData.ip6</c> are left unset,
+ *   and <c>uri->hostData.ipFuture</c> is only set for IPvFuture hosts,
+ *   as usual. An IPv6 host is then told apart from a registered name
+ *   by the ":" in <c>uri->hostText</c> that a registered name cannot
+ *   contain; recomposition, normalization and comparison rely on that.
+ * - With URI_PARSE_RAW_PATH_ONLY, the path is kept as a single raw
+ *   path segment, see uriParseSingleUriExLazyMmA.
+ * - With URI_PARSE_STOP_AFTER_AUTHORITY, parsing stops where the
+ *   authority ends, or after the scheme if there is no authority.
+ *   Path, query and fragment are left unset and are not checked
+ *   for syntax errors at all.
+ * - With URI_PARSE_KEEP_PARTIAL, a syntax error does not discard
+ *   the components parsed completely before the error: scheme,
+ *   authority (user info, host and port, all or nothing, and only if
+ *   followed by "/", "?", "#" or the end of input), path segments,
+ *   and query. URI_ERROR_SYNTAX is still returned, with
+ *   <c>*errorPos</c> set as usual, and <c>uri</c> must be freed
+ *   using uriFreeUriMembersMmA in that case, too.
+ * - With URI_PARSE_IRI, input is parsed as an RFC 3987 IRI: characters
+ *   of ucschar are accepted wherever iunreserved is allowed (user info,
+ *   reg-name hosts, path, query and fragment), and characters of iprivate
+ *   in the query, too. They have to be encoded as well-formed UTF-8 with
+ *   <c>char</c>, and as UTF-16 or UTF-32 with <c>wchar_t</c>.
+ *   Use uriToStringAsUriA to recompose an IRI as a %URI.
+ *
+ * @param uri         <b>OUT</b>: Output %URI, must not be NULL
+ * @param first       <b>IN</b>: Pointer to the first character to parse,
+ *                               must not be NULL
+ * @param afterLast   <b>IN</b>: Pointer to the character after the last to
+ *                               parse, must not be NULL
+ * @param errorPos    <b>OUT</b>: Pointer to a pointer to the first character
+ *                                causing a syntax error, can be NULL;
+ *                                only set when URI_ERROR_SYNTAX was returned
+ * @param options     <b>IN</b>: Bitwise OR of UriParseOptions flags
+ * @param memory      <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return            0 on success, error code otherwise
+ *
+ * @see uriParseSingleUriOptionsA
+ * @see uriParseSingleUriExMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ParseSingleUriOptionsMm)(URI_TYPE(Uri) * uri,
+        const URI_CHAR * first, const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
+        unsigned int options, UriMemoryManager * memory);
+
+/**
+ * Parses a single RFC 3986 %URI, skipping the work that options ask to skip,
+ * using the default memory manager.
+ *
+ * @param uri         <b>OUT</b>: Output %URI, must not be NULL
+ * @param first       <b>IN</b>: Pointer to the first character to parse,
+ *                               must not be NULL
+ * @param afterLast   <b>IN</b>: Pointer to the character after the last to
+ *                               parse, can be NULL
+ *                               (to use first + strlen(first))
+ * @param errorPos    <b>OUT</b>: Pointer to a pointer to the first character
+ *                                causing a syntax error, can be NULL;
+ *                                only set when URI_ERROR_SYNTAX was returned
+ * @param options     <b>IN</b>: Bitwise OR of UriParseOptions flags
+ * @return            0 on success, error code otherwise
+ *
+ * @see uriParseSingleUriOptionsMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ParseSingleUriOptions)(URI_TYPE(Uri) * uri,
+        const URI_CHAR * first, const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
+        unsigned int options);
+
+/**
+ * Parses a single RFC 3986 %URI, repairing input that has characters
+ * not allowed where they are, as commonly seen in URLs from browsers
+ * and crawlers, e.g. raw spaces, "|", "^", non-ASCII bytes or a "%"
+ * not starting a percent-encoded triplet.
+ *
+ * Input that parses fine as is is parsed in place, and <c>out</c> is
+ * left untouched. Otherwise, a repaired copy of the input is written to
+ * <c>out</c>, zero-terminated, with every character that is not allowed
+ * where it is percent-encoded (in uppercase, like uriEscapeExA does),
+ * and <c>uri</c> then points into <c>out</c>. A "%" not starting
+ * a percent-encoded triplet is encoded, as is any "@" before the last one
+ * of the authority. Scheme, IP literals and port are copied as is,
+ * so that errors in those remain errors; <c>out</c> then holds the copy
+ * up to the error, followed by the rest of the input as is.
+ *
+ * Repairing takes a single pass: the copy is written as the input
+ * is parsed, from the first character that needs percent-encoding on,
+ * with the grammar of uriParseChunkA.
+ *
+ * With wchar_t, characters beyond ASCII are percent-encoded as UTF-8,
+ * with UTF-16 surrogate pairs combined, like uriToStringAsUriW does.
+ *
+ * If the copy does not fit into <c>outCapacity</c> characters,
+ * URI_ERROR_OUTPUT_TOO_LARGE is returned, with <c>*charsRequired</c>
+ * telling how many characters it takes (plus one for the terminator).
+ *
+ * @param uri            <b>OUT</b>: Output %URI, must not be NULL
+ * @param first          <b>IN</b>: Pointer to the first character to parse,
+ *                                  must not be NULL
+ * @param afterLast      <b>IN</b>: Pointer to the character after the last to
+ *                                  parse, must not be NULL
+ * @param out            <b>OUT</b>: Destination for the repaired copy,
+ *                                   must not be NULL
+ * @param outCapacity    <b>IN</b>: Size of <c>out</c> in characters,
+ *                                  including space for the terminator
+ * @param charsRequired  <b>OUT</b>: Length of the repaired copy in characters,
+ *                                   without the terminator, 0 if none was needed;
+ *                                   can be NULL
+ * @param repaired       <b>OUT</b>: Whether <c>uri</c> points into <c>out</c>,
+ *                                   can be NULL
+ * @param errorPos       <b>OUT</b>: Pointer to a pointer to the first character
+ *                                   causing a syntax error, can be NULL;
+ *                                   only set when URI_ERROR_SYNTAX was returned,
+ *                                   then pointing into <c>out</c>
+ * @param memory         <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return               0 on success, error code otherwise
+ *
+ * @see uriParseSingleUriRepairA
+ * @see uriParseSingleUriExMmA
+ * @see uriParseChunkA
+ * @see uriEscapeExA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ParseSingleUriRepairMm)(URI_TYPE(Uri) * uri,
+        const URI_CHAR * first, const URI_CHAR * afterLast, URI_CHAR * out,
+        int outCapacity, int * charsRequired, UriBool * repaired,
+        const URI_CHAR ** errorPos, UriMemoryManager * memory);
+
+/**
+ * Parses a single RFC 3986 %URI, repairing input that has characters
+ * not allowed where they are, using the default memory manager.
+ *
+ * @param uri            <b>OUT</b>: Output %URI, must not be NULL
+ * @param first          <b>IN</b>: Pointer to the first character to parse,
+ *                                  must not be NULL
+ * @param afterLast      <b>IN</b>: Pointer to the character after the last to
+ *                                  parse, can be NULL
+ *                                  (to use first + strlen(first))
+ * @param out            <b>OUT</b>: Destination for the repaired copy,
+ *                                   must not be NULL
+ * @param outCapacity    <b>IN</b>: Size of <c>out</c> in characters,
+ *                                  including space for the terminator
+ * @param charsRequired  <b>OUT</b>: Length of the repaired copy in characters,
+ *                                   without the terminator, 0 if none was needed;
+ *                                   can be NULL
+ * @param repaired       <b>OUT</b>: Whether <c>uri</c> points into <c>out</c>,
+ *                                   can be NULL
+ * @param errorPos       <b>OUT</b>: Pointer to a pointer to the first character
+ *                                   causing a syntax error, can be NULL;
+ *                                   only set when URI_ERROR_SYNTAX was returned
+ * @return               0 on success, error code otherwise
+ *
+ * @see uriParseSingleUriRepairMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ParseSingleUriRepair)(URI_TYPE(Uri) * uri,
+        const URI_CHAR * first, const URI_CHAR * afterLast, URI_CHAR * out,
+        int outCapacity, int * charsRequired, UriBool * repaired,
+        const URI_CHAR ** errorPos);
+
+/**
+ * Checks whether text is a syntactically valid RFC 3986 %URI reference,
+ * with the same grammar and error positions as uriParseSingleUriExA,
+ * but without building any %URI structure.
+ * No memory is allocated, ever.
+ *
+ * @param first       <b>IN</b>: Pointer to the first character to check,
+ *                               must not be NULL
+ * @param afterLast   <b>IN</b>: Pointer to the character after the last to
+ *                               check, can be NULL
+ *                               (to use first + strlen(first))
+ * @param errorPos    <b>OUT</b>: Pointer to a pointer to the first character
+ *                                causing a syntax error, can be NULL;
+ *                                only set when URI_ERROR_SYNTAX was returned
+ * @return            0 if valid, error code otherwise
+ *
+ * @see uriParseSingleUriExA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ValidateUriEx)(
+        const URI_CHAR * first, const URI_CHAR * afterLast, const URI_CHAR ** errorPos);
+
+/**
+ * Parses an array of RFC 3986 URIs in one go, like calling
+ * uriParseSingleUriExMmA for each of them, but with parameter checks
+ * and parser setup done once for the whole batch.
+ * A failing item does not stop the batch; its %URI is left
+ * with no memory to free and its error is reported per item.
+ *
+ * Combined with an arena memory manager (see uriInitArenaMemoryManager),
+ * all URIs of a batch can be freed at once by resetting the arena.
+ *
+ * @param uris            <b>OUT</b>: Array of <c>count</c> output URIs,
+ *                                    can only be NULL if <c>count</c> is 0
+ * @param firsts          <b>IN</b>: Array of <c>count</c> pointers to the first
+ *                                   character to parse, can only be NULL
+ *                                   if <c>count</c> is 0
+ * @param afterLasts      <b>IN</b>: Array of <c>count</c> pointers to the character
+ *                                   after the last to parse, can be NULL
+ *                                   (to use strlen for all items)
+ * @param count           <b>IN</b>: Number of items to parse
+ * @param errorCodes      <b>OUT</b>: Array of <c>count</c> per-item error codes,
+ *                                    0 for success, can be NULL
+ * @param errorPositions  <b>OUT</b>: Array of <c>count</c> per-item pointers
+ *                                    to the first character causing a syntax error
+ *                                    or NULL, can be NULL
+ * @param memory          <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return                0 if all items parsed fine, error code of the first
+ *                        failing item or of invalid parameters otherwise
+ *
+ * @see uriParseSingleUriExMmA
+ * @see uriFreeUriMembersMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ParseBatchExMm)(URI_TYPE(Uri) * uris,
+        const URI_CHAR * const * firsts, const URI_CHAR * const * afterLasts,
+        size_t count, int * errorCodes, const URI_CHAR ** errorPositions,
+        UriMemoryManager * memory);
+
+/**
+ * Parses an array of RFC 3986 URIs like uriParseBatchExMmA does,
+ * but spread over up to <c>threadCount</c> threads.
+ * Items are handed out to the threads in contiguous runs;
+ * threads that run out of work take over items of the others.
+ * The calling thread does its share of the work as well.
+ *
+ * Output is deterministic: no matter which thread parsed an item,
+ * its results land at the same index, and the return value is that of
+ * the first failing item, just like with uriParseBatchExMmA.
+ *
+ * Each thread allocates from its own memory manager, <c>memories[i]</c>
+ * for thread <c>i</c>, so there is no contention for a shared allocator.
+ * A memory manager must therefore not be given for more than one thread,
+ * unless it is safe to use from multiple threads at once (like the default one).
+ * Which memory manager an item was parsed with is reported
+ * through <c>memoryIndices</c>, and is the one to free it with.
+ *
+ * Threads are only used if uriparser was built with CMake option
+ * <c>URIPARSER_ENABLE_THREADS</c> turned on; otherwise, all items
+ * are parsed by the calling thread using <c>memories[0]</c>.
+ *
+ * @param uris            <b>OUT</b>: Array of <c>count</c> output URIs,
+ *                                    can only be NULL if <c>count</c> is 0
+ * @param firsts          <b>IN</b>: Array of <c>count</c> pointers to the first
+ *                                   character to parse, can only be NULL
+ *                                   if <c>count</c> is 0
+ * @param afterLasts      <b>IN</b>: Array of <c>count</c> pointers to the character
+ *                                   after the last to parse, can be NULL
+ *                                   (to use strlen for all items)
+ * @param count           <b>IN</b>: Number of items to parse
+ * @param errorCodes      <b>OUT</b>: Array of <c>count</c> per-item error codes,
+ *                                    0 for success, can be NULL
+ * @param errorPositions  <b>OUT</b>: Array of <c>count</c> per-item pointers
+ *                                    to the first character causing a syntax error
+ *                                    or NULL, can be NULL
+ * @param threadCount     <b>IN</b>: Maximum number of threads to use,
+ *                                   0 is treated like 1
+ * @param memories        <b>IN</b>: Array of <c>threadCount</c> memory managers,
+ *                                   one per thread, can be NULL (and so can
+ *                                   its elements) for default libc
+ * @param memoryIndices   <b>OUT</b>: Array of <c>count</c> per-item indices
+ *                                    into <c>memories</c>, can be NULL
+ * @return                0 if all items parsed fine, error code of the first
+ *                        failing item or of invalid parameters otherwise
+ *
+ * @see uriParseBatchExMmA
+ * @see uriInitArenaMemoryManager
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ParseBatchParallelExMm)(URI_TYPE(Uri) * uris,
+        const URI_CHAR * const * firsts, const URI_CHAR * const * afterLasts,
+        size_t count, int * errorCodes, const URI_CHAR ** errorPositions,
+        unsigned int threadCount, UriMemoryManager * const * memories,
+        unsigned int * memoryIndices);
+
+/**
+ * Allocates the state of an incremental parser that accepts its input
+ * in chunks, e.g. as it arrives from a socket, see uriParseChunkA.
+ * The state must be freed using uriFreeChunkParserStateA when done.
+ *
+ * @param state      <b>OUT</b>: Output for the new parser state, must not be NULL
+ * @param uri        <b>OUT</b>: Output %URI, filled once the final chunk arrives,
+ *                               must not be NULL
+ * @param maxLength  <b>IN</b>: Maximum input length in characters,
+ *                              0 for no limit
+ * @param memory     <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return           0 on success, error code otherwise
+ *
+ * @see uriParseChunkA
+ * @see uriFreeChunkParserStateA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(AllocChunkParserStateMm)(URI_TYPE(ChunkParserState) ** state,
+        URI_TYPE(Uri) * uri, size_t maxLength, UriMemoryManager * memory);
+
+/**
+ * Feeds the next chunk of input to an incremental parser.
+ * The parser state carries the grammar rule being parsed and the offsets
+ * of the components found so far from one chunk to the next, so that
+ * input that exceeds the maximum length or that cannot be the beginning
+ * of a valid RFC 3986 %URI is rejected at the first offending character,
+ * before the rest of it arrives.
+ *
+ * With <c>isFinal</c> set, the %URI passed to uriAllocChunkParserStateMmA
+ * is filled from those offsets, with the same result as
+ * uriParseSingleUriExMmA would give for the whole input. As the %URI
+ * points into the text kept by the parser state, it must not outlive
+ * the parser state (unless made owner using uriMakeOwnerMmA).
+ *
+ * Errors are sticky: once a call failed, all further calls
+ * return the same error. For syntax errors, uriGetChunkParserErrorOffsetA
+ * gives the offset of the offending character from the start of input,
+ * the same as uriParseSingleUriExMmA reports for the whole input.
+ *
+ * @param state      <b>INOUT</b>: Parser state, must not be NULL
+ * @param first      <b>IN</b>: Pointer to the first character of the chunk,
+ *                              can only be NULL if <c>afterLast</c> is NULL
+ * @param afterLast  <b>IN</b>: Pointer to the character after the last
+ *                              of the chunk
+ * @param isFinal    <b>IN</b>: Whether this is the last chunk of input
+ * @return           0 on success, error code otherwise
+ *
+ * @see uriAllocChunkParserStateMmA
+ * @see uriFreeChunkParserStateA
+ * @see uriParseSingleUriExMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ParseChunk)(URI_TYPE(ChunkParserState) * state,
+        const URI_CHAR * first, const URI_CHAR * afterLast, UriBool isFinal);
+
+/**
+ * Returns the %URI that an incremental parser fills
+ * once the final chunk arrives.
+ *
+ * @param state  <b>IN</b>: Parser state, must not be NULL
+ * @return       %URI passed to uriAllocChunkParserStateMmA
+ *
+ * @see uriParseChunkA
+ * @since 1.1.0
+ */
+URI_PUBLIC URI_TYPE(Uri) * URI_FUNC(GetChunkParserUri)(
+        const URI_TYPE(ChunkParserState) * state);
+
+/**
+ * Returns the error that an incremental parser stopped at, if any.
+ *
+ * @param state  <b>IN</b>: Parser state, must not be NULL
+ * @return       Code of the error that occurred, 0 if none
+ *
+ * @see uriParseChunkA
+ * @see uriGetChunkParserErrorOffsetA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(GetChunkParserErrorCode)(
+        const URI_TYPE(ChunkParserState) * state);
+
+/**
+ * Returns the offset from the start of input where an incremental parser
+ * stopped, for syntax errors that of the offending character and for
+ * URI_ERROR_PARSECHUNK_TOO_LONG the maximum length.
+ *
+ * @param state  <b>IN</b>: Parser state, must not be NULL
+ * @return       Offset of the error, 0 if none
+ *
+ * @see uriParseChunkA
+ * @see uriGetChunkParserErrorCodeA
+ * @since 1.1.0
+ */
+URI_PUBLIC size_t URI_FUNC(GetChunkParserErrorOffset)(
+        const URI_TYPE(ChunkParserState) * state);
+
+/**
+ * Frees an incremental parser state and the text it holds.
+ * A %URI parsed using this state still needs freeing
+ * using uriFreeUriMembersMmA, and its text ranges are no longer
+ * usable afterwards, unless made owner using uriMakeOwnerMmA before.
+ *
+ * @param state  <b>INOUT</b>: Parser state to free, can be NULL
+ *
+ * @see uriAllocChunkParserStateMmA
+ * @see uriParseChunkA
+ * @since 1.1.0
+ */
+URI_PUBLIC void URI_FUNC(FreeChunkParserState)(URI_TYPE(ChunkParserState) * state);
+
+/**
+ * Initializes a reusable parser context, see UriParserContextA.
+ * <c>memory</c> is only called for allocations that cannot be served
+ * from allocations freed before.
+ * The context must be freed using uriFreeParserContextA when done.
+ *
+ * @param context  <b>OUT</b>: Parser context to initialize, must not be NULL
+ * @param memory   <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return         0 on success, error code otherwise
+ *
+ * @see uriParseSingleUriContextA
+ * @see uriFreeParserContextA
+ * @see uriInitRecyclingMemoryManager
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(InitParserContextMm)(
+        URI_TYPE(ParserContext) * context, UriMemoryManager * memory);
+
+/**
+ * Parses a single RFC 3986 %URI, like uriParseSingleUriExMmA does,
+ * but taking memory from a reusable parser context.
+ * The %URI must be freed using uriFreeUriMembersContextA
+ * with the same context, which keeps its memory for the next parse.
+ * Other functions taking a memory manager can be passed
+ * <c>&amp;context-&gt;memory</c> to work on the %URI.
+ *
+ * @param context     <b>INOUT</b>: Parser context, must not be NULL
+ * @param uri         <b>OUT</b>: Output %URI, must not be NULL
+ * @param first       <b>IN</b>: Pointer to the first character to parse,
+ *                               must not be NULL
+ * @param afterLast   <b>IN</b>: Pointer to the character after the last to
+ *                               parse, must not be NULL
+ * @param errorPos    <b>OUT</b>: Pointer to a pointer to the first character
+ *                                causing a syntax error, can be NULL;
+ *                                only set when URI_ERROR_SYNTAX was returned
+ * @return            0 on success, error code otherwise
+ *
+ * @see uriInitParserContextMmA
+ * @see uriFreeUriMembersContextA
+ * @see uriParseSingleUriExMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ParseSingleUriContext)(URI_TYPE(ParserContext) * context,
+        URI_TYPE(Uri) * uri, const URI_CHAR * first, const URI_CHAR * afterLast,
+        const URI_CHAR ** errorPos);
+
+/**
+ * Frees the members of a %URI parsed by uriParseSingleUriContextA,
+ * keeping path segments and host data for reuse by the next parse.
+ *
+ * @param context  <b>INOUT</b>: Parser context, must not be NULL
+ * @param uri      <b>INOUT</b>: %URI to free the members of
+ * @return         0 on success, error code otherwise
+ *
+ * @see uriParseSingleUriContextA
+ * @see uriFreeUriMembersMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(FreeUriMembersContext)(
+        URI_TYPE(ParserContext) * context, URI_TYPE(Uri) * uri);
+
+/**
+ * Returns all memory kept for reuse by a parser context
+ * to its memory manager. All URIs parsed using the context
+ * must have been freed before.
+ *
+ * @param context  <b>INOUT</b>: Parser context to free, can be NULL
+ *
+ * @see uriInitParserContextMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC void URI_FUNC(FreeParserContext)(URI_TYPE(ParserContext) * context);
+
+/**
+ * Converts a %URI to compact form, see UriCompactA.
+ * All text of the %URI is copied, so the compact %URI
+ * does not depend on the %URI or its text afterwards.
+ * A %URI parsed by uriParseSingleUriExLazyMmA is fine as well.
+ *
+ * @param compact  <b>OUT</b>: Output compact %URI, must not be NULL
+ * @param uri      <b>IN</b>: %URI to convert, must not be NULL
+ * @param memory   <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return         0 on success, error code otherwise
+ *
+ * @see uriCompactFromUriA
+ * @see uriUriFromCompactMmA
+ * @see uriFreeCompactMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(CompactFromUriMm)(URI_TYPE(Compact) ** compact,
+        const URI_TYPE(Uri) * uri, UriMemoryManager * memory);
+
+/**
+ * Converts a %URI to compact form, see UriCompactA,
+ * using the default memory manager.
+ *
+ * @param compact  <b>OUT</b>: Output compact %URI, must not be NULL
+ * @param uri      <b>IN</b>: %URI to convert, must not be NULL
+ * @return         0 on success, error code otherwise
+ *
+ * @see uriCompactFromUriMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(CompactFromUri)(
+        URI_TYPE(Compact) ** compact, const URI_TYPE(Uri) * uri);
+
+/**
+ * Converts a compact %URI back to a regular %URI.
+ * The %URI does not own its text but points into the text
+ * of the compact %URI, so the compact %URI must outlive the %URI;
+ * use uriMakeOwnerMmA to make them independent.
+ * All path segments are stored in a single block of memory,
+ * like uriParseSingleUriExFlatMmA does.
+ * The %URI must be freed with uriFreeUriMembersMmA.
+ *
+ * @param uri      <b>OUT</b>: Output %URI, must not be NULL
+ * @param compact  <b>IN</b>: Compact %URI to convert, must not be NULL
+ * @param memory   <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return         0 on success, error code otherwise
+ *
+ * @see uriUriFromCompactA
+ * @see uriCompactFromUriMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(UriFromCompactMm)(URI_TYPE(Uri) * uri,
+        const URI_TYPE(Compact) * compact, UriMemoryManager * memory);
+
+/**
+ * Converts a compact %URI back to a regular %URI,
+ * using the default memory manager.
+ *
+ * @param uri      <b>OUT</b>: Output %URI, must not be NULL
+ * @param compact  <b>IN</b>: Compact %URI to convert, must not be NULL
+ * @return         0 on success, error code otherwise
+ *
+ * @see uriUriFromCompactMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(UriFromCompact)(
+        URI_TYPE(Uri) * uri, const URI_TYPE(Compact) * compact);
+
+/**
+ * Frees a compact %URI made by uriCompactFromUriMmA.
+ *
+ * @param compact  <b>INOUT</b>: Compact %URI to free, can be NULL
+ * @param memory   <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return         0 on success, error code otherwise
+ *
+ * @see uriFreeCompactA
+ * @see uriCompactFromUriMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(FreeCompactMm)(
+        URI_TYPE(Compact) * compact, UriMemoryManager * memory);
+
+/**
+ * Frees a compact %URI made by uriCompactFromUriA.
+ *
+ * @param compact  <b>INOUT</b>: Compact %URI to free, can be NULL
+ *
+ * @see uriFreeCompactMmA
+ * @since 1.1.0
+ */
+URI_PUBLIC void URI_FUNC(FreeCompact)(URI_TYPE(Compact) * compact);
+
 /**
  * Frees all memory associated with the members
  * of the %URI structure. Note that the structure
@@ -387,6 +1208,7 @@ URI_PUBLIC int URI_FUNC(FreeUriMembersMm)(URI_TYPE(Uri) * uri, UriMemoryManager
  * the output buffer for <c>normalizeBreaks == URI_FALSE</c> and <b>6 times</b>
  * the space for <c>normalizeBreaks == URI_TRUE</c>
  * (since e.g. "\x0d" becomes "%0D%0A" in that case).
+ * Use uriEscapeCharsRequiredExA to learn the exact size instead.
  *
  * NOTE: The implementation treats (both <c>char</c> and) <c>wchar_t</c> units
  * as code point integers, which works well for code points <c>U+0001</c> to <c>U+00ff</c>
@@ -404,6 +1226,8 @@ URI_PUBLIC int URI_FUNC(FreeUriMembersMm)(URI_TYPE(Uri) * uri, UriMemoryManager
  * @return                  Position of terminator in output string
  *
  * @see uriEscapeA
+ * @see uriEscapeCharsRequiredExA
+ * @see uriEscapeMallocExA
  * @see uriUnescapeInPlaceExA
  * @since 0.5.2
  */
@@ -441,6 +1265,125 @@ URI_PUBLIC URI_CHAR * URI_FUNC(EscapeEx)(const URI_CHAR * inFirst,
 URI_PUBLIC URI_CHAR * URI_FUNC(Escape)(const URI_CHAR * in, URI_CHAR * out,
         UriBool spaceToPlus, UriBool normalizeBreaks);
 
+/**
+ * Calculates the exact number of characters that uriEscapeExA
+ * would write for the given input, excluding the terminator.
+ * Allows sizing the output buffer to fit rather than for the worst case.
+ *
+ * @param inFirst           <b>IN</b>: Pointer to first character of the input text
+ * @param inAfterLast       <b>IN</b>: Pointer after the last character of the input text,
+ * NULL for zero-terminated input
+ * @param spaceToPlus       <b>IN</b>: Whether to convert ' ' to '+' or not
+ * @param normalizeBreaks   <b>IN</b>: Whether to convert CR and LF to CR-LF or not.
+ * @param charsRequired     <b>OUT</b>: Length of the escaped text in characters
+ * <b>excluding</b> terminator
+ * @return                  Error code or 0 on success
+ *
+ * @see uriEscapeExA
+ * @see uriEscapeMallocExA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(EscapeCharsRequiredEx)(const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, UriBool spaceToPlus, UriBool normalizeBreaks,
+        int * charsRequired);
+
+/**
+ * Percent-encodes all but unreserved characters from the input string
+ * into a newly allocated string of exactly the size needed.
+ * On success, free the result using <c>free</c> later.
+ * Uses default libc-based memory manager.
+ *
+ * @param dest              <b>OUT</b>: Output destination
+ * @param inFirst           <b>IN</b>: Pointer to first character of the input text
+ * @param inAfterLast       <b>IN</b>: Pointer after the last character of the input text,
+ * NULL for zero-terminated input
+ * @param spaceToPlus       <b>IN</b>: Whether to convert ' ' to '+' or not
+ * @param normalizeBreaks   <b>IN</b>: Whether to convert CR and LF to CR-LF or not.
+ * @return                  Error code or 0 on success
+ *
+ * @see uriEscapeMallocExMmA
+ * @see uriEscapeCharsRequiredExA
+ * @see uriEscapeExA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(EscapeMallocEx)(URI_CHAR ** dest, const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, UriBool spaceToPlus, UriBool normalizeBreaks);
+
+/**
+ * Percent-encodes all but unreserved characters from the input string
+ * into a newly allocated string of exactly the size needed.
+ * On success, free the result using the same memory manager later.
+ *
+ * @param dest              <b>OUT</b>: Output destination
+ * @param inFirst           <b>IN</b>: Pointer to first character of the input text
+ * @param inAfterLast       <b>IN</b>: Pointer after the last character of the input text,
+ * NULL for zero-terminated input
+ * @param spaceToPlus       <b>IN</b>: Whether to convert ' ' to '+' or not
+ * @param normalizeBreaks   <b>IN</b>: Whether to convert CR and LF to CR-LF or not.
+ * @param memory            <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return                  Error code or 0 on success
+ *
+ * @see uriEscapeMallocExA
+ * @see uriEscapeCharsRequiredExA
+ * @see uriEscapeExA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(EscapeMallocExMm)(URI_CHAR ** dest, const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, UriBool spaceToPlus, UriBool normalizeBreaks,
+        UriMemoryManager * memory);
+
+/**
+ * Percent-encodes the input string for use as the given %URI component
+ * and writes the encoded version to the output string.
+ * Unlike uriEscapeExA, characters that the parser accepts literally
+ * in that component (e.g. "/" in a path) are kept, so that the result
+ * is the shortest valid encoding. "%" is always encoded, and so is "+"
+ * with <c>spaceToPlus</c> so that it cannot be mistaken for a space.
+ *
+ * NOTE: The same buffer size requirements as with uriEscapeExA apply,
+ * use uriEscapeComponentCharsRequiredExA to learn the exact size instead.
+ *
+ * NOTE: With <c>URI_ESCAPE_SEGMENT</c> and <c>URI_ESCAPE_PATH</c>, ":" is kept;
+ * the first segment of a relative reference without scheme must not contain ":".
+ *
+ * @param inFirst           <b>IN</b>: Pointer to first character of the input text
+ * @param inAfterLast       <b>IN</b>: Pointer after the last character of the input text
+ * @param out               <b>OUT</b>: Encoded text destination
+ * @param component         <b>IN</b>: Component to escape for
+ * @param spaceToPlus       <b>IN</b>: Whether to convert ' ' to '+' or not
+ * @param normalizeBreaks   <b>IN</b>: Whether to convert CR and LF to CR-LF or not.
+ * @return                  Position of terminator in output string
+ *
+ * @see uriEscapeExA
+ * @see uriEscapeComponentCharsRequiredExA
+ * @since 1.1.0
+ */
+URI_PUBLIC URI_CHAR * URI_FUNC(EscapeComponentEx)(const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, URI_CHAR * out, UriEscapeComponent component,
+        UriBool spaceToPlus, UriBool normalizeBreaks);
+
+/**
+ * Calculates the exact number of characters that uriEscapeComponentExA
+ * would write for the given input, excluding the terminator.
+ *
+ * @param inFirst           <b>IN</b>: Pointer to first character of the input text
+ * @param inAfterLast       <b>IN</b>: Pointer after the last character of the input text,
+ * NULL for zero-terminated input
+ * @param component         <b>IN</b>: Component to escape for
+ * @param spaceToPlus       <b>IN</b>: Whether to convert ' ' to '+' or not
+ * @param normalizeBreaks   <b>IN</b>: Whether to convert CR and LF to CR-LF or not.
+ * @param charsRequired     <b>OUT</b>: Length of the escaped text in characters
+ * <b>excluding</b> terminator
+ * @return                  Error code or 0 on success
+ *
+ * @see uriEscapeComponentExA
+ * @see uriEscapeCharsRequiredExA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(EscapeComponentCharsRequiredEx)(const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, UriEscapeComponent component, UriBool spaceToPlus,
+        UriBool normalizeBreaks, int * charsRequired);
+
 /**
  * Unescapes percent-encoded groups in a given string.
  * E.g. "%20" will become " ". Unescaping is done in place.
@@ -481,6 +1424,77 @@ URI_PUBLIC const URI_CHAR * URI_FUNC(UnescapeInPlaceEx)(
  */
 URI_PUBLIC const URI_CHAR * URI_FUNC(UnescapeInPlace)(URI_CHAR * inout);
 
+/**
+ * Unescapes percent-encoded groups in the given text range
+ * and writes the decoded text to a separate output buffer,
+ * e.g. to decode a component of a parsed %URI without copying it first.
+ * Decoding is the same as with uriUnescapeInPlaceExA; it stops
+ * early at a zero character.
+ *
+ * NOTE: Be sure to allocate space for as many characters as the input has,
+ * plus one for the terminator; decoding never makes text longer.
+ * <c>out</c> may be equal to <c>inFirst</c> but must not overlap otherwise.
+ *
+ * @param inFirst           <b>IN</b>: Pointer to first character of the input text
+ * @param inAfterLast       <b>IN</b>: Pointer after the last character of the input text,
+ * NULL for zero-terminated input
+ * @param out               <b>OUT</b>: Decoded text destination
+ * @param plusToSpace       <b>IN</b>: Whether to convert '+' to ' ' or not
+ * @param breakConversion   <b>IN</b>: Line break conversion mode
+ * @return                  Position of terminator in output string,
+ * NULL if <c>out</c> is NULL
+ *
+ * @see uriUnescapeInPlaceExA
+ * @see uriUnescapeChunkExA
+ * @since 1.1.0
+ */
+URI_PUBLIC URI_CHAR * URI_FUNC(UnescapeEx)(const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, URI_CHAR * out, UriBool plusToSpace,
+        UriBreakConversion breakConversion);
+
+/**
+ * Initializes the state for decoding percent-encoded text in chunks.
+ *
+ * @param state   <b>OUT</b>: State to initialize
+ *
+ * @see uriUnescapeChunkExA
+ * @since 1.1.0
+ */
+URI_PUBLIC void URI_FUNC(InitUnescapeState)(URI_TYPE(UnescapeState) * state);
+
+/**
+ * Unescapes percent-encoded groups in the next chunk of a text that
+ * arrives in pieces, writing the decoded text to a separate output buffer.
+ * A percent group that is cut off at the end of the chunk is held back
+ * in <c>state</c> and decoded once the next chunk completes it, so that
+ * the concatenated output equals what uriUnescapeExA would produce
+ * for the concatenated input.
+ * With <c>isFinal</c> set, held back characters are flushed unmodified
+ * and <c>state</c> is reset for reuse.
+ *
+ * NOTE: Be sure to allocate space for as many characters as the chunk has,
+ * plus three (for up to two held back characters and the terminator).
+ * <c>out</c> must not overlap the chunk.
+ *
+ * @param state             <b>INOUT</b>: Decoding state, see uriInitUnescapeStateA
+ * @param inFirst           <b>IN</b>: Pointer to the first character of the chunk,
+ * can only be NULL if <c>inAfterLast</c> is NULL
+ * @param inAfterLast       <b>IN</b>: Pointer after the last character of the chunk
+ * @param out               <b>OUT</b>: Decoded text destination
+ * @param plusToSpace       <b>IN</b>: Whether to convert '+' to ' ' or not
+ * @param breakConversion   <b>IN</b>: Line break conversion mode
+ * @param isFinal           <b>IN</b>: Whether this is the last chunk of input
+ * @return                  Position of terminator in output string,
+ * NULL for invalid arguments
+ *
+ * @see uriInitUnescapeStateA
+ * @see uriUnescapeExA
+ * @since 1.1.0
+ */
+URI_PUBLIC URI_CHAR * URI_FUNC(UnescapeChunkEx)(URI_TYPE(UnescapeState) * state,
+        const URI_CHAR * inFirst, const URI_CHAR * inAfterLast, URI_CHAR * out,
+        UriBool plusToSpace, UriBreakConversion breakConversion, UriBool isFinal);
+
 /**
  * Performs reference resolution as described in
  * <a href="https://datatracker.ietf.org/doc/html/rfc3986#section-5.2.2">section 5.2.2 of
@@ -650,6 +1664,48 @@ URI_PUBLIC int URI_FUNC(ToStringCharsRequired)(
 URI_PUBLIC int URI_FUNC(ToString)(
         URI_CHAR * dest, const URI_TYPE(Uri) * uri, int maxChars, int * charsWritten);
 
+/**
+ * Calculates the number of characters needed to store the
+ * string representation of the given IRI as a %URI, excluding the
+ * terminator.
+ *
+ * @param uri             <b>IN</b>: IRI to measure
+ * @param charsRequired   <b>OUT</b>: Length of the string representation in characters
+ * <b>excluding</b> terminator
+ * @return                Error code or 0 on success
+ *
+ * @see uriToStringAsUriA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ToStringAsUriCharsRequired)(
+        const URI_TYPE(Uri) * uri, int * charsRequired);
+
+/**
+ * Converts an IRI (see URI_PARSE_IRI) back to text like uriToStringA does,
+ * mapping it to a %URI as described in
+ * <a href="https://datatracker.ietf.org/doc/html/rfc3987#section-3.1">section 3.1 of
+ * RFC 3987</a> on the way: all non-ASCII characters are percent-encoded
+ * as UTF-8, in uppercase.
+ * With <c>char</c>, input is expected to be UTF-8 already,
+ * with <c>wchar_t</c>, UTF-16 or UTF-32.
+ * The text is recomposed directly into <c>dest</c>, without
+ * an intermediate copy.
+ *
+ * @param dest           <b>OUT</b>: Output destination
+ * @param uri            <b>IN</b>: IRI to convert
+ * @param maxChars       <b>IN</b>: Maximum number of characters to copy <b>including</b>
+ * terminator
+ * @param charsWritten   <b>OUT</b>: Number of characters written, can be lower than
+ * maxChars even if the %URI is too long!
+ * @return               Error code or 0 on success
+ *
+ * @see uriToStringAsUriCharsRequiredA
+ * @see uriToStringA
+ * @since 1.1.0
+ */
+URI_PUBLIC int URI_FUNC(ToStringAsUri)(
+        URI_CHAR * dest, const URI_TYPE(Uri) * uri, int maxChars, int * charsWritten);
+
 /**
  * Copies a %URI structure.
  *
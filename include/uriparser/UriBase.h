@@ -151,11 +151,22 @@ typedef int UriBool; /**< Boolean type */
 #  define URI_ERROR_SETHOST_PORT_SET \
       15 /* [>=0.9.9] The %URI given does have a port set */
 
+/* Errors specific to uriParseChunk */
+#  define URI_ERROR_PARSECHUNK_TOO_LONG \
+      16 /* [>=1.1.0] The input exceeds the maximum length given */
+#  define URI_ERROR_PARSECHUNK_FINISHED \
+      17 /* [>=1.1.0] The final chunk has been parsed already */
+
+/* Errors specific to uriCompactFromUri */
+#  define URI_ERROR_COMPACT_TOO_LONG \
+      18 /* [>=1.1.0] The %URI text exceeds the 32-bit offsets of UriCompact */
+
 #  ifndef URI_DOXYGEN
 #    include <stdio.h> /* For NULL, snprintf */
 #    include <ctype.h> /* For wchar_t */
 #    include <string.h> /* For strlen, memset, memcpy */
 #    include <stdlib.h> /* For malloc */
+#    include <stdint.h> /* For uint32_t */
 #  endif /* URI_DOXYGEN */
 
 /**
@@ -231,6 +242,53 @@ typedef struct UriMemoryManagerStruct {
                       */
 } UriMemoryManager; /**< @copydoc UriMemoryManagerStruct */
 
+/**
+ * Bookkeeping of an arena memory manager, see uriInitArenaMemoryManager.
+ * All members are internal and should not be accessed directly.
+ *
+ * @see uriInitArenaMemoryManager
+ * @see uriResetMemoryArena
+ * @see uriFreeMemoryArena
+ * @since 1.1.0
+ */
+typedef struct UriMemoryArenaStruct {
+    UriMemoryManager * backend; /**< Memory manager to grow by, NULL for no growth */
+    size_t chunkSize; /**< Minimum size in bytes of chunks taken from the backend */
+    char * buffer; /**< Caller-supplied initial buffer or NULL */
+    size_t bufferSize; /**< Size in bytes of the caller-supplied buffer */
+    void * chunks; /**< Chunks taken from the backend, most recent first */
+    char * cursor; /**< Next unused byte of the current buffer or chunk */
+    char * afterLast; /**< End of the current buffer or chunk */
+} UriMemoryArena; /**< @copydoc UriMemoryArenaStruct */
+
+/**
+ * Number of path segments that UriUriInlineA has room for.
+ *
+ * @since 1.1.0
+ */
+#  define URI_INLINE_SEGMENT_COUNT 4
+
+/**
+ * Number of size classes that a recycling memory manager keeps
+ * freed allocations of, see uriInitRecyclingMemoryManager.
+ *
+ * @since 1.1.0
+ */
+#  define URI_RECYCLER_CLASS_COUNT 4
+
+/**
+ * Bookkeeping of a recycling memory manager, see uriInitRecyclingMemoryManager.
+ * All members are internal and should not be accessed directly.
+ *
+ * @see uriInitRecyclingMemoryManager
+ * @see uriFreeMemoryRecycler
+ * @since 1.1.0
+ */
+typedef struct UriMemoryRecyclerStruct {
+    UriMemoryManager * backend; /**< Memory manager to take new allocations from */
+    void * freeLists[URI_RECYCLER_CLASS_COUNT]; /**< Freed allocations by size class */
+} UriMemoryRecycler; /**< @copydoc UriMemoryRecyclerStruct */
+
 /**
  * Specifies a line break conversion mode.
  */
@@ -245,6 +303,23 @@ typedef enum UriBreakConversionEnum {
     URI_BR_DONT_TOUCH /**< Copy line breaks unmodified */
 } UriBreakConversion; /**< @copydoc UriBreakConversionEnum */
 
+/**
+ * Specifies the %URI component that text is escaped for.
+ * Characters the parser accepts literally in that component
+ * are left unescaped, all others are percent-encoded.
+ *
+ * @see uriEscapeComponentExA
+ * @since 1.1.0
+ */
+typedef enum UriEscapeComponentEnum {
+    URI_ESCAPE_UNRESERVED = 0, /**< Keep unreserved characters only, like uriEscapeExA */
+    URI_ESCAPE_USERINFO, /**< Keep characters of user info, e.g. ":" */
+    URI_ESCAPE_SEGMENT, /**< Keep characters of a single path segment, e.g. "@" */
+    URI_ESCAPE_PATH, /**< Keep characters of a path, i.e. segments and "/" */
+    URI_ESCAPE_QUERY_VALUE, /**< Keep characters of a query except "&", "+" and "=" */
+    URI_ESCAPE_FRAGMENT /**< Keep characters of a fragment, e.g. "/" and "?" */
+} UriEscapeComponent; /**< @copydoc UriEscapeComponentEnum */
+
 /**
  * Specifies which component of a %URI has to be normalized.
  */
@@ -272,6 +347,44 @@ typedef enum UriResolutionOptionsEnum {
             1 << 0 /**< Treat %URI to resolve with identical scheme as having no scheme */
 } UriResolutionOptions; /**< @copydoc UriResolutionOptionsEnum */
 
+/**
+ * Specifies which optional work to skip when parsing a %URI.
+ *
+ * @see uriParseSingleUriOptionsMmA
+ * @since 1.1.0
+ */
+typedef enum UriParseOptionsEnum {
+    URI_PARSE_DEFAULT = 0, /**< Parse everything, like uriParseSingleUriExMmA */
+    URI_PARSE_SKIP_HOST_DATA =
+            1 << 0, /**< Leave <c>hostData</c> unset; host syntax is still checked */
+    URI_PARSE_RAW_PATH_ONLY = 1 << 1, /**< Keep the raw path unsplit, like
+                                         uriParseSingleUriExLazyMmA */
+    URI_PARSE_STOP_AFTER_AUTHORITY =
+            1 << 2, /**< Leave path, query and fragment unset and unchecked */
+    URI_PARSE_KEEP_PARTIAL = 1 << 3, /**< Keep components parsed before a syntax error */
+    URI_PARSE_IRI = 1 << 4 /**< Accept the non-ASCII characters of RFC 3987 IRIs */
+} UriParseOptions; /**< @copydoc UriParseOptionsEnum */
+
+/**
+ * Specifies which components of a compact %URI are present,
+ * and what kind of host it has.
+ *
+ * @see UriCompactStructA
+ * @since 1.1.0
+ */
+typedef enum UriCompactFlagsEnum {
+    URI_COMPACT_HAS_SCHEME = 1 << 0, /**< Scheme is present */
+    URI_COMPACT_HAS_USER_INFO = 1 << 1, /**< User info is present */
+    URI_COMPACT_HAS_HOST = 1 << 2, /**< Host is present */
+    URI_COMPACT_HAS_PORT = 1 << 3, /**< Port is present */
+    URI_COMPACT_HAS_QUERY = 1 << 4, /**< Query is present */
+    URI_COMPACT_HAS_FRAGMENT = 1 << 5, /**< Fragment is present */
+    URI_COMPACT_ABSOLUTE_PATH = 1 << 6, /**< Path is absolute, see UriUriStructA */
+    URI_COMPACT_HOST_IP4 = 1 << 7, /**< Host is an IPv4 address in <c>ipData[0..3]</c> */
+    URI_COMPACT_HOST_IP6 = 1 << 8, /**< Host is an IPv6 address in <c>ipData</c> */
+    URI_COMPACT_HOST_IPFUTURE = 1 << 9 /**< Host is an IPvFuture address */
+} UriCompactFlags; /**< @copydoc UriCompactFlagsEnum */
+
 /**
  * Wraps a memory manager backend that only provides <c>malloc(3)</c> and
  * <c>free(3)</c> to make a complete memory manager ready to be used.
@@ -399,4 +512,116 @@ URI_PUBLIC int uriTestMemoryManager(UriMemoryManager * memory);
 URI_PUBLIC int uriTestMemoryManagerEx(
         UriMemoryManager * memory, UriBool challengeAlignment);
 
+/**
+ * Initializes a bump-pointer arena memory manager.
+ * Allocations are carved from <c>buffer</c> first and, once that is used up,
+ * from chunks of at least <c>chunkSize</c> bytes taken from <c>backend</c>.
+ * Allocation is constant-time, <c>memory-&gt;free</c> does nothing,
+ * and all memory is reclaimed at once using <c>uriResetMemoryArena</c>.
+ * That makes the arena a good fit for parsing many URIs in a row,
+ * resetting the arena in between.
+ *
+ * Each allocation takes a small size header plus padding for alignment,
+ * so <c>buffer</c> should be somewhat larger than the sum of allocations
+ * it is meant to hold.
+ *
+ * Members of <c>arena</c> are considered internal. The arena must
+ * outlive <c>memory</c>, and <c>uriFreeMemoryArena</c> must be called
+ * to return any chunks to <c>backend</c> when done.
+ *
+ * @param memory      <b>OUT</b>: Where to write the arena memory manager to
+ * @param arena       <b>OUT</b>: Arena bookkeeping to initialize
+ * @param buffer      <b>IN</b>: Initial buffer to allocate from,
+ *                    may only be NULL with non-zero <c>chunkSize</c>
+ * @param bufferSize  <b>IN</b>: Size of <c>buffer</c> in bytes
+ * @param chunkSize   <b>IN</b>: Minimum size of chunks in bytes to grow by,
+ *                    0 to never grow beyond <c>buffer</c>
+ * @param backend     <b>IN</b>: Memory manager to take chunks from,
+ *                    NULL for the default memory manager
+ * @return            Error code or 0 on success
+ *
+ * @see UriMemoryArena
+ * @see uriResetMemoryArena
+ * @see uriFreeMemoryArena
+ * @see UriMemoryManager
+ * @since 1.1.0
+ */
+URI_PUBLIC int uriInitArenaMemoryManager(UriMemoryManager * memory,
+        UriMemoryArena * arena, void * buffer, size_t bufferSize, size_t chunkSize,
+        UriMemoryManager * backend);
+
+/**
+ * Reclaims all memory allocated from an arena at once.
+ * Pointers obtained from the arena memory manager before
+ * must no longer be used afterwards.
+ * With a caller-supplied buffer, all chunks are returned to the backend
+ * and allocation restarts at the beginning of that buffer.
+ * Without one, the most recent chunk is kept for reuse.
+ *
+ * @param arena  <b>INOUT</b>: Arena to reset
+ * @return       Error code or 0 on success
+ *
+ * @see uriInitArenaMemoryManager
+ * @see uriFreeMemoryArena
+ * @since 1.1.0
+ */
+URI_PUBLIC int uriResetMemoryArena(UriMemoryArena * arena);
+
+/**
+ * Returns all chunks of an arena to its backend.
+ * The caller-supplied buffer, if any, is left alone.
+ * Neither the arena nor its memory manager may be used afterwards.
+ *
+ * @param arena  <b>INOUT</b>: Arena to free
+ *
+ * @see uriInitArenaMemoryManager
+ * @see uriResetMemoryArena
+ * @since 1.1.0
+ */
+URI_PUBLIC void uriFreeMemoryArena(UriMemoryArena * arena);
+
+/**
+ * Initializes a recycling memory manager.
+ * Small allocations, like path segments and IP host data, are not
+ * returned to <c>backend</c> when freed but kept on a free list
+ * for their size class, and handed out again by later allocations
+ * of the same size class. Larger allocations are passed through.
+ * That makes parsing and freeing many URIs in a row take hardly
+ * any calls to <c>backend</c> once warmed up, see UriParserContextA.
+ *
+ * Each allocation takes a small size header plus padding for alignment.
+ * Memory kept for reuse grows to the peak number of small allocations
+ * alive at the same time, and is only returned to <c>backend</c>
+ * by <c>uriFreeMemoryRecycler</c>.
+ *
+ * Members of <c>recycler</c> are considered internal. The recycler must
+ * outlive <c>memory</c>, and <c>uriFreeMemoryRecycler</c> must be called
+ * to return all memory to <c>backend</c> when done.
+ *
+ * @param memory    <b>OUT</b>: Where to write the recycling memory manager to
+ * @param recycler  <b>OUT</b>: Recycler bookkeeping to initialize
+ * @param backend   <b>IN</b>: Memory manager to take allocations from,
+ *                  NULL for the default memory manager
+ * @return          Error code or 0 on success
+ *
+ * @see UriMemoryRecycler
+ * @see uriFreeMemoryRecycler
+ * @see UriMemoryManager
+ * @since 1.1.0
+ */
+URI_PUBLIC int uriInitRecyclingMemoryManager(UriMemoryManager * memory,
+        UriMemoryRecycler * recycler, UriMemoryManager * backend);
+
+/**
+ * Returns all memory kept for reuse by a recycler to its backend.
+ * Allocations still alive must be freed before.
+ * Neither the recycler nor its memory manager may be used afterwards.
+ *
+ * @param recycler  <b>INOUT</b>: Recycler to free, can be NULL
+ *
+ * @see uriInitRecyclingMemoryManager
+ * @since 1.1.0
+ */
+URI_PUBLIC void uriFreeMemoryRecycler(UriMemoryRecycler * recycler);
+
 #endif /* URI_BASE_H */
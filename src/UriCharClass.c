@@ -0,0 +1,237 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef URI_DOXYGEN
+#  include "UriCharClass.h"
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#  define URI_HAVE_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+/* Characters sharing the same set of classes */
+#define URI_CC_UNRES \
+    (URI_CLASS_UNRESERVED | URI_CLASS_PCHAR | URI_CLASS_QUERY_FRAG \
+     | URI_CLASS_USERINFO | URI_CLASS_PATH | URI_CLASS_QUERY_VALUE)
+#define URI_CC_DIGIT \
+    (URI_CC_UNRES | URI_CLASS_DIGIT | URI_CLASS_HEXDIG | URI_CLASS_SCHEME)
+#define URI_CC_HEX_LETTER \
+    (URI_CC_UNRES | URI_CLASS_ALPHA | URI_CLASS_HEXDIG | URI_CLASS_SCHEME)
+#define URI_CC_ALPHA (URI_CC_UNRES | URI_CLASS_ALPHA | URI_CLASS_SCHEME)
+#define URI_CC_SUB_DELIM \
+    (URI_CLASS_SUB_DELIMS | URI_CLASS_PCHAR | URI_CLASS_QUERY_FRAG \
+     | URI_CLASS_USERINFO | URI_CLASS_PATH)
+#define URI_CC_SUB_DELIM_VALUE (URI_CC_SUB_DELIM | URI_CLASS_QUERY_VALUE)
+
+/* clang-format off */
+const unsigned short uriCharClassTable[256] = {
+    /* unreserved = ALPHA / DIGIT / "-" / "." / "_" / "~" */
+    ['0'] = URI_CC_DIGIT, ['1'] = URI_CC_DIGIT, ['2'] = URI_CC_DIGIT,
+    ['3'] = URI_CC_DIGIT, ['4'] = URI_CC_DIGIT, ['5'] = URI_CC_DIGIT,
+    ['6'] = URI_CC_DIGIT, ['7'] = URI_CC_DIGIT, ['8'] = URI_CC_DIGIT,
+    ['9'] = URI_CC_DIGIT,
+
+    ['a'] = URI_CC_HEX_LETTER, ['b'] = URI_CC_HEX_LETTER, ['c'] = URI_CC_HEX_LETTER,
+    ['d'] = URI_CC_HEX_LETTER, ['e'] = URI_CC_HEX_LETTER, ['f'] = URI_CC_HEX_LETTER,
+    ['g'] = URI_CC_ALPHA, ['h'] = URI_CC_ALPHA, ['i'] = URI_CC_ALPHA,
+    ['j'] = URI_CC_ALPHA, ['k'] = URI_CC_ALPHA, ['l'] = URI_CC_ALPHA,
+    ['m'] = URI_CC_ALPHA, ['n'] = URI_CC_ALPHA, ['o'] = URI_CC_ALPHA,
+    ['p'] = URI_CC_ALPHA, ['q'] = URI_CC_ALPHA, ['r'] = URI_CC_ALPHA,
+    ['s'] = URI_CC_ALPHA, ['t'] = URI_CC_ALPHA, ['u'] = URI_CC_ALPHA,
+    ['v'] = URI_CC_ALPHA, ['w'] = URI_CC_ALPHA, ['x'] = URI_CC_ALPHA,
+    ['y'] = URI_CC_ALPHA, ['z'] = URI_CC_ALPHA,
+
+    ['A'] = URI_CC_HEX_LETTER, ['B'] = URI_CC_HEX_LETTER, ['C'] = URI_CC_HEX_LETTER,
+    ['D'] = URI_CC_HEX_LETTER, ['E'] = URI_CC_HEX_LETTER, ['F'] = URI_CC_HEX_LETTER,
+    ['G'] = URI_CC_ALPHA, ['H'] = URI_CC_ALPHA, ['I'] = URI_CC_ALPHA,
+    ['J'] = URI_CC_ALPHA, ['K'] = URI_CC_ALPHA, ['L'] = URI_CC_ALPHA,
+    ['M'] = URI_CC_ALPHA, ['N'] = URI_CC_ALPHA, ['O'] = URI_CC_ALPHA,
+    ['P'] = URI_CC_ALPHA, ['Q'] = URI_CC_ALPHA, ['R'] = URI_CC_ALPHA,
+    ['S'] = URI_CC_ALPHA, ['T'] = URI_CC_ALPHA, ['U'] = URI_CC_ALPHA,
+    ['V'] = URI_CC_ALPHA, ['W'] = URI_CC_ALPHA, ['X'] = URI_CC_ALPHA,
+    ['Y'] = URI_CC_ALPHA, ['Z'] = URI_CC_ALPHA,
+
+    ['-'] = URI_CC_UNRES | URI_CLASS_SCHEME,
+    ['.'] = URI_CC_UNRES | URI_CLASS_SCHEME,
+    ['_'] = URI_CC_UNRES,
+    ['~'] = URI_CC_UNRES,
+
+    /* sub-delims = "!" / "$" / "&" / "'" / "(" / ")"
+     *            / "*" / "+" / "," / ";" / "="
+     * NOTE: "&", "+" and "=" delimit query items, see UriQuery.c */
+    ['!'] = URI_CC_SUB_DELIM_VALUE, ['$'] = URI_CC_SUB_DELIM_VALUE,
+    ['&'] = URI_CC_SUB_DELIM, ['\''] = URI_CC_SUB_DELIM_VALUE,
+    ['('] = URI_CC_SUB_DELIM_VALUE, [')'] = URI_CC_SUB_DELIM_VALUE,
+    ['*'] = URI_CC_SUB_DELIM_VALUE, ['+'] = URI_CC_SUB_DELIM | URI_CLASS_SCHEME,
+    [','] = URI_CC_SUB_DELIM_VALUE, [';'] = URI_CC_SUB_DELIM_VALUE,
+    ['='] = URI_CC_SUB_DELIM,
+
+    /* pchar = unreserved / pct-encoded / sub-delims / ":" / "@" */
+    [':'] = URI_CLASS_PCHAR | URI_CLASS_QUERY_FRAG | URI_CLASS_USERINFO
+            | URI_CLASS_PATH | URI_CLASS_QUERY_VALUE,
+    ['@'] = URI_CLASS_PCHAR | URI_CLASS_QUERY_FRAG | URI_CLASS_PATH
+            | URI_CLASS_QUERY_VALUE,
+
+    /* query = *( pchar / "/" / "?" ) */
+    ['/'] = URI_CLASS_QUERY_FRAG | URI_CLASS_PATH | URI_CLASS_QUERY_VALUE,
+    ['?'] = URI_CLASS_QUERY_FRAG | URI_CLASS_QUERY_VALUE,
+};
+/* clang-format on */
+
+/* clang-format off */
+const unsigned char uriHexdigValueTable[256] = {
+    ['0'] = 0, ['1'] = 1, ['2'] = 2, ['3'] = 3, ['4'] = 4,
+    ['5'] = 5, ['6'] = 6, ['7'] = 7, ['8'] = 8, ['9'] = 9,
+    ['a'] = 10, ['b'] = 11, ['c'] = 12, ['d'] = 13, ['e'] = 14, ['f'] = 15,
+    ['A'] = 10, ['B'] = 11, ['C'] = 12, ['D'] = 13, ['E'] = 14, ['F'] = 15,
+};
+/* clang-format on */
+
+#ifdef URI_HAVE_SSE2
+/* Returns a mask of the bytes in block that are not of class query/fragment,
+ * or of class pchar if withSlashAndQuestionMark is zero */
+static __m128i uriFindNonQueryFragBytes(__m128i block, int withSlashAndQuestionMark) {
+    /* Everything outside of printable US-ASCII 0x21 to 0x7E
+     * NOTE: Bytes 0x80 and up are negative with signed comparison. */
+    __m128i bad = _mm_or_si128(_mm_cmplt_epi8(block, _mm_set1_epi8(0x21)),
+            _mm_cmpgt_epi8(block, _mm_set1_epi8(0x7E)));
+
+    /* Printable US-ASCII not of class query/fragment */
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('"')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('#')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('%')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('<')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('>')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('[')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8(']')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('^')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('`')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('{')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('|')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('}')));
+
+    if (!withSlashAndQuestionMark) {
+        bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('/')));
+        bad = _mm_or_si128(bad, _mm_cmpeq_epi8(block, _mm_set1_epi8('?')));
+    }
+
+    return bad;
+}
+#endif
+
+#ifdef URI_HAVE_SSE2
+/* Returns a mask of the bytes in block that are within [lo, hi]
+ * NOTE: Bytes 0x80 and up are negative with signed comparison,
+ *       and hence never within a range of US-ASCII. */
+static __m128i uriFindBytesInRange(__m128i block, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8((char)(lo - 1))),
+            _mm_cmplt_epi8(block, _mm_set1_epi8((char)(hi + 1))));
+}
+
+/* Returns a mask of the bytes in block that are of class unreserved */
+static __m128i uriFindUnreservedBytes(__m128i block) {
+    /* unreserved = ALPHA / DIGIT / "-" / "." / "_" / "~" */
+    __m128i good = uriFindBytesInRange(block, 'a', 'z');
+    good = _mm_or_si128(good, uriFindBytesInRange(block, 'A', 'Z'));
+    /* "-", ".", DIGIT and the "/" in between */
+    good = _mm_or_si128(good, uriFindBytesInRange(block, '-', '9'));
+    good = _mm_andnot_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('/')), good);
+    good = _mm_or_si128(good, _mm_cmpeq_epi8(block, _mm_set1_epi8('_')));
+    good = _mm_or_si128(good, _mm_cmpeq_epi8(block, _mm_set1_epi8('~')));
+    return good;
+}
+#endif
+
+const char * uriSkipCharClassBlocks(
+        const char * first, const char * afterLast, unsigned int mask) {
+#ifdef URI_HAVE_SSE2
+    const int withSlashAndQuestionMark = (mask == URI_CLASS_QUERY_FRAG);
+
+    if (mask == URI_CLASS_UNRESERVED) {
+        while (afterLast - first >= 16) {
+            const __m128i block = _mm_loadu_si128((const __m128i *)first);
+            if (_mm_movemask_epi8(uriFindUnreservedBytes(block)) != 0xFFFF) {
+                break;
+            }
+            first += 16;
+        }
+        return first;
+    }
+
+    if ((mask != URI_CLASS_QUERY_FRAG) && (mask != URI_CLASS_PCHAR)) {
+        return first;
+    }
+
+    while (afterLast - first >= 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i *)first);
+        const __m128i bad = uriFindNonQueryFragBytes(block, withSlashAndQuestionMark);
+        if (_mm_movemask_epi8(bad) != 0) {
+            break;
+        }
+        first += 16;
+    }
+#else
+    (void)afterLast;
+    (void)mask;
+#endif
+    return first;
+}
+
+const char * uriSkipUnescapedBlocks(
+        const char * first, const char * afterLast, int withPlus) {
+#ifdef URI_HAVE_SSE2
+    const __m128i percent = _mm_set1_epi8('%');
+    const __m128i plus = _mm_set1_epi8(withPlus ? '+' : '%');
+
+    while (afterLast - first >= 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i *)first);
+        const __m128i found = _mm_or_si128(
+                _mm_cmpeq_epi8(block, percent), _mm_cmpeq_epi8(block, plus));
+        if (_mm_movemask_epi8(found) != 0) {
+            break;
+        }
+        first += 16;
+    }
+#else
+    (void)afterLast;
+    (void)withPlus;
+#endif
+    return first;
+}
@@ -0,0 +1,95 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriCharClass.h
+ * Holds the table-based character classification shared by the parser,
+ * the IsWellFormed* validators, and escaping.
+ * NOTE: This header does not need to be included twice.
+ */
+
+#ifndef URI_CHAR_CLASS_H
+#  define URI_CHAR_CLASS_H 1
+
+/* Character classes, one bit each, see RFC 3986 appendix A.
+ * NOTE: None of the classes include "%", callers need to deal
+ *       with pct-encoded themselves. */
+#  define URI_CLASS_DIGIT 0x0001 /* DIGIT */
+#  define URI_CLASS_ALPHA 0x0002 /* ALPHA */
+#  define URI_CLASS_HEXDIG 0x0004 /* HEXDIG */
+#  define URI_CLASS_UNRESERVED 0x0008 /* unreserved */
+#  define URI_CLASS_SUB_DELIMS 0x0010 /* sub-delims */
+#  define URI_CLASS_PCHAR 0x0020 /* pchar without pct-encoded */
+#  define URI_CLASS_QUERY_FRAG 0x0040 /* query/fragment without pct-encoded */
+#  define URI_CLASS_SCHEME 0x0080 /* ALPHA / DIGIT / "+" / "-" / "." */
+#  define URI_CLASS_USERINFO 0x0100 /* userinfo without pct-encoded */
+#  define URI_CLASS_PATH 0x0200 /* pchar without pct-encoded, or "/" */
+#  define URI_CLASS_QUERY_VALUE 0x0400 /* query/fragment except "&", "+", "=" */
+
+extern const unsigned short uriCharClassTable[256];
+
+/* Values of HEXDIG characters, zero for all other characters */
+extern const unsigned char uriHexdigValueTable[256];
+
+/* Looks up the class bits of a character of either width.
+ * Code points above 0xFF (i.e. with wchar_t) are in no class at all.
+ * NOTE: Argument c is evaluated more than once. */
+#  define URI_CHAR_CLASS(c) \
+      (((sizeof(c) == 1) || ((unsigned long)(c) <= 0xFF)) \
+                      ? uriCharClassTable[(unsigned char)(c)] \
+                      : 0)
+
+/* Is character c in any of the classes in mask? */
+#  define URI_CHAR_IS(c, mask) ((URI_CHAR_CLASS(c) & (mask)) != 0)
+
+/* Skips whole blocks of characters that are all of class mask, using SIMD
+ * where available. Only classes URI_CLASS_PCHAR, URI_CLASS_QUERY_FRAG and
+ * URI_CLASS_UNRESERVED are supported, for others first is returned as is.
+ * The result is not necessarily the first non-member, callers need to
+ * continue scanning with URI_CHAR_IS character by character. */
+const char * uriSkipCharClassBlocks(
+        const char * first, const char * afterLast, unsigned int mask);
+
+/* Skips whole blocks of characters that contain neither "%" nor,
+ * with withPlus, "+", using SIMD where available.
+ * Like with uriSkipCharClassBlocks, callers need to continue scanning
+ * character by character. */
+const char * uriSkipUnescapedBlocks(
+        const char * first, const char * afterLast, int withPlus);
+
+#endif /* URI_CHAR_CLASS_H */
@@ -61,7 +61,9 @@
 
 #  ifndef URI_DOXYGEN
 #    include <uriparser/Uri.h>
+#    include "UriCharClass.h"
 #    include "UriCommon.h"
+#    include "UriIp6Base.h"
 #    include "UriSets.h"
 #  endif
 
@@ -72,6 +74,7 @@
 /*extern*/ const URI_CHAR * const URI_FUNC(SafeToPointTo) = _UT("X");
 /*extern*/ const URI_CHAR * const URI_FUNC(ConstPwd) = _UT(".");
 /*extern*/ const URI_CHAR * const URI_FUNC(ConstParent) = _UT("..");
+/*extern*/ const char URI_FUNC(LazyPathMarker) = 0;
 
 void URI_FUNC(ResetUri)(URI_TYPE(Uri) * uri) {
     if (uri == NULL) {
@@ -80,6 +83,15 @@ void URI_FUNC(ResetUri)(URI_TYPE(Uri) * uri) {
     memset(uri, 0, sizeof(URI_TYPE(Uri)));
 }
 
+static UriBool URI_FUNC(IsHostDataInBlock)(const URI_TYPE(Uri) * uri) {
+    const URI_TYPE(PathSegmentBlock) * const block = uri->reserved;
+    return ((block != NULL)
+                   && ((uri->hostData.ip4 == &block->host.ip4)
+                           || (uri->hostData.ip6 == &block->host.ip6)))
+                   ? URI_TRUE
+                   : URI_FALSE;
+}
+
 int URI_FUNC(FreeUriPath)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
     assert(uri != NULL);
     assert(memory != NULL);
@@ -95,16 +107,71 @@ int URI_FUNC(FreeUriPath)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
             segWalk->text.first = NULL;
             segWalk->text.afterLast = NULL;
             segWalk->next = NULL;
-            memory->free(memory, segWalk);
+            URI_FUNC(FreePathSegment)(uri, segWalk, memory);
             segWalk = next;
         }
         uri->pathHead = NULL;
         uri->pathTail = NULL;
     }
 
+    /* Flat path segment storage (if any), unless still holding host data */
+    if ((uri->reserved != NULL) && !URI_FUNC(IsHostDataInBlock)(uri)) {
+        URI_TYPE(PathSegmentBlock) * const block = uri->reserved;
+        if (!block->isInline) {
+            memory->free(memory, block);
+        }
+        uri->reserved = NULL;
+    }
+
     return URI_SUCCESS;
 }
 
+/* Hands out storage for IPv4 host data, from the flat path segment block
+ * of the URI (if any) so that it takes no allocation of its own */
+UriIp4 * URI_FUNC(AllocateHostIp4)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
+    URI_TYPE(PathSegmentBlock) * const block = uri->reserved;
+    if (block != NULL) {
+        return &block->host.ip4;
+    }
+    return memory->malloc(memory, sizeof(UriIp4));
+}
+
+/* Same as AllocateHostIp4, for IPv6 host data */
+UriIp6 * URI_FUNC(AllocateHostIp6)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
+    URI_TYPE(PathSegmentBlock) * const block = uri->reserved;
+    if (block != NULL) {
+        return &block->host.ip6;
+    }
+    return memory->malloc(memory, sizeof(UriIp6));
+}
+
+/* Frees IPv4 and IPv6 host data, unless living in the flat path segment
+ * block that will be freed as a whole by FreeUriPath later */
+void URI_FUNC(FreeHostData)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
+    if (!URI_FUNC(IsHostDataInBlock)(uri)) {
+        if (uri->hostData.ip4 != NULL) {
+            memory->free(memory, uri->hostData.ip4);
+        }
+        if (uri->hostData.ip6 != NULL) {
+            memory->free(memory, uri->hostData.ip6);
+        }
+    }
+    uri->hostData.ip4 = NULL;
+    uri->hostData.ip6 = NULL;
+}
+
+/* Frees a single path segment, unless it lives in flat path segment storage
+ * that will be freed as a whole by FreeUriPath later */
+void URI_FUNC(FreePathSegment)(URI_TYPE(Uri) * uri, URI_TYPE(PathSegment) * segment,
+        UriMemoryManager * memory) {
+    const URI_TYPE(PathSegmentBlock) * const block = uri->reserved;
+    if ((block != NULL) && (segment >= block->segments)
+            && (segment < block->segments + block->capacity)) {
+        return;
+    }
+    memory->free(memory, segment);
+}
+
 /* Compares two text ranges for equal text content */
 bool URI_FUNC(RangeEquals)(const URI_TYPE(TextRange) * a, const URI_TYPE(TextRange) * b) {
     /* NOTE: Both NULL means equal! */
@@ -234,7 +301,7 @@ UriBool URI_FUNC(RemoveDotSegmentsEx)(URI_TYPE(Uri) * uri, UriBool relative,
                         if (pathOwned && (walker->text.first != walker->text.afterLast)) {
                             memory->free(memory, (URI_CHAR *)walker->text.first);
                         }
-                        memory->free(memory, walker);
+                        URI_FUNC(FreePathSegment)(uri, walker, memory);
                     } else {
                         /* Last segment */
                         if (pathOwned && (walker->text.first != walker->text.afterLast)) {
@@ -249,7 +316,7 @@ UriBool URI_FUNC(RemoveDotSegmentsEx)(URI_TYPE(Uri) * uri, UriBool relative,
                                 walker->text.first = URI_FUNC(SafeToPointTo);
                                 walker->text.afterLast = URI_FUNC(SafeToPointTo);
                             } else {
-                                memory->free(memory, walker);
+                                URI_FUNC(FreePathSegment)(uri, walker, memory);
 
                                 uri->pathHead = NULL;
                                 uri->pathTail = NULL;
@@ -320,7 +387,7 @@ UriBool URI_FUNC(RemoveDotSegmentsEx)(URI_TYPE(Uri) * uri, UriBool relative,
                                         memory->free(
                                                 memory, (URI_CHAR *)walker->text.first);
                                     }
-                                    memory->free(memory, walker);
+                                    URI_FUNC(FreePathSegment)(uri, walker, memory);
 
                                     if (pathOwned
                                             && (prev->text.first
@@ -328,7 +395,7 @@ UriBool URI_FUNC(RemoveDotSegmentsEx)(URI_TYPE(Uri) * uri, UriBool relative,
                                         memory->free(
                                                 memory, (URI_CHAR *)prev->text.first);
                                     }
-                                    memory->free(memory, prev);
+                                    URI_FUNC(FreePathSegment)(uri, prev, memory);
 
                                     return URI_FALSE; /* Raises malloc error */
                                 }
@@ -342,12 +409,12 @@ UriBool URI_FUNC(RemoveDotSegmentsEx)(URI_TYPE(Uri) * uri, UriBool relative,
                                     && (walker->text.first != walker->text.afterLast)) {
                                 memory->free(memory, (URI_CHAR *)walker->text.first);
                             }
-                            memory->free(memory, walker);
+                            URI_FUNC(FreePathSegment)(uri, walker, memory);
 
                             if (pathOwned && (prev->text.first != prev->text.afterLast)) {
                                 memory->free(memory, (URI_CHAR *)prev->text.first);
                             }
-                            memory->free(memory, prev);
+                            URI_FUNC(FreePathSegment)(uri, prev, memory);
 
                             walker = nextBackup;
                         } else {
@@ -361,7 +428,7 @@ UriBool URI_FUNC(RemoveDotSegmentsEx)(URI_TYPE(Uri) * uri, UriBool relative,
                                                 != walker->text.afterLast)) {
                                     memory->free(memory, (URI_CHAR *)walker->text.first);
                                 }
-                                memory->free(memory, walker);
+                                URI_FUNC(FreePathSegment)(uri, walker, memory);
                             } else {
                                 /* Reuse segment for "" path segment to represent trailing
                                  * slash, update tail */
@@ -380,7 +447,7 @@ UriBool URI_FUNC(RemoveDotSegmentsEx)(URI_TYPE(Uri) * uri, UriBool relative,
                             if (pathOwned && (prev->text.first != prev->text.afterLast)) {
                                 memory->free(memory, (URI_CHAR *)prev->text.first);
                             }
-                            memory->free(memory, prev);
+                            URI_FUNC(FreePathSegment)(uri, prev, memory);
 
                             walker = nextBackup;
                         }
@@ -429,7 +496,7 @@ UriBool URI_FUNC(RemoveDotSegmentsEx)(URI_TYPE(Uri) * uri, UriBool relative,
                                     && (walker->text.first != walker->text.afterLast)) {
                                 memory->free(memory, (URI_CHAR *)walker->text.first);
                             }
-                            memory->free(memory, walker);
+                            URI_FUNC(FreePathSegment)(uri, walker, memory);
                         }
 
                         walker = anotherNextBackup;
@@ -478,6 +545,95 @@ unsigned char URI_FUNC(HexdigToInt)(URI_CHAR hexdig) {
     }
 }
 
+int URI_FUNC(ParseIpSixText)(
+        unsigned char * output, const URI_CHAR * first, const URI_CHAR * afterLast) {
+    unsigned char packed[URI_IP6_PACKED_SIZE] = {0};
+    size_t len;
+    size_t i;
+
+    if ((first == NULL) || (afterLast <= first)) {
+        return URI_ERROR_SYNTAX;
+    }
+
+    len = (size_t)(afterLast - first);
+    if ((len < URI_IP6_TEXT_MIN_LEN) || (len > URI_IP6_TEXT_MAX_LEN)) {
+        return URI_ERROR_SYNTAX;
+    }
+
+    /* Narrow to bytes; anything outside of ASCII must not alias valid input */
+    for (i = 0; i < len; i++) {
+        packed[i] = ((unsigned long)first[i] < 0x80) ? (unsigned char)first[i] : 0xff;
+    }
+
+    return uriParseIpSixPacked(output, packed, (unsigned int)len);
+}
+
+UriBool URI_FUNC(IsCharClassOrPctEncoded)(
+        const URI_CHAR * first, const URI_CHAR * afterLast, unsigned int charClass) {
+    while (first < afterLast) {
+        if (URI_CHAR_IS(first[0], charClass)) {
+            first++;
+            continue;
+        }
+
+        /* pct-encoded = "%" HEXDIG HEXDIG */
+        if ((first[0] != _UT('%')) || (afterLast - first < 3)
+                || !URI_CHAR_IS(first[1], URI_CLASS_HEXDIG)
+                || !URI_CHAR_IS(first[2], URI_CLASS_HEXDIG)) {
+            return URI_FALSE;
+        }
+        first += 3;
+    }
+    return URI_TRUE;
+}
+
+/*
+ * Writes the UTF-8 form of the code point at *walker to utf8 (room for
+ * 4 bytes), advances *walker past it, and returns the number of bytes.
+ * NOTE: With char, input is UTF-8 already and taken byte by byte;
+ *       with wchar_t, UTF-16 surrogate pairs are combined.
+ */
+int URI_FUNC(NextCodePointUtf8)(
+        const URI_CHAR ** walker, const URI_CHAR * afterLast, unsigned char * utf8) {
+    const URI_CHAR * const first = *walker;
+    *walker = first + 1;
+
+#  ifdef URI_PASS_ANSI
+    (void)afterLast;
+    utf8[0] = (unsigned char)first[0];
+    return 1;
+#  else
+    unsigned long value = (unsigned long)first[0];
+    if ((value >= 0xD800) && (value <= 0xDBFF) && (afterLast - first >= 2)
+            && ((unsigned long)first[1] >= 0xDC00)
+            && ((unsigned long)first[1] <= 0xDFFF)) {
+        value = 0x10000 + ((value - 0xD800) << 10) + ((unsigned long)first[1] - 0xDC00);
+        *walker = first + 2;
+    } else if (value > 0x10FFFF) {
+        value = 0xFFFD; /* replacement character */
+    }
+
+    if (value < 0x80) {
+        utf8[0] = (unsigned char)value;
+        return 1;
+    } else if (value < 0x800) {
+        utf8[0] = (unsigned char)(0xC0 | (value >> 6));
+        utf8[1] = (unsigned char)(0x80 | (value & 0x3F));
+        return 2;
+    } else if (value < 0x10000) {
+        utf8[0] = (unsigned char)(0xE0 | (value >> 12));
+        utf8[1] = (unsigned char)(0x80 | ((value >> 6) & 0x3F));
+        utf8[2] = (unsigned char)(0x80 | (value & 0x3F));
+        return 3;
+    }
+    utf8[0] = (unsigned char)(0xF0 | (value >> 18));
+    utf8[1] = (unsigned char)(0x80 | ((value >> 12) & 0x3F));
+    utf8[2] = (unsigned char)(0x80 | ((value >> 6) & 0x3F));
+    utf8[3] = (unsigned char)(0x80 | (value & 0x3F));
+    return 4;
+#  endif
+}
+
 URI_CHAR URI_FUNC(HexToLetterEx)(unsigned int value, UriBool uppercase) {
     switch (value) {
     case 0:
@@ -528,7 +684,135 @@ UriBool URI_FUNC(HasHost)(const URI_TYPE(Uri) * uri) {
                    || (uri->hostData.ip6 != NULL));
 }
 
+/* Checks if a URI has an IPv6 host without host data, as left by
+ * URI_PARSE_SKIP_HOST_DATA; a registered name never contains ":". */
+UriBool URI_FUNC(IsHostIpSixText)(const URI_TYPE(Uri) * uri) {
+    const URI_CHAR * walker;
+    if ((uri->hostText.first == NULL) || (uri->hostData.ip4 != NULL)
+            || (uri->hostData.ip6 != NULL) || (uri->hostData.ipFuture.first != NULL)) {
+        return URI_FALSE;
+    }
+    for (walker = uri->hostText.first; walker < uri->hostText.afterLast; walker++) {
+        if (*walker == _UT(':')) {
+            return URI_TRUE;
+        }
+    }
+    return URI_FALSE;
+}
+
 /* Copies the path segment list from one URI to another. */
+UriBool URI_FUNC(IsPathLazy)(const URI_TYPE(Uri) * uri) {
+    return ((uri != NULL) && (uri->pathHead != NULL)
+                   && (uri->pathHead->reserved == &URI_FUNC(LazyPathMarker)))
+                 ? URI_TRUE
+                 : URI_FALSE;
+}
+
+static void URI_FUNC(FreeSplitPath)(
+        URI_TYPE(PathSegment) * head, UriBool ownText, UriMemoryManager * memory) {
+    while (head != NULL) {
+        URI_TYPE(PathSegment) * const next = head->next;
+        if (ownText && (head->text.first != head->text.afterLast)) {
+            memory->free(memory, (URI_CHAR *)head->text.first);
+        }
+        memory->free(memory, head);
+        head = next;
+    }
+}
+
+/* Splits the raw path text of a lazy path segment at slashes into
+ * a list of newly allocated path segments, copying text if copyText is set */
+static UriBool URI_FUNC(SplitLazyPath)(const URI_TYPE(PathSegment) * lazy,
+        URI_TYPE(PathSegment) ** head, URI_TYPE(PathSegment) ** tail, UriBool copyText,
+        UriMemoryManager * memory) {
+    const URI_CHAR * first = lazy->text.first;
+    const URI_CHAR * const afterLast = lazy->text.afterLast;
+    URI_TYPE(PathSegment) * prev = NULL;
+
+    *head = NULL;
+    for (;;) {
+        const URI_CHAR * afterSegment = first;
+        while ((afterSegment < afterLast) && (afterSegment[0] != _UT('/'))) {
+            afterSegment++;
+        }
+
+        URI_TYPE(PathSegment) * const segment =
+                memory->calloc(memory, 1, sizeof(URI_TYPE(PathSegment)));
+        if (segment == NULL) {
+            URI_FUNC(FreeSplitPath)(*head, copyText, memory);
+            return URI_FALSE;
+        }
+        if (prev == NULL) {
+            *head = segment;
+        } else {
+            prev->next = segment;
+        }
+        prev = segment;
+
+        if (first == afterSegment) {
+            segment->text.first = URI_FUNC(SafeToPointTo);
+            segment->text.afterLast = URI_FUNC(SafeToPointTo);
+        } else if (copyText) {
+            URI_TYPE(TextRange) sourceRange;
+            sourceRange.first = first;
+            sourceRange.afterLast = afterSegment;
+            if (!URI_FUNC(CopyRange)(&segment->text, &sourceRange, memory)) {
+                URI_FUNC(FreeSplitPath)(*head, copyText, memory);
+                return URI_FALSE;
+            }
+        } else {
+            segment->text.first = first;
+            segment->text.afterLast = afterSegment;
+        }
+
+        if (afterSegment == afterLast) {
+            break;
+        }
+        first = afterSegment + 1;
+    }
+
+    *tail = prev;
+    return URI_TRUE;
+}
+
+/* Splits the raw path of a URI parsed by ParseSingleUriExLazyMm
+ * into regular path segments, in place; no-op for any other path */
+UriBool URI_FUNC(MaterializePath)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
+    URI_TYPE(PathSegment) * head;
+    URI_TYPE(PathSegment) * tail;
+
+    if (!URI_FUNC(IsPathLazy)(uri)) {
+        return URI_TRUE;
+    }
+
+    URI_TYPE(PathSegment) * const lazy = uri->pathHead;
+    if (!URI_FUNC(SplitLazyPath)(lazy, &head, &tail, uri->owner, memory)) {
+        return URI_FALSE;
+    }
+
+    if (uri->owner == URI_TRUE) {
+        memory->free(memory, (URI_CHAR *)lazy->text.first);
+    }
+    URI_FUNC(FreePathSegment)(uri, lazy, memory);
+    uri->pathHead = head;
+    uri->pathTail = tail;
+    return URI_TRUE;
+}
+
+/* Makes dest a non-owning view of lazy URI source with the path split
+ * into regular path segments, leaving source untouched;
+ * the caller frees these segments with FreeUriPath(dest, ...) */
+UriBool URI_FUNC(MaterializePathShallow)(
+        URI_TYPE(Uri) * dest, const URI_TYPE(Uri) * source, UriMemoryManager * memory) {
+    assert(URI_FUNC(IsPathLazy)(source));
+
+    *dest = *source;
+    dest->owner = URI_FALSE;
+    dest->reserved = NULL;
+    return URI_FUNC(SplitLazyPath)(
+            source->pathHead, &dest->pathHead, &dest->pathTail, URI_FALSE, memory);
+}
+
 UriBool URI_FUNC(CopyPath)(
         URI_TYPE(Uri) * dest, const URI_TYPE(Uri) * source, UriMemoryManager * memory) {
     if (source->pathHead == NULL) {
@@ -584,7 +868,7 @@ UriBool URI_FUNC(CopyAuthority)(
 
     /* Copy hostData */
     if (source->hostData.ip4 != NULL) {
-        dest->hostData.ip4 = memory->malloc(memory, sizeof(UriIp4));
+        dest->hostData.ip4 = URI_FUNC(AllocateHostIp4)(dest, memory);
         if (dest->hostData.ip4 == NULL) {
             return URI_FALSE; /* Raises malloc error */
         }
@@ -594,7 +878,7 @@ UriBool URI_FUNC(CopyAuthority)(
         dest->hostData.ipFuture.afterLast = NULL;
     } else if (source->hostData.ip6 != NULL) {
         dest->hostData.ip4 = NULL;
-        dest->hostData.ip6 = memory->malloc(memory, sizeof(UriIp6));
+        dest->hostData.ip6 = URI_FUNC(AllocateHostIp6)(dest, memory);
         if (dest->hostData.ip6 == NULL) {
             return URI_FALSE; /* Raises malloc error */
         }
@@ -697,6 +981,10 @@ UriBool URI_FUNC(FixPathNoScheme)(URI_TYPE(Uri) * uri, UriMemoryManager * memory
     assert(uri != NULL);
     assert(memory != NULL);
 
+    if (!URI_FUNC(MaterializePath)(uri, memory)) {
+        return URI_FALSE;
+    }
+
     if ((uri->absolutePath == URI_TRUE) || (uri->pathHead == NULL)
             || (uri->scheme.first != NULL) || URI_FUNC(HasHost)(uri)) {
         return URI_TRUE; /* i.e. nothing to do */
@@ -743,6 +1031,10 @@ UriBool URI_FUNC(EnsureThatPathIsNotMistakenForHost)(
     assert(uri != NULL);
     assert(memory != NULL);
 
+    if (!URI_FUNC(MaterializePath)(uri, memory)) {
+        return URI_FALSE;
+    }
+
     if ((URI_FUNC(HasHost)(uri) == URI_TRUE) || (uri->absolutePath == URI_FALSE)
             || (uri->pathHead == NULL)
             || (uri->pathHead == uri->pathTail) /* i.e. no second slash */
@@ -759,7 +1051,7 @@ void URI_FUNC(FixEmptyTrailSegment)(URI_TYPE(Uri) * uri, UriMemoryManager * memo
     if (!uri->absolutePath && !URI_FUNC(HasHost)(uri) && (uri->pathHead != NULL)
             && (uri->pathHead->next == NULL)
             && (uri->pathHead->text.first == uri->pathHead->text.afterLast)) {
-        memory->free(memory, uri->pathHead);
+        URI_FUNC(FreePathSegment)(uri, uri->pathHead, memory);
         uri->pathHead = NULL;
         uri->pathTail = NULL;
     }
@@ -68,6 +68,7 @@
 #    endif
 
 #    include <stdbool.h>
+#    include <stddef.h>
 
 /* Used to point to from empty path segments.
  * X.first and X.afterLast must be the same non-NULL value then. */
@@ -75,9 +76,19 @@ extern const URI_CHAR * const URI_FUNC(SafeToPointTo);
 extern const URI_CHAR * const URI_FUNC(ConstPwd);
 extern const URI_CHAR * const URI_FUNC(ConstParent);
 
+/* Pointed to by .reserved of the single path segment holding the raw path
+ * of a URI parsed by ParseSingleUriExLazyMm, until the path gets split. */
+extern const char URI_FUNC(LazyPathMarker);
+
 void URI_FUNC(ResetUri)(URI_TYPE(Uri) * uri);
 
 int URI_FUNC(FreeUriPath)(URI_TYPE(Uri) * uri, UriMemoryManager * memory);
+void URI_FUNC(FreePathSegment)(URI_TYPE(Uri) * uri, URI_TYPE(PathSegment) * segment,
+        UriMemoryManager * memory);
+
+UriIp4 * URI_FUNC(AllocateHostIp4)(URI_TYPE(Uri) * uri, UriMemoryManager * memory);
+UriIp6 * URI_FUNC(AllocateHostIp6)(URI_TYPE(Uri) * uri, UriMemoryManager * memory);
+void URI_FUNC(FreeHostData)(URI_TYPE(Uri) * uri, UriMemoryManager * memory);
 
 bool URI_FUNC(RangeEquals)(const URI_TYPE(TextRange) * a, const URI_TYPE(TextRange) * b);
 
@@ -93,6 +104,31 @@ UriBool URI_FUNC(RemoveDotSegmentsEx)(URI_TYPE(Uri) * uri, UriBool relative,
 
 unsigned char URI_FUNC(HexdigToInt)(URI_CHAR hexdig);
 URI_CHAR URI_FUNC(HexToLetterEx)(unsigned int value, UriBool uppercase);
+int URI_FUNC(NextCodePointUtf8)(
+        const URI_CHAR ** walker, const URI_CHAR * afterLast, unsigned char * utf8);
+
+/* Parses IPv6 text without brackets into 16 bytes of output, see UriIp6Base.c.
+ * Returns URI_SUCCESS or URI_ERROR_SYNTAX. */
+int URI_FUNC(ParseIpSixText)(
+        unsigned char * output, const URI_CHAR * first, const URI_CHAR * afterLast);
+
+/* Runs the IPv6address rule of UriParse.c over the IP literal text
+ * after "[" in [first, afterLast). Returns URI_SUCCESS once it ends
+ * with "]", otherwise URI_ERROR_SYNTAX with *errorPos == afterLast
+ * if the text is valid as far as it goes. */
+int URI_FUNC(ScanIpSixLiteral)(const URI_CHAR * first, const URI_CHAR * afterLast,
+        const URI_CHAR ** errorPos);
+
+/* Checks that [first, afterLast) is nothing but characters of class(es)
+ * charClass (see UriCharClass.h) and well-formed pct-encoded sequences. */
+UriBool URI_FUNC(IsCharClassOrPctEncoded)(
+        const URI_CHAR * first, const URI_CHAR * afterLast, unsigned int charClass);
+
+UriBool URI_FUNC(IsPathLazy)(const URI_TYPE(Uri) * uri);
+UriBool URI_FUNC(IsHostIpSixText)(const URI_TYPE(Uri) * uri);
+UriBool URI_FUNC(MaterializePath)(URI_TYPE(Uri) * uri, UriMemoryManager * memory);
+UriBool URI_FUNC(MaterializePathShallow)(
+        URI_TYPE(Uri) * dest, const URI_TYPE(Uri) * source, UriMemoryManager * memory);
 
 UriBool URI_FUNC(CopyPath)(
         URI_TYPE(Uri) * dest, const URI_TYPE(Uri) * source, UriMemoryManager * memory);
@@ -0,0 +1,341 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriCompact.c
+ * Holds the compact %URI representation implementation.
+ * NOTE: This source file includes itself twice.
+ */
+
+/* What encodings are enabled? */
+#include <uriparser/UriDefsConfig.h>
+#if (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* Include SELF twice */
+#  ifdef URI_ENABLE_ANSI
+#    define URI_PASS_ANSI 1
+#    include "UriCompact.c"
+#    undef URI_PASS_ANSI
+#  endif
+#  ifdef URI_ENABLE_UNICODE
+#    define URI_PASS_UNICODE 1
+#    include "UriCompact.c"
+#    undef URI_PASS_UNICODE
+#  endif
+#else
+#  ifdef URI_PASS_ANSI
+#    include <uriparser/UriDefsAnsi.h>
+#  else
+#    include <uriparser/UriDefsUnicode.h>
+#    include <wchar.h>
+#  endif
+
+#  ifndef URI_DOXYGEN
+#    include <uriparser/Uri.h>
+#    include "UriCommon.h"
+#    include "UriMemory.h"
+#  endif
+
+#  include <stdint.h>  // UINT32_MAX, SIZE_MAX
+
+static size_t URI_FUNC(RangeLength)(const URI_TYPE(TextRange) * range) {
+    return (range->first == NULL) ? 0 : (size_t)(range->afterLast - range->first);
+}
+
+static URI_CHAR * URI_FUNC(AppendRange)(
+        URI_CHAR * walker, const URI_TYPE(TextRange) * range) {
+    const size_t length = URI_FUNC(RangeLength)(range);
+    if (length > 0) {
+        memcpy(walker, range->first, length * sizeof(URI_CHAR));
+    }
+    return walker + length;
+}
+
+int URI_FUNC(CompactFromUriMm)(URI_TYPE(Compact) ** compact, const URI_TYPE(Uri) * uri,
+        UriMemoryManager * memory) {
+    const URI_TYPE(PathSegment) * segment;
+    size_t textLength;
+    size_t segmentCount = 0;
+
+    if ((compact == NULL) || (uri == NULL)) {
+        return URI_ERROR_NULL;
+    }
+    URI_CHECK_MEMORY_MANAGER(memory); /* may return */
+
+    /* Measure, NOTE: The raw path of a lazy URI (see ParseSingleUriExLazyMm)
+     *                is a single segment holding slashes, so we count
+     *                slashes rather than list nodes */
+    textLength = URI_FUNC(RangeLength)(&uri->scheme)
+               + URI_FUNC(RangeLength)(&uri->userInfo)
+               + URI_FUNC(RangeLength)(&uri->hostText)
+               + URI_FUNC(RangeLength)(&uri->portText)
+               + URI_FUNC(RangeLength)(&uri->query)
+               + URI_FUNC(RangeLength)(&uri->fragment);
+    for (segment = uri->pathHead; segment != NULL; segment = segment->next) {
+        const URI_CHAR * walker = segment->text.first;
+        for (; walker < segment->text.afterLast; walker++) {
+            if (walker[0] == _UT('/')) {
+                segmentCount++;
+            }
+        }
+        segmentCount++;
+        textLength += URI_FUNC(RangeLength)(&segment->text)
+                    + ((segment != uri->pathHead) ? 1 : 0);
+    }
+
+    if (textLength > UINT32_MAX) {
+        return URI_ERROR_COMPACT_TOO_LONG;
+    }
+
+    /* NOTE: The offsets of segmentEnds keep the text suitably aligned */
+    const size_t headerSize = sizeof(URI_TYPE(Compact))
+                            + segmentCount * sizeof(uint32_t);
+    if ((textLength + 1) > (SIZE_MAX - headerSize) / sizeof(URI_CHAR)) {
+        return URI_ERROR_MALLOC;
+    }
+
+    URI_TYPE(Compact) * const output =
+            memory->malloc(memory, headerSize + (textLength + 1) * sizeof(URI_CHAR));
+    if (output == NULL) {
+        return URI_ERROR_MALLOC;
+    }
+
+    uint32_t * const segmentEnds = (uint32_t *)(output + 1);
+    URI_CHAR * const text = (URI_CHAR *)(segmentEnds + segmentCount);
+    URI_CHAR * walker = text;
+
+    memset(output->ipData, 0, sizeof(output->ipData));
+    output->flags = 0;
+    output->segmentCount = (uint32_t)segmentCount;
+
+    walker = URI_FUNC(AppendRange)(walker, &uri->scheme);
+    output->schemeEnd = (uint32_t)(walker - text);
+    walker = URI_FUNC(AppendRange)(walker, &uri->userInfo);
+    output->userInfoEnd = (uint32_t)(walker - text);
+    walker = URI_FUNC(AppendRange)(walker, &uri->hostText);
+    output->hostTextEnd = (uint32_t)(walker - text);
+    walker = URI_FUNC(AppendRange)(walker, &uri->portText);
+    output->portTextEnd = (uint32_t)(walker - text);
+
+    for (segment = uri->pathHead; segment != NULL; segment = segment->next) {
+        if (segment != uri->pathHead) {
+            *walker++ = _UT('/');
+        }
+        walker = URI_FUNC(AppendRange)(walker, &segment->text);
+    }
+    output->pathEnd = (uint32_t)(walker - text);
+
+    if (segmentCount > 0) {
+        const URI_CHAR * pathWalker = text + output->portTextEnd;
+        uint32_t * segmentEndsWalker = segmentEnds;
+        for (; pathWalker < walker; pathWalker++) {
+            if (pathWalker[0] == _UT('/')) {
+                *segmentEndsWalker++ = (uint32_t)(pathWalker - text);
+            }
+        }
+        *segmentEndsWalker = output->pathEnd;
+    }
+
+    walker = URI_FUNC(AppendRange)(walker, &uri->query);
+    output->queryEnd = (uint32_t)(walker - text);
+    walker = URI_FUNC(AppendRange)(walker, &uri->fragment);
+    output->fragmentEnd = (uint32_t)(walker - text);
+    *walker = _UT('\0');
+
+    if (uri->scheme.first != NULL) {
+        output->flags |= URI_COMPACT_HAS_SCHEME;
+    }
+    if (uri->userInfo.first != NULL) {
+        output->flags |= URI_COMPACT_HAS_USER_INFO;
+    }
+    if (URI_FUNC(HasHost)(uri)) {
+        output->flags |= URI_COMPACT_HAS_HOST;
+    }
+    if (uri->portText.first != NULL) {
+        output->flags |= URI_COMPACT_HAS_PORT;
+    }
+    if (uri->query.first != NULL) {
+        output->flags |= URI_COMPACT_HAS_QUERY;
+    }
+    if (uri->fragment.first != NULL) {
+        output->flags |= URI_COMPACT_HAS_FRAGMENT;
+    }
+    if (uri->absolutePath) {
+        output->flags |= URI_COMPACT_ABSOLUTE_PATH;
+    }
+    if (uri->hostData.ip4 != NULL) {
+        output->flags |= URI_COMPACT_HOST_IP4;
+        memcpy(output->ipData, uri->hostData.ip4->data, 4);
+    } else if (uri->hostData.ip6 != NULL) {
+        output->flags |= URI_COMPACT_HOST_IP6;
+        memcpy(output->ipData, uri->hostData.ip6->data, 16);
+    } else if (uri->hostData.ipFuture.first != NULL) {
+        output->flags |= URI_COMPACT_HOST_IPFUTURE;
+    }
+
+    output->text = text;
+    output->segmentEnds = segmentEnds;
+    *compact = output;
+    return URI_SUCCESS;
+}
+
+int URI_FUNC(CompactFromUri)(URI_TYPE(Compact) ** compact, const URI_TYPE(Uri) * uri) {
+    return URI_FUNC(CompactFromUriMm)(compact, uri, NULL);
+}
+
+static void URI_FUNC(SetRange)(URI_TYPE(TextRange) * range, const URI_CHAR * text,
+        uint32_t first, uint32_t afterLast) {
+    range->first = text + first;
+    range->afterLast = text + afterLast;
+}
+
+int URI_FUNC(UriFromCompactMm)(URI_TYPE(Uri) * uri, const URI_TYPE(Compact) * compact,
+        UriMemoryManager * memory) {
+    const URI_CHAR * text;
+
+    if ((uri == NULL) || (compact == NULL)) {
+        return URI_ERROR_NULL;
+    }
+    URI_CHECK_MEMORY_MANAGER(memory); /* may return */
+
+    URI_FUNC(ResetUri)(uri);
+    text = compact->text;
+
+    if (compact->flags & URI_COMPACT_HAS_SCHEME) {
+        URI_FUNC(SetRange)(&uri->scheme, text, 0, compact->schemeEnd);
+    }
+    if (compact->flags & URI_COMPACT_HAS_USER_INFO) {
+        URI_FUNC(SetRange)(
+                &uri->userInfo, text, compact->schemeEnd, compact->userInfoEnd);
+    }
+    if (compact->flags & URI_COMPACT_HAS_HOST) {
+        URI_FUNC(SetRange)(
+                &uri->hostText, text, compact->userInfoEnd, compact->hostTextEnd);
+    }
+    if (compact->flags & URI_COMPACT_HAS_PORT) {
+        URI_FUNC(SetRange)(
+                &uri->portText, text, compact->hostTextEnd, compact->portTextEnd);
+    }
+    if (compact->flags & URI_COMPACT_HAS_QUERY) {
+        URI_FUNC(SetRange)(&uri->query, text, compact->pathEnd, compact->queryEnd);
+    }
+    if (compact->flags & URI_COMPACT_HAS_FRAGMENT) {
+        URI_FUNC(SetRange)(&uri->fragment, text, compact->queryEnd, compact->fragmentEnd);
+    }
+    uri->absolutePath =
+            (compact->flags & URI_COMPACT_ABSOLUTE_PATH) ? URI_TRUE : URI_FALSE;
+    uri->owner = URI_FALSE;
+
+    /* Path, in flat path segment storage (see ParseSingleUriExFlatMm) */
+    if (compact->segmentCount > 0) {
+        const size_t segmentCount = compact->segmentCount;
+        URI_TYPE(PathSegmentBlock) * block;
+        uint32_t first = compact->portTextEnd;
+        size_t i;
+
+        if (segmentCount > (SIZE_MAX - sizeof(URI_TYPE(PathSegmentBlock)))
+                                   / sizeof(URI_TYPE(PathSegment))) {
+            URI_FUNC(FreeUriMembersMm)(uri, memory);
+            return URI_ERROR_MALLOC;
+        }
+        block = memory->calloc(memory, 1,
+                sizeof(URI_TYPE(PathSegmentBlock))
+                        + segmentCount * sizeof(URI_TYPE(PathSegment)));
+        if (block == NULL) {
+            URI_FUNC(FreeUriMembersMm)(uri, memory);
+            return URI_ERROR_MALLOC;
+        }
+        block->capacity = segmentCount;
+        block->used = segmentCount;
+        block->segments = (URI_TYPE(PathSegment) *)(block + 1);
+        uri->reserved = block;
+
+        for (i = 0; i < segmentCount; i++) {
+            URI_TYPE(PathSegment) * const segment = &block->segments[i];
+            const uint32_t afterLast = compact->segmentEnds[i];
+            if (first == afterLast) {
+                segment->text.first = URI_FUNC(SafeToPointTo);
+                segment->text.afterLast = URI_FUNC(SafeToPointTo);
+            } else {
+                URI_FUNC(SetRange)(&segment->text, text, first, afterLast);
+            }
+            segment->next = (i + 1 < segmentCount) ? &block->segments[i + 1] : NULL;
+            first = afterLast + 1;
+        }
+        uri->pathHead = &block->segments[0];
+        uri->pathTail = &block->segments[segmentCount - 1];
+    }
+
+    /* Host data, inline in the path block if there is one */
+    if (compact->flags & URI_COMPACT_HOST_IP4) {
+        uri->hostData.ip4 = URI_FUNC(AllocateHostIp4)(uri, memory);
+        if (uri->hostData.ip4 == NULL) {
+            URI_FUNC(FreeUriMembersMm)(uri, memory);
+            return URI_ERROR_MALLOC;
+        }
+        memcpy(uri->hostData.ip4->data, compact->ipData, 4);
+    } else if (compact->flags & URI_COMPACT_HOST_IP6) {
+        uri->hostData.ip6 = URI_FUNC(AllocateHostIp6)(uri, memory);
+        if (uri->hostData.ip6 == NULL) {
+            URI_FUNC(FreeUriMembersMm)(uri, memory);
+            return URI_ERROR_MALLOC;
+        }
+        memcpy(uri->hostData.ip6->data, compact->ipData, 16);
+    } else if (compact->flags & URI_COMPACT_HOST_IPFUTURE) {
+        uri->hostData.ipFuture = uri->hostText;
+    }
+
+    return URI_SUCCESS;
+}
+
+int URI_FUNC(UriFromCompact)(URI_TYPE(Uri) * uri, const URI_TYPE(Compact) * compact) {
+    return URI_FUNC(UriFromCompactMm)(uri, compact, NULL);
+}
+
+int URI_FUNC(FreeCompactMm)(URI_TYPE(Compact) * compact, UriMemoryManager * memory) {
+    URI_CHECK_MEMORY_MANAGER(memory); /* may return */
+    if (compact != NULL) {
+        memory->free(memory, compact);
+    }
+    return URI_SUCCESS;
+}
+
+void URI_FUNC(FreeCompact)(URI_TYPE(Compact) * compact) {
+    URI_FUNC(FreeCompactMm)(compact, NULL);
+}
+
+#endif
@@ -65,6 +65,51 @@
 #    include "UriCommon.h"
 #  endif
 
+/* Compares two paths as text with segments joined by slashes,
+ * so that a lazy path (see ParseSingleUriExLazyMm) can be compared
+ * to a path of regular segments without splitting it */
+static UriBool URI_FUNC(PathTextEquals)(
+        const URI_TYPE(PathSegment) * walkA, const URI_TYPE(PathSegment) * walkB) {
+    const URI_CHAR * posA = walkA->text.first;
+    const URI_CHAR * posB = walkB->text.first;
+
+    for (;;) {
+        const UriBool endOfA = (posA == walkA->text.afterLast) ? URI_TRUE : URI_FALSE;
+        const UriBool endOfB = (posB == walkB->text.afterLast) ? URI_TRUE : URI_FALSE;
+
+        if (endOfA && endOfB) {
+            if ((walkA->next == NULL) || (walkB->next == NULL)) {
+                return ((walkA->next == NULL) && (walkB->next == NULL)) ? URI_TRUE
+                                                                         : URI_FALSE;
+            }
+            walkA = walkA->next;
+            walkB = walkB->next;
+            posA = walkA->text.first;
+            posB = walkB->text.first;
+        } else if (endOfA) {
+            if ((walkA->next == NULL) || (posB[0] != _UT('/'))) {
+                return URI_FALSE;
+            }
+            walkA = walkA->next;
+            posA = walkA->text.first;
+            posB++;
+        } else if (endOfB) {
+            if ((walkB->next == NULL) || (posA[0] != _UT('/'))) {
+                return URI_FALSE;
+            }
+            walkB = walkB->next;
+            posB = walkB->text.first;
+            posA++;
+        } else {
+            if (posA[0] != posB[0]) {
+                return URI_FALSE;
+            }
+            posA++;
+            posB++;
+        }
+    }
+}
+
 UriBool URI_FUNC(EqualsUri)(const URI_TYPE(Uri) * a, const URI_TYPE(Uri) * b) {
     /* NOTE: Both NULL means equal! */
     if ((a == NULL) || (b == NULL)) {
@@ -129,7 +174,11 @@ UriBool URI_FUNC(EqualsUri)(const URI_TYPE(Uri) * a, const URI_TYPE(Uri) * b) {
         return URI_FALSE;
     }
 
-    if (a->pathHead != NULL) {
+    if (URI_FUNC(IsPathLazy)(a) || URI_FUNC(IsPathLazy)(b)) {
+        if (!URI_FUNC(PathTextEquals)(a->pathHead, b->pathHead)) {
+            return URI_FALSE;
+        }
+    } else if (a->pathHead != NULL) {
         URI_TYPE(PathSegment) * walkA = a->pathHead;
         URI_TYPE(PathSegment) * walkB = b->pathHead;
         do {
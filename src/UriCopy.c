@@ -78,13 +78,7 @@ static void URI_FUNC(PreventLeakageAfterCopy)(
         URI_TYPE(Uri) * uri, unsigned int revertMask, UriMemoryManager * memory) {
     URI_FUNC(PreventLeakage)(uri, revertMask, memory);
 
-    if (uri->hostData.ip4 != NULL) {
-        memory->free(memory, uri->hostData.ip4);
-        uri->hostData.ip4 = NULL;
-    } else if (uri->hostData.ip6 != NULL) {
-        memory->free(memory, uri->hostData.ip6);
-        uri->hostData.ip6 = NULL;
-    }
+    URI_FUNC(FreeHostData)(uri, memory);
 
     if (revertMask & URI_NORMALIZE_PORT) {
         if (uri->portText.first != uri->portText.afterLast) {
@@ -133,7 +127,7 @@ int URI_FUNC(CopyUriMm)(URI_TYPE(Uri) * destUri, const URI_TYPE(Uri) * sourceUri
     if (sourceUri->hostData.ip4 == NULL) {
         destUri->hostData.ip4 = NULL;
     } else {
-        destUri->hostData.ip4 = memory->malloc(memory, sizeof(UriIp4));
+        destUri->hostData.ip4 = URI_FUNC(AllocateHostIp4)(destUri, memory);
         if (destUri->hostData.ip4 == NULL) {
             URI_FUNC(PreventLeakageAfterCopy)(destUri, revertMask, memory);
             return URI_ERROR_MALLOC;
@@ -144,7 +138,7 @@ int URI_FUNC(CopyUriMm)(URI_TYPE(Uri) * destUri, const URI_TYPE(Uri) * sourceUri
     if (sourceUri->hostData.ip6 == NULL) {
         destUri->hostData.ip6 = NULL;
     } else {
-        destUri->hostData.ip6 = memory->malloc(memory, sizeof(UriIp6));
+        destUri->hostData.ip6 = URI_FUNC(AllocateHostIp6)(destUri, memory);
         if (destUri->hostData.ip6 == NULL) {
             URI_FUNC(PreventLeakageAfterCopy)(destUri, revertMask, memory);
             return URI_ERROR_MALLOC;
@@ -188,7 +182,11 @@ int URI_FUNC(CopyUriMm)(URI_TYPE(Uri) * destUri, const URI_TYPE(Uri) * sourceUri
             destWalker->text.first = NULL;
             destWalker->text.afterLast = NULL;
             destWalker->next = NULL;
-            destWalker->reserved = NULL;
+            /* Keep a lazy path lazy, see ParseSingleUriExLazyMm */
+            destWalker->reserved =
+                    (sourceWalker->reserved == &URI_FUNC(LazyPathMarker))
+                            ? sourceWalker->reserved
+                            : NULL;
 
             if (destUri->pathHead == NULL) {
                 destUri->pathHead = destWalker;
@@ -61,20 +61,34 @@
 
 #  ifndef URI_DOXYGEN
 #    include <uriparser/Uri.h>
+#    include "UriCharClass.h"
 #    include "UriCommon.h"
-#    include "UriSets.h"
+#    include "UriMemory.h"
 #  endif
 
+#  include <limits.h> /* for INT_MAX */
+#  include <stddef.h> /* for ptrdiff_t */
+#  include <string.h> /* for memcpy, memmove, strlen */
+
 URI_CHAR * URI_FUNC(Escape)(const URI_CHAR * in, URI_CHAR * out, UriBool spaceToPlus,
         UriBool normalizeBreaks) {
     return URI_FUNC(EscapeEx)(in, NULL, out, spaceToPlus, normalizeBreaks);
 }
 
-URI_CHAR * URI_FUNC(EscapeEx)(const URI_CHAR * inFirst, const URI_CHAR * inAfterLast,
-        URI_CHAR * out, UriBool spaceToPlus, UriBool normalizeBreaks) {
+/* Is character c to be copied unmodified? With escapePlus, a literal "+"
+ * is escaped even if in keepMask, so that it is not mistaken for a space */
+static URI_INLINE UriBool URI_FUNC(EscapeKeeps)(
+        URI_CHAR c, unsigned int keepMask, UriBool escapePlus) {
+    return URI_CHAR_IS(c, keepMask) && ((c != _UT('+')) || !escapePlus);
+}
+
+static URI_CHAR * URI_FUNC(EscapeEngine)(const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, URI_CHAR * out, unsigned int keepMask,
+        UriBool spaceToPlus, UriBool normalizeBreaks) {
     const URI_CHAR * read = inFirst;
     URI_CHAR * write = out;
     UriBool prevWasCr = URI_FALSE;
+    const UriBool escapePlus = spaceToPlus && URI_CHAR_IS(_UT('+'), keepMask);
     if ((out == NULL) || (inFirst == out)) {
         return NULL;
     } else if (inFirst == NULL) {
@@ -90,6 +104,28 @@ URI_CHAR * URI_FUNC(EscapeEx)(const URI_CHAR * inFirst, const URI_CHAR * inAfter
             return write;
         }
 
+        if (URI_FUNC(EscapeKeeps)(read[0], keepMask, escapePlus)) {
+            /* Copy runs of characters to keep unmodified, in one go */
+            const URI_CHAR * afterRun = read + 1;
+#  ifdef URI_PASS_ANSI
+            /* NOTE: Blocks are not checked for "+" */
+            if ((inAfterLast != NULL) && !escapePlus) {
+                afterRun = uriSkipCharClassBlocks(afterRun, inAfterLast, keepMask);
+            }
+#  endif
+            while (((inAfterLast == NULL) || (afterRun < inAfterLast))
+                    && URI_FUNC(EscapeKeeps)(afterRun[0], keepMask, escapePlus)) {
+                afterRun++;
+            }
+
+            memcpy(write, read, (afterRun - read) * sizeof(URI_CHAR));
+            write += afterRun - read;
+            read = afterRun;
+
+            prevWasCr = URI_FALSE;
+            continue;
+        }
+
         switch (read[0]) {
         case _UT('\0'):
             write[0] = _UT('\0');
@@ -108,14 +144,6 @@ URI_CHAR * URI_FUNC(EscapeEx)(const URI_CHAR * inFirst, const URI_CHAR * inAfter
             prevWasCr = URI_FALSE;
             break;
 
-        case URI_SET_UNRESERVED(_UT):
-            /* Copy unmodified */
-            write[0] = read[0];
-            write++;
-
-            prevWasCr = URI_FALSE;
-            break;
-
         case _UT('\x0a'):
             if (normalizeBreaks) {
                 if (!prevWasCr) {
@@ -162,8 +190,8 @@ URI_CHAR * URI_FUNC(EscapeEx)(const URI_CHAR * inFirst, const URI_CHAR * inAfter
                  * of RFC 3986:                                              *
                  * https://datatracker.ietf.org/doc/html/rfc3986#section-2.1 */
                 write[0] = _UT('%');
-                write[1] = URI_FUNC(HexToLetterEx)(code >> 4, URI_TRUE);
-                write[2] = URI_FUNC(HexToLetterEx)(code & 0x0f, URI_TRUE);
+                write[1] = _UT("0123456789ABCDEF")[code >> 4];
+                write[2] = _UT("0123456789ABCDEF")[code & 0x0f];
                 write += 3;
             }
             prevWasCr = URI_FALSE;
@@ -174,159 +202,444 @@ URI_CHAR * URI_FUNC(EscapeEx)(const URI_CHAR * inFirst, const URI_CHAR * inAfter
     }
 }
 
-const URI_CHAR * URI_FUNC(UnescapeInPlace)(URI_CHAR * inout) {
-    return URI_FUNC(UnescapeInPlaceEx)(inout, URI_FALSE, URI_BR_DONT_TOUCH);
-}
-
-const URI_CHAR * URI_FUNC(UnescapeInPlaceEx)(
-        URI_CHAR * inout, UriBool plusToSpace, UriBreakConversion breakConversion) {
-    URI_CHAR * read = inout;
-    URI_CHAR * write = inout;
+static int URI_FUNC(EscapeCharsRequiredEngine)(const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, unsigned int keepMask, UriBool spaceToPlus,
+        UriBool normalizeBreaks, int * charsRequired) {
+    const URI_CHAR * read = inFirst;
+    size_t total = 0;
     UriBool prevWasCr = URI_FALSE;
+    const UriBool escapePlus = spaceToPlus && URI_CHAR_IS(_UT('+'), keepMask);
 
-    if (inout == NULL) {
-        return NULL;
+    if (charsRequired == NULL) {
+        return URI_ERROR_NULL;
+    } else if (inFirst == NULL) {
+        *charsRequired = 0;
+        return URI_SUCCESS;
     }
 
-    for (;;) {
-        switch (read[0]) {
-        case _UT('\0'):
-            if (read > write) {
-                write[0] = _UT('\0');
+#  ifdef URI_PASS_ANSI
+    /* Block skipping needs to know where the input ends */
+    if (inAfterLast == NULL) {
+        inAfterLast = inFirst + strlen(inFirst);
+    }
+#  endif
+
+    /* NOTE: This needs to stay in sync with EscapeEngine */
+    while (((inAfterLast == NULL) || (read < inAfterLast)) && (read[0] != _UT('\0'))) {
+        if (URI_FUNC(EscapeKeeps)(read[0], keepMask, escapePlus)) {
+            /* Count runs of characters to keep in one go */
+            const URI_CHAR * afterRun = read + 1;
+#  ifdef URI_PASS_ANSI
+            if (!escapePlus) {
+                afterRun = uriSkipCharClassBlocks(afterRun, inAfterLast, keepMask);
             }
-            return write;
+#  endif
+            while (((inAfterLast == NULL) || (afterRun < inAfterLast))
+                    && URI_FUNC(EscapeKeeps)(afterRun[0], keepMask, escapePlus)) {
+                afterRun++;
+            }
+
+            total += afterRun - read;
+            read = afterRun;
+
+            prevWasCr = URI_FALSE;
+        } else {
+            switch (read[0]) {
+            case _UT(' '):
+                total += spaceToPlus ? 1 : 3;
+                prevWasCr = URI_FALSE;
+                break;
 
-        case _UT('%'):
-            switch (read[1]) {
-            case URI_SET_HEXDIG(_UT):
-                switch (read[2]) {
-                case URI_SET_HEXDIG(_UT): {
-                    /* Percent group found */
-                    const unsigned char left = URI_FUNC(HexdigToInt)(read[1]);
-                    const unsigned char right = URI_FUNC(HexdigToInt)(read[2]);
-                    const int code = 16 * left + right;
-                    switch (code) {
-                    case 10:
-                        switch (breakConversion) {
-                        case URI_BR_TO_LF:
-                            if (!prevWasCr) {
-                                write[0] = (URI_CHAR)10;
-                                write++;
-                            }
-                            break;
-
-                        case URI_BR_TO_CRLF:
-                            if (!prevWasCr) {
-                                write[0] = (URI_CHAR)13;
-                                write[1] = (URI_CHAR)10;
-                                write += 2;
-                            }
-                            break;
-
-                        case URI_BR_TO_CR:
-                            if (!prevWasCr) {
-                                write[0] = (URI_CHAR)13;
-                                write++;
-                            }
-                            break;
-
-                        case URI_BR_DONT_TOUCH:
-                        default:
-                            write[0] = (URI_CHAR)10;
-                            write++;
-                        }
-                        prevWasCr = URI_FALSE;
-                        break;
-
-                    case 13:
-                        switch (breakConversion) {
-                        case URI_BR_TO_LF:
-                            write[0] = (URI_CHAR)10;
-                            write++;
-                            break;
-
-                        case URI_BR_TO_CRLF:
-                            write[0] = (URI_CHAR)13;
-                            write[1] = (URI_CHAR)10;
-                            write += 2;
-                            break;
-
-                        case URI_BR_TO_CR:
-                            write[0] = (URI_CHAR)13;
-                            write++;
-                            break;
-
-                        case URI_BR_DONT_TOUCH:
-                        default:
-                            write[0] = (URI_CHAR)13;
-                            write++;
-                        }
-                        prevWasCr = URI_TRUE;
-                        break;
-
-                    default:
-                        write[0] = (URI_CHAR)(code);
-                        write++;
-
-                        prevWasCr = URI_FALSE;
-                    }
-                    read += 3;
-                } break;
-
-                default:
-                    /* Copy two chars unmodified and */
-                    /* look at this char again */
-                    if (read > write) {
-                        write[0] = read[0];
-                        write[1] = read[1];
-                    }
-                    read += 2;
-                    write += 2;
-
-                    prevWasCr = URI_FALSE;
+            case _UT('\x0a'):
+                if (normalizeBreaks) {
+                    total += prevWasCr ? 0 : 6;
+                } else {
+                    total += 3;
                 }
+                prevWasCr = URI_FALSE;
+                break;
+
+            case _UT('\x0d'):
+                total += normalizeBreaks ? 6 : 3;
+                prevWasCr = URI_TRUE;
                 break;
 
             default:
-                /* Copy one char unmodified and */
-                /* look at this char again */
-                if (read > write) {
-                    write[0] = read[0];
-                }
-                read++;
+                total += 3;
+                prevWasCr = URI_FALSE;
+                break;
+            }
+
+            read++;
+        }
+
+        if (total > (size_t)INT_MAX) {
+            return URI_ERROR_OUTPUT_TOO_LARGE;
+        }
+    }
+
+    *charsRequired = (int)total;
+    return URI_SUCCESS;
+}
+
+static unsigned int URI_FUNC(EscapeComponentKeepMask)(UriEscapeComponent component) {
+    switch (component) {
+    case URI_ESCAPE_USERINFO:
+        return URI_CLASS_USERINFO;
+
+    case URI_ESCAPE_SEGMENT:
+        return URI_CLASS_PCHAR;
+
+    case URI_ESCAPE_PATH:
+        return URI_CLASS_PATH;
+
+    case URI_ESCAPE_QUERY_VALUE:
+        return URI_CLASS_QUERY_VALUE;
+
+    case URI_ESCAPE_FRAGMENT:
+        return URI_CLASS_QUERY_FRAG;
+
+    case URI_ESCAPE_UNRESERVED:
+    default:
+        return URI_CLASS_UNRESERVED;
+    }
+}
+
+URI_CHAR * URI_FUNC(EscapeEx)(const URI_CHAR * inFirst, const URI_CHAR * inAfterLast,
+        URI_CHAR * out, UriBool spaceToPlus, UriBool normalizeBreaks) {
+    return URI_FUNC(EscapeEngine)(inFirst, inAfterLast, out, URI_CLASS_UNRESERVED,
+            spaceToPlus, normalizeBreaks);
+}
+
+URI_CHAR * URI_FUNC(EscapeComponentEx)(const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, URI_CHAR * out, UriEscapeComponent component,
+        UriBool spaceToPlus, UriBool normalizeBreaks) {
+    return URI_FUNC(EscapeEngine)(inFirst, inAfterLast, out,
+            URI_FUNC(EscapeComponentKeepMask)(component), spaceToPlus, normalizeBreaks);
+}
+
+int URI_FUNC(EscapeCharsRequiredEx)(const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, UriBool spaceToPlus, UriBool normalizeBreaks,
+        int * charsRequired) {
+    return URI_FUNC(EscapeCharsRequiredEngine)(inFirst, inAfterLast, URI_CLASS_UNRESERVED,
+            spaceToPlus, normalizeBreaks, charsRequired);
+}
+
+int URI_FUNC(EscapeComponentCharsRequiredEx)(const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, UriEscapeComponent component, UriBool spaceToPlus,
+        UriBool normalizeBreaks, int * charsRequired) {
+    return URI_FUNC(EscapeCharsRequiredEngine)(inFirst, inAfterLast,
+            URI_FUNC(EscapeComponentKeepMask)(component), spaceToPlus, normalizeBreaks,
+            charsRequired);
+}
+
+int URI_FUNC(EscapeMallocEx)(URI_CHAR ** dest, const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, UriBool spaceToPlus, UriBool normalizeBreaks) {
+    return URI_FUNC(EscapeMallocExMm)(
+            dest, inFirst, inAfterLast, spaceToPlus, normalizeBreaks, NULL);
+}
+
+int URI_FUNC(EscapeMallocExMm)(URI_CHAR ** dest, const URI_CHAR * inFirst,
+        const URI_CHAR * inAfterLast, UriBool spaceToPlus, UriBool normalizeBreaks,
+        UriMemoryManager * memory) {
+    int charsRequired;
+    int res;
+    URI_CHAR * escaped;
+
+    if (dest == NULL) {
+        return URI_ERROR_NULL;
+    }
+
+    URI_CHECK_MEMORY_MANAGER(memory); /* may return */
+
+    /* Calculate space */
+    res = URI_FUNC(EscapeCharsRequiredEx)(
+            inFirst, inAfterLast, spaceToPlus, normalizeBreaks, &charsRequired);
+    if (res != URI_SUCCESS) {
+        return res;
+    }
+
+    /* Detect overflow */
+    if ((size_t)-1 / sizeof(URI_CHAR) < (size_t)charsRequired + 1) {
+        return URI_ERROR_MALLOC;
+    }
+
+    /* Allocate space */
+    escaped = memory->malloc(memory, ((size_t)charsRequired + 1) * sizeof(URI_CHAR));
+    if (escaped == NULL) {
+        return URI_ERROR_MALLOC;
+    }
+
+    /* Put escaped text in */
+    URI_FUNC(EscapeEx)(inFirst, inAfterLast, escaped, spaceToPlus, normalizeBreaks);
+
+    *dest = escaped;
+    return URI_SUCCESS;
+}
+
+/* Writes the character with the given code, applying line break conversion */
+static URI_CHAR * URI_FUNC(UnescapeWriteCode)(URI_CHAR * write, int code,
+        UriBreakConversion breakConversion, UriBool * prevWasCr) {
+    switch (code) {
+    case 10:
+        switch (breakConversion) {
+        case URI_BR_TO_LF:
+            if (!*prevWasCr) {
+                write[0] = (URI_CHAR)10;
                 write++;
+            }
+            break;
 
-                prevWasCr = URI_FALSE;
+        case URI_BR_TO_CRLF:
+            if (!*prevWasCr) {
+                write[0] = (URI_CHAR)13;
+                write[1] = (URI_CHAR)10;
+                write += 2;
             }
             break;
 
-        case _UT('+'):
-            if (plusToSpace) {
-                /* Convert '+' to ' ' */
-                write[0] = _UT(' ');
-            } else {
-                /* Copy one char unmodified */
-                if (read > write) {
-                    write[0] = read[0];
-                }
+        case URI_BR_TO_CR:
+            if (!*prevWasCr) {
+                write[0] = (URI_CHAR)13;
+                write++;
             }
-            read++;
+            break;
+
+        case URI_BR_DONT_TOUCH:
+        default:
+            write[0] = (URI_CHAR)10;
             write++;
+        }
+        *prevWasCr = URI_FALSE;
+        break;
 
-            prevWasCr = URI_FALSE;
+    case 13:
+        switch (breakConversion) {
+        case URI_BR_TO_LF:
+            write[0] = (URI_CHAR)10;
+            write++;
+            break;
+
+        case URI_BR_TO_CRLF:
+            write[0] = (URI_CHAR)13;
+            write[1] = (URI_CHAR)10;
+            write += 2;
+            break;
+
+        case URI_BR_TO_CR:
+            write[0] = (URI_CHAR)13;
+            write++;
             break;
 
+        case URI_BR_DONT_TOUCH:
         default:
-            /* Copy one char unmodified */
-            if (read > write) {
-                write[0] = read[0];
+            write[0] = (URI_CHAR)13;
+            write++;
+        }
+        *prevWasCr = URI_TRUE;
+        break;
+
+    default:
+        write[0] = (URI_CHAR)(code);
+        write++;
+
+        *prevWasCr = URI_FALSE;
+    }
+    return write;
+}
+
+/* Decodes [read, afterLast) into write, stopping early at a zero character.
+ * NOTE: write may equal read but must not lie past it.
+ * With stop non-NULL, an incomplete percent group at the very end
+ * is held back rather than copied, and *stop is set to where decoding ended. */
+static URI_CHAR * URI_FUNC(UnescapeEngine)(const URI_CHAR * read,
+        const URI_CHAR * afterLast, URI_CHAR * write, UriBool plusToSpace,
+        UriBreakConversion breakConversion, UriBool * prevWasCr,
+        const URI_CHAR ** stop) {
+    for (;;) {
+        /* Move runs of characters that need no decoding in one go */
+        const URI_CHAR * afterRun = read;
+#  ifdef URI_PASS_ANSI
+        afterRun = uriSkipUnescapedBlocks(afterRun, afterLast, plusToSpace);
+#  endif
+        while ((afterRun < afterLast) && (afterRun[0] != _UT('\0'))
+                && (afterRun[0] != _UT('%'))
+                && ((afterRun[0] != _UT('+')) || !plusToSpace)) {
+            afterRun++;
+        }
+        if (afterRun > read) {
+            if (read != write) {
+                memmove(write, read, (afterRun - read) * sizeof(URI_CHAR));
             }
+            write += afterRun - read;
+            read = afterRun;
+
+            *prevWasCr = URI_FALSE;
+        }
+
+        if ((read >= afterLast) || (read[0] == _UT('\0'))) {
+            break;
+        }
+
+        if (read[0] == _UT('+')) {
+            /* Convert '+' to ' ' */
+            write[0] = _UT(' ');
             read++;
             write++;
 
-            prevWasCr = URI_FALSE;
+            *prevWasCr = URI_FALSE;
+            continue;
+        }
+
+        /* Percent sign */
+        const ptrdiff_t remaining = afterLast - read;
+        const UriBool incomplete = (remaining == 1)
+                || ((remaining == 2) && URI_CHAR_IS(read[1], URI_CLASS_HEXDIG));
+        if ((stop != NULL) && incomplete) {
+            /* Leave incomplete percent group to the next chunk */
+            break;
+        }
+
+        if ((remaining >= 3) && URI_CHAR_IS(read[1], URI_CLASS_HEXDIG)
+                && URI_CHAR_IS(read[2], URI_CLASS_HEXDIG)) {
+            /* Percent group found */
+            const unsigned char left = uriHexdigValueTable[(unsigned char)read[1]];
+            const unsigned char right = uriHexdigValueTable[(unsigned char)read[2]];
+            write = URI_FUNC(UnescapeWriteCode)(
+                    write, 16 * left + right, breakConversion, prevWasCr);
+            read += 3;
+        } else if ((remaining >= 2) && URI_CHAR_IS(read[1], URI_CLASS_HEXDIG)) {
+            /* Copy two chars unmodified and */
+            /* look at this char again */
+            write[0] = read[0];
+            write[1] = read[1];
+            read += 2;
+            write += 2;
+
+            *prevWasCr = URI_FALSE;
+        } else {
+            /* Copy one char unmodified and */
+            /* look at this char again */
+            write[0] = read[0];
+            read++;
+            write++;
+
+            *prevWasCr = URI_FALSE;
+        }
+    }
+
+    if (stop != NULL) {
+        *stop = read;
+    }
+    write[0] = _UT('\0');
+    return write;
+}
+
+const URI_CHAR * URI_FUNC(UnescapeInPlace)(URI_CHAR * inout) {
+    return URI_FUNC(UnescapeInPlaceEx)(inout, URI_FALSE, URI_BR_DONT_TOUCH);
+}
+
+const URI_CHAR * URI_FUNC(UnescapeInPlaceEx)(
+        URI_CHAR * inout, UriBool plusToSpace, UriBreakConversion breakConversion) {
+    UriBool prevWasCr = URI_FALSE;
+
+    if (inout == NULL) {
+        return NULL;
+    }
+
+    /* Block skipping needs to know where the input ends */
+    return URI_FUNC(UnescapeEngine)(inout, inout + URI_STRLEN(inout), inout,
+            plusToSpace, breakConversion, &prevWasCr, NULL);
+}
+
+URI_CHAR * URI_FUNC(UnescapeEx)(const URI_CHAR * inFirst, const URI_CHAR * inAfterLast,
+        URI_CHAR * out, UriBool plusToSpace, UriBreakConversion breakConversion) {
+    UriBool prevWasCr = URI_FALSE;
+
+    if (out == NULL) {
+        return NULL;
+    } else if (inFirst == NULL) {
+        out[0] = _UT('\0');
+        return out;
+    }
+
+    if (inAfterLast == NULL) {
+        inAfterLast = inFirst + URI_STRLEN(inFirst);
+    }
+
+    return URI_FUNC(UnescapeEngine)(inFirst, inAfterLast, out, plusToSpace,
+            breakConversion, &prevWasCr, NULL);
+}
+
+void URI_FUNC(InitUnescapeState)(URI_TYPE(UnescapeState) * state) {
+    if (state == NULL) {
+        return;
+    }
+
+    state->pendingCount = 0;
+    state->prevWasCr = URI_FALSE;
+}
+
+URI_CHAR * URI_FUNC(UnescapeChunkEx)(URI_TYPE(UnescapeState) * state,
+        const URI_CHAR * inFirst, const URI_CHAR * inAfterLast, URI_CHAR * out,
+        UriBool plusToSpace, UriBreakConversion breakConversion, UriBool isFinal) {
+    const URI_CHAR * read = inFirst;
+    URI_CHAR * write = out;
+
+    if ((state == NULL) || (out == NULL) || ((inFirst == NULL) != (inAfterLast == NULL))
+            || (state->pendingCount > 2)) {
+        return NULL;
+    }
+
+    /* Complete a percent group cut off at the end of the previous chunk */
+    while (state->pendingCount > 0) {
+        if ((read < inAfterLast) && URI_CHAR_IS(read[0], URI_CLASS_HEXDIG)) {
+            if (state->pendingCount == 1) {
+                state->pending[1] = read[0];
+                state->pendingCount = 2;
+            } else {
+                const unsigned char left =
+                        uriHexdigValueTable[(unsigned char)state->pending[1]];
+                const unsigned char right = uriHexdigValueTable[(unsigned char)read[0]];
+                write = URI_FUNC(UnescapeWriteCode)(
+                        write, 16 * left + right, breakConversion, &state->prevWasCr);
+                state->pendingCount = 0;
+            }
+            read++;
+        } else if ((read >= inAfterLast) && !isFinal) {
+            /* Still incomplete, wait for the next chunk */
+            write[0] = _UT('\0');
+            return write;
+        } else {
+            /* Copy held back chars unmodified and */
+            /* look at this char again */
+            memcpy(write, state->pending, state->pendingCount * sizeof(URI_CHAR));
+            write += state->pendingCount;
+            state->pendingCount = 0;
+            state->prevWasCr = URI_FALSE;
         }
     }
+
+    if (read == NULL) {
+        write[0] = _UT('\0');
+    } else if (isFinal) {
+        write = URI_FUNC(UnescapeEngine)(read, inAfterLast, write, plusToSpace,
+                breakConversion, &state->prevWasCr, NULL);
+    } else {
+        const URI_CHAR * stop;
+        write = URI_FUNC(UnescapeEngine)(read, inAfterLast, write, plusToSpace,
+                breakConversion, &state->prevWasCr, &stop);
+        if ((stop < inAfterLast) && (stop[0] == _UT('%'))) {
+            state->pendingCount = (unsigned char)(inAfterLast - stop);
+            memcpy(state->pending, stop, state->pendingCount * sizeof(URI_CHAR));
+        }
+    }
+
+    if (isFinal) {
+        URI_FUNC(InitUnescapeState)(state);
+    }
+
+    return write;
 }
 
 #endif
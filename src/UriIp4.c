@@ -71,6 +71,8 @@
 #    include "UriSets.h"
 #  endif
 
+#  include <stddef.h> /* size_t */
+
 /* Prototypes */
 static const URI_CHAR * URI_FUNC(ParseDecOctet)(
         UriIp4Parser * parser, const URI_CHAR * first, const URI_CHAR * afterLast);
@@ -83,10 +85,37 @@ static const URI_CHAR * URI_FUNC(ParseDecOctetThree)(
 static const URI_CHAR * URI_FUNC(ParseDecOctetFour)(
         UriIp4Parser * parser, const URI_CHAR * first, const URI_CHAR * afterLast);
 
+int URI_FUNC(ParseIpFourAddress)(
+        unsigned char * octetOutput, const URI_CHAR * first, const URI_CHAR * afterLast) {
+    unsigned char packed[URI_IP4_PACKED_SIZE] = {0};
+    size_t len;
+    size_t i;
+
+    /* Essential checks */
+    if ((octetOutput == NULL) || (first == NULL) || (afterLast <= first)) {
+        return URI_ERROR_SYNTAX;
+    }
+
+    len = (size_t)(afterLast - first);
+    if ((len < URI_IP4_TEXT_MIN_LEN) || (len > URI_IP4_TEXT_MAX_LEN)) {
+        return URI_ERROR_SYNTAX;
+    }
+
+    /* Narrow to bytes; anything outside of ASCII must not alias a digit or dot */
+    for (i = 0; i < len; i++) {
+        packed[i] = ((unsigned long)first[i] < 0x80) ? (unsigned char)first[i] : 0xff;
+    }
+
+    return uriParseIpFourPacked(octetOutput, packed, (unsigned int)len);
+}
+
 /*
+ * Character-wise reference implementation, kept for differential testing
+ * of the packed parser above.
+ *
  * [ipFourAddress]->[decOctet]<.>[decOctet]<.>[decOctet]<.>[decOctet]
  */
-int URI_FUNC(ParseIpFourAddress)(
+int URI_FUNC(_TESTING_ONLY_ParseIpFourAddressReference)(
         unsigned char * octetOutput, const URI_CHAR * first, const URI_CHAR * afterLast) {
     const URI_CHAR * after;
     UriIp4Parser parser;
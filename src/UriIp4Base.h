@@ -40,6 +40,8 @@
 #ifndef URI_IP4_BASE_H
 #  define URI_IP4_BASE_H 1
 
+#  include <stdint.h> /* for uint64_t */
+
 typedef struct UriIp4ParserStruct {
     unsigned char stackCount;
     unsigned char stackOne;
@@ -50,4 +52,33 @@ typedef struct UriIp4ParserStruct {
 void uriPushToStack(UriIp4Parser * parser, unsigned char digit);
 void uriStackToOctet(UriIp4Parser * parser, unsigned char * octet);
 
+/* SWAR ("SIMD within a register") helpers working on eight bytes packed
+ * into an uint64_t at a time, see uriSwarLoad.  Results have the high bit
+ * of each matching byte set.  Bytes 0x80 and up never match. */
+#  define URI_SWAR_ONES UINT64_C(0x0101010101010101)
+#  define URI_SWAR_HIGH UINT64_C(0x8080808080808080)
+/* NOTE: Setting the high bit of each byte first keeps the subtraction
+ *       from borrowing across bytes. */
+#  define URI_SWAR_AT_LEAST(x, c) \
+      (((((x) & ~URI_SWAR_HIGH) | URI_SWAR_HIGH) - URI_SWAR_ONES * (c)) \
+       & ~(x) & URI_SWAR_HIGH)
+#  define URI_SWAR_IN_RANGE(x, low, high) \
+      (URI_SWAR_AT_LEAST(x, low) & ~URI_SWAR_AT_LEAST(x, (high) + 1))
+#  define URI_SWAR_EQUALS(x, c) URI_SWAR_IN_RANGE(x, c, c)
+/* Gathers the high bit of byte i into bit i */
+#  define URI_SWAR_TO_BITMAP(highBits) \
+      ((unsigned int)((((highBits) >> 7) * UINT64_C(0x0102040810204080)) >> 56))
+
+uint64_t uriSwarLoad(const unsigned char * bytes);
+
+/* "0.0.0.0" to "255.255.255.255" */
+#  define URI_IP4_TEXT_MIN_LEN 7
+#  define URI_IP4_TEXT_MAX_LEN 15
+
+/* 16 bytes classified at once, plus slack for reading the last octet */
+#  define URI_IP4_PACKED_SIZE (16 + 2)
+
+int uriParseIpFourPacked(
+        unsigned char * octetOutput, const unsigned char * packed, unsigned int len);
+
 #endif /* URI_IP4_BASE_H */
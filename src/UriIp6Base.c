@@ -0,0 +1,188 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriIp6Base.c
+ * Holds code independent of the encoding pass.
+ */
+
+#ifndef URI_DOXYGEN
+#  include "UriIp6Base.h"
+#  include <uriparser/UriBase.h>
+#endif
+
+#include <string.h> /* for memcpy, memset */
+
+static unsigned int uriBitCount64(uint64_t x) {
+    x = x - ((x >> 1) & UINT64_C(0x5555555555555555));
+    x = (x & UINT64_C(0x3333333333333333)) + ((x >> 2) & UINT64_C(0x3333333333333333));
+    x = (x + (x >> 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+    return (unsigned int)((x * URI_SWAR_ONES) >> 56);
+}
+
+/*
+ * Parses IPv6 text (without brackets) of len (2 to 45) bytes from a
+ * zero-padded buffer of URI_IP6_PACKED_SIZE bytes.  Non-ASCII characters
+ * must have been replaced by 0xff.  All bytes are classified as hex
+ * digits, colons or dots eight at a time, so that the walk over the
+ * groups below only needs to look at the resulting bitmaps.
+ * Accepts exactly the grammar of the IPv6 state machine in UriParse.c.
+ *
+ * IPv6address =                            6( h16 ":" ) ls32
+ *             /                       "::" 5( h16 ":" ) ls32
+ *             / [               h16 ] "::" 4( h16 ":" ) ls32
+ *             / [ *1( h16 ":" ) h16 ] "::" 3( h16 ":" ) ls32
+ *             / [ *2( h16 ":" ) h16 ] "::" 2( h16 ":" ) ls32
+ *             / [ *3( h16 ":" ) h16 ] "::"    h16 ":"   ls32
+ *             / [ *4( h16 ":" ) h16 ] "::"              ls32
+ *             / [ *5( h16 ":" ) h16 ] "::"              h16
+ *             / [ *6( h16 ":" ) h16 ] "::"
+ * h16         = 1*4HEXDIG
+ * ls32        = ( h16 ":" h16 ) / IPv4address
+ */
+int uriParseIpSixPacked(
+        unsigned char * output, const unsigned char * packed, unsigned int len) {
+    uint64_t hexDigits = 0;
+    uint64_t colons = 0;
+    uint64_t dots = 0;
+    unsigned char bytes[16];
+    unsigned int byteCount = 0;
+    int zipperEver = 0;
+    unsigned int zipperAt = 0; /* Byte offset of "::" */
+    unsigned int pos = 0;
+    unsigned int w;
+
+    if ((len < URI_IP6_TEXT_MIN_LEN) || (len > URI_IP6_TEXT_MAX_LEN)) {
+        return URI_ERROR_SYNTAX;
+    }
+
+    for (w = 0; w < (URI_IP6_TEXT_MAX_LEN + 7) / 8; w++) {
+        const uint64_t x = uriSwarLoad(packed + 8 * w);
+        const uint64_t lowered = x | (URI_SWAR_ONES * 0x20);
+        const uint64_t hex = URI_SWAR_IN_RANGE(x, '0', '9')
+                             | URI_SWAR_IN_RANGE(lowered, 'a', 'f');
+        hexDigits |= (uint64_t)URI_SWAR_TO_BITMAP(hex) << (8 * w);
+        colons |= (uint64_t)URI_SWAR_TO_BITMAP(URI_SWAR_EQUALS(x, ':')) << (8 * w);
+        dots |= (uint64_t)URI_SWAR_TO_BITMAP(URI_SWAR_EQUALS(x, '.')) << (8 * w);
+    }
+
+    /* Nothing but hex digits, colons and dots, no trailing garbage */
+    if ((hexDigits | colons | dots) != (UINT64_C(1) << len) - 1) {
+        return URI_ERROR_SYNTAX;
+    }
+
+    /* Leading "::"? */
+    if (packed[0] == ':') {
+        if (packed[1] != ':') {
+            return URI_ERROR_SYNTAX;
+        }
+        zipperEver = 1;
+        pos = 2;
+    }
+
+    while (pos < len) {
+        const uint64_t colonsAhead = colons >> pos;
+        const unsigned int afterGroup =
+                (colonsAhead == 0)
+                        ? len
+                        : pos + uriBitCount64((colonsAhead & (0 - colonsAhead)) - 1);
+        const unsigned int groupLen = afterGroup - pos;
+        const uint64_t groupMask = ((UINT64_C(1) << groupLen) - 1) << pos;
+
+        if ((dots & groupMask) != 0) {
+            /* Embedded IPv4 address, must come last */
+            if ((afterGroup != len) || (byteCount > 16 - 4)
+                    || (groupLen < URI_IP4_TEXT_MIN_LEN)
+                    || (groupLen > URI_IP4_TEXT_MAX_LEN)
+                    || (uriParseIpFourPacked(bytes + byteCount, packed + pos, groupLen)
+                            != URI_SUCCESS)) {
+                return URI_ERROR_SYNTAX;
+            }
+            byteCount += 4;
+            break;
+        }
+
+        /* h16 */
+        if (((groupLen - 1) > 3) || (byteCount == 16)) {
+            return URI_ERROR_SYNTAX;
+        }
+        {
+            unsigned int value = 0;
+            unsigned int i;
+            for (i = pos; i < afterGroup; i++) {
+                /* '0'-'9' are 0x3?, 'A'-'F' are 0x4? and 'a'-'f' are 0x6? */
+                value = (value << 4) | ((packed[i] & 0x0f) + 9 * (packed[i] >> 6));
+            }
+            bytes[byteCount++] = (unsigned char)(value >> 8);
+            bytes[byteCount++] = (unsigned char)(value & 0xff);
+        }
+
+        if (afterGroup == len) {
+            break;
+        }
+        pos = afterGroup + 1;
+
+        if (packed[pos] == ':') {
+            /* "::" */
+            if (zipperEver) {
+                return URI_ERROR_SYNTAX;
+            }
+            zipperEver = 1;
+            zipperAt = byteCount;
+            pos++;
+        } else if (pos == len) {
+            /* Trailing single ":" */
+            return URI_ERROR_SYNTAX;
+        }
+    }
+
+    /* Eight groups in total, "::" standing in for at least one */
+    if (zipperEver ? (byteCount > 16 - 2) : (byteCount != 16)) {
+        return URI_ERROR_SYNTAX;
+    }
+
+    if (!zipperEver) {
+        memcpy(output, bytes, 16);
+    } else {
+        const unsigned int zeroCount = 16 - byteCount;
+        memcpy(output, bytes, zipperAt);
+        memset(output + zipperAt, 0, zeroCount);
+        memcpy(output + zipperAt + zeroCount, bytes + zipperAt, byteCount - zipperAt);
+    }
+    return URI_SUCCESS;
+}
@@ -72,6 +72,7 @@
 #endif
 
 #include <errno.h>
+#include <stdint.h> /* for uintptr_t */
 #include <stdlib.h>
 
 #ifndef URI_DOXYGEN
@@ -85,6 +86,9 @@
 
 #define URI_MALLOC_PADDING (URI_MALLOC_ALIGNMENT - sizeof(size_t))
 
+#define URI_ROUND_UP_TO_ALIGNMENT(size) \
+    ((((size) + URI_MALLOC_ALIGNMENT - 1) / URI_MALLOC_ALIGNMENT) * URI_MALLOC_ALIGNMENT)
+
 #define URI_CHECK_ALLOC_OVERFLOW(total_size, nmemb, size) \
     do { \
         /* check for unsigned overflow */ \
@@ -277,6 +281,417 @@ int uriCompleteMemoryManager(UriMemoryManager * memory, UriMemoryManager * backe
     return URI_SUCCESS;
 }
 
+typedef struct UriArenaChunkStruct {
+    struct UriArenaChunkStruct * next;
+    size_t size; /* usable bytes following the chunk header */
+} UriArenaChunk;
+
+#define URI_ARENA_CHUNK_HEADER URI_ROUND_UP_TO_ALIGNMENT(sizeof(UriArenaChunk))
+
+static UriBool uriArenaGrow(UriMemoryArena * arena, size_t minSize) {
+    UriArenaChunk * chunk;
+    const size_t size = URI_MAX(arena->chunkSize, minSize);
+
+    if (arena->chunkSize == 0) {
+        errno = ENOMEM;
+        return URI_FALSE;
+    }
+
+    /* check for unsigned overflow */
+    if (size > ((size_t)-1) - URI_ARENA_CHUNK_HEADER) {
+        errno = ENOMEM;
+        return URI_FALSE;
+    }
+
+    chunk = arena->backend->malloc(arena->backend, URI_ARENA_CHUNK_HEADER + size);
+    if (chunk == NULL) {
+        return URI_FALSE;
+    }
+
+    chunk->next = (UriArenaChunk *)arena->chunks;
+    chunk->size = size;
+    arena->chunks = chunk;
+
+    arena->cursor = (char *)chunk + URI_ARENA_CHUNK_HEADER;
+    arena->afterLast = arena->cursor + size;
+    return URI_TRUE;
+}
+
+static void * uriArenaMalloc(UriMemoryManager * memory, size_t size) {
+    UriMemoryArena * arena;
+    size_t roundedSize;
+    char * buffer;
+
+    if (memory == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    arena = (UriMemoryArena *)memory->userData;
+    if (arena == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    /* check for unsigned overflow */
+    if (size > ((size_t)-1) - 3 * URI_MALLOC_ALIGNMENT) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    /* Every allocation is preceded by a size header so that realloc
+     * knows how much to copy, and keeps the cursor aligned. */
+    roundedSize = URI_ROUND_UP_TO_ALIGNMENT(size);
+    if ((size_t)(arena->afterLast - arena->cursor) < URI_MALLOC_ALIGNMENT + roundedSize) {
+        if (uriArenaGrow(arena, URI_MALLOC_ALIGNMENT + roundedSize) == URI_FALSE) {
+            /* errno set by uriArenaGrow */
+            return NULL;
+        }
+    }
+
+    buffer = arena->cursor + URI_MALLOC_ALIGNMENT;
+    *(size_t *)(buffer - sizeof(size_t)) = size;
+    arena->cursor = buffer + roundedSize;
+    return buffer;
+}
+
+static void * uriArenaRealloc(UriMemoryManager * memory, void * ptr, size_t size) {
+    UriMemoryArena * arena;
+    size_t * sizeHeader;
+    size_t prevSize;
+    void * newBuffer;
+
+    if (memory == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    /* man realloc: "If ptr is NULL, then the call is equivalent to
+     * malloc(size), for *all* values of size" */
+    if (ptr == NULL) {
+        return memory->malloc(memory, size);
+    }
+
+    /* man realloc: "If size is equal to zero, and ptr is *not* NULL,
+     * then the call is equivalent to free(ptr)." */
+    if (size == 0) {
+        memory->free(memory, ptr);
+        return NULL;
+    }
+
+    sizeHeader = (size_t *)((char *)ptr - sizeof(size_t));
+    prevSize = *sizeHeader;
+
+    /* Anything to do? */
+    if (size <= prevSize) {
+        return ptr;
+    }
+
+    /* Grow in place if this is the most recent allocation */
+    arena = (UriMemoryArena *)memory->userData;
+    if ((arena != NULL) && (size <= ((size_t)-1) - 3 * URI_MALLOC_ALIGNMENT)
+            && ((char *)ptr + URI_ROUND_UP_TO_ALIGNMENT(prevSize) == arena->cursor)) {
+        const size_t extraBytes =
+                URI_ROUND_UP_TO_ALIGNMENT(size) - URI_ROUND_UP_TO_ALIGNMENT(prevSize);
+        if (extraBytes <= (size_t)(arena->afterLast - arena->cursor)) {
+            arena->cursor += extraBytes;
+            *sizeHeader = size;
+            return ptr;
+        }
+    }
+
+    newBuffer = memory->malloc(memory, size);
+    if (newBuffer == NULL) {
+        /* errno set by malloc */
+        return NULL;
+    }
+
+    memcpy(newBuffer, ptr, prevSize);
+
+    return newBuffer;
+}
+
+static void uriArenaFree(UriMemoryManager * URI_UNUSED(memory), void * URI_UNUSED(ptr)) {
+    /* Memory is reclaimed by uriResetMemoryArena and uriFreeMemoryArena */
+}
+
+int uriInitArenaMemoryManager(UriMemoryManager * memory, UriMemoryArena * arena,
+        void * buffer, size_t bufferSize, size_t chunkSize, UriMemoryManager * backend) {
+    if ((memory == NULL) || (arena == NULL)) {
+        return URI_ERROR_NULL;
+    }
+
+    /* Nothing to allocate from? */
+    if ((buffer == NULL) && (chunkSize == 0)) {
+        return URI_ERROR_NULL;
+    }
+
+    if (backend == NULL) {
+        backend = &defaultMemoryManager;
+    } else if ((backend->malloc == NULL) || (backend->free == NULL)) {
+        return URI_ERROR_MEMORY_MANAGER_INCOMPLETE;
+    }
+
+    arena->backend = backend;
+    arena->chunkSize = chunkSize;
+    arena->buffer = (char *)buffer;
+    arena->bufferSize = (buffer == NULL) ? 0 : bufferSize;
+    arena->chunks = NULL;
+
+    uriResetMemoryArena(arena);
+
+    memory->malloc = uriArenaMalloc;
+    memory->calloc = uriEmulateCalloc;
+    memory->realloc = uriArenaRealloc;
+    memory->reallocarray = uriEmulateReallocarray;
+    memory->free = uriArenaFree;
+
+    memory->userData = arena;
+
+    return URI_SUCCESS;
+}
+
+static void uriArenaReleaseChunks(UriMemoryArena * arena, UriBool keepMostRecent) {
+    UriArenaChunk * chunk = (UriArenaChunk *)arena->chunks;
+    UriArenaChunk * kept = NULL;
+
+    if ((keepMostRecent == URI_TRUE) && (chunk != NULL)) {
+        kept = chunk;
+        chunk = chunk->next;
+        kept->next = NULL;
+    }
+
+    while (chunk != NULL) {
+        UriArenaChunk * const next = chunk->next;
+        arena->backend->free(arena->backend, chunk);
+        chunk = next;
+    }
+
+    arena->chunks = kept;
+}
+
+int uriResetMemoryArena(UriMemoryArena * arena) {
+    UriArenaChunk * kept;
+
+    if (arena == NULL) {
+        return URI_ERROR_NULL;
+    }
+
+    /* Without a buffer of our own, hold on to the most recent chunk */
+    uriArenaReleaseChunks(arena, (arena->buffer == NULL) ? URI_TRUE : URI_FALSE);
+    kept = (UriArenaChunk *)arena->chunks;
+
+    if (kept != NULL) {
+        arena->cursor = (char *)kept + URI_ARENA_CHUNK_HEADER;
+        arena->afterLast = arena->cursor + kept->size;
+    } else if (arena->buffer != NULL) {
+        const size_t misalignment =
+                (size_t)((uintptr_t)arena->buffer % URI_MALLOC_ALIGNMENT);
+        const size_t skip = (misalignment == 0) ? 0 : URI_MALLOC_ALIGNMENT - misalignment;
+
+        arena->afterLast = arena->buffer + arena->bufferSize;
+        arena->cursor =
+                (skip < arena->bufferSize) ? arena->buffer + skip : arena->afterLast;
+    } else {
+        arena->cursor = NULL;
+        arena->afterLast = NULL;
+    }
+
+    return URI_SUCCESS;
+}
+
+void uriFreeMemoryArena(UriMemoryArena * arena) {
+    if (arena == NULL) {
+        return;
+    }
+
+    uriArenaReleaseChunks(arena, URI_FALSE);
+
+    arena->buffer = NULL;
+    arena->bufferSize = 0;
+    arena->cursor = NULL;
+    arena->afterLast = NULL;
+}
+
+/* Size class of an allocation of size bytes,
+ * URI_RECYCLER_CLASS_COUNT for allocations too large to recycle */
+static size_t uriRecyclerSizeClass(size_t size) {
+    if (size > URI_RECYCLER_CLASS_COUNT * URI_MALLOC_ALIGNMENT) {
+        return URI_RECYCLER_CLASS_COUNT;
+    }
+    return (size == 0) ? 0 : (size - 1) / URI_MALLOC_ALIGNMENT;
+}
+
+static void * uriRecyclerMalloc(UriMemoryManager * memory, size_t size) {
+    UriMemoryRecycler * recycler;
+    size_t sizeClass;
+    size_t bufferSize;
+    char * buffer;
+
+    if (memory == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    recycler = (UriMemoryRecycler *)memory->userData;
+    if (recycler == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    sizeClass = uriRecyclerSizeClass(size);
+    if (sizeClass < URI_RECYCLER_CLASS_COUNT) {
+        void ** const freeList = &recycler->freeLists[sizeClass];
+        if (*freeList != NULL) {
+            buffer = (char *)*freeList;
+            *freeList = *(void **)buffer;
+            *(size_t *)(buffer - sizeof(size_t)) = size;
+            return buffer;
+        }
+        /* Allocate for the whole size class to be reusable */
+        bufferSize = (sizeClass + 1) * URI_MALLOC_ALIGNMENT;
+    } else {
+        /* check for unsigned overflow */
+        if (size > ((size_t)-1) - URI_MALLOC_ALIGNMENT) {
+            errno = ENOMEM;
+            return NULL;
+        }
+        bufferSize = size;
+    }
+
+    buffer = (char *)recycler->backend->malloc(
+            recycler->backend, URI_MALLOC_ALIGNMENT + bufferSize);
+    if (buffer == NULL) {
+        return NULL;
+    }
+
+    buffer += URI_MALLOC_ALIGNMENT;
+    *(size_t *)(buffer - sizeof(size_t)) = size;
+    return buffer;
+}
+
+static void * uriRecyclerRealloc(UriMemoryManager * memory, void * ptr, size_t size) {
+    void * newBuffer;
+    size_t prevSize;
+
+    if (memory == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    /* man realloc: "If ptr is NULL, then the call is equivalent to
+     * malloc(size), for *all* values of size" */
+    if (ptr == NULL) {
+        return memory->malloc(memory, size);
+    }
+
+    /* man realloc: "If size is equal to zero, and ptr is *not* NULL,
+     * then the call is equivalent to free(ptr)." */
+    if (size == 0) {
+        memory->free(memory, ptr);
+        return NULL;
+    }
+
+    prevSize = *(size_t *)((char *)ptr - sizeof(size_t));
+
+    /* Anything to do? */
+    if (size <= prevSize) {
+        return ptr;
+    }
+
+    /* Still fits the size class allocated for? */
+    if (uriRecyclerSizeClass(size) == uriRecyclerSizeClass(prevSize)) {
+        if (uriRecyclerSizeClass(size) < URI_RECYCLER_CLASS_COUNT) {
+            *(size_t *)((char *)ptr - sizeof(size_t)) = size;
+            return ptr;
+        }
+    }
+
+    newBuffer = memory->malloc(memory, size);
+    if (newBuffer == NULL) {
+        /* errno set by malloc */
+        return NULL;
+    }
+
+    memcpy(newBuffer, ptr, prevSize);
+
+    memory->free(memory, ptr);
+
+    return newBuffer;
+}
+
+static void uriRecyclerFree(UriMemoryManager * memory, void * ptr) {
+    UriMemoryRecycler * recycler;
+    size_t sizeClass;
+
+    if ((ptr == NULL) || (memory == NULL)) {
+        return;
+    }
+
+    recycler = (UriMemoryRecycler *)memory->userData;
+    if (recycler == NULL) {
+        return;
+    }
+
+    sizeClass = uriRecyclerSizeClass(*(size_t *)((char *)ptr - sizeof(size_t)));
+    if (sizeClass < URI_RECYCLER_CLASS_COUNT) {
+        /* Keep for reuse, linked through its first bytes */
+        *(void **)ptr = recycler->freeLists[sizeClass];
+        recycler->freeLists[sizeClass] = ptr;
+        return;
+    }
+
+    recycler->backend->free(recycler->backend, (char *)ptr - URI_MALLOC_ALIGNMENT);
+}
+
+int uriInitRecyclingMemoryManager(UriMemoryManager * memory,
+        UriMemoryRecycler * recycler, UriMemoryManager * backend) {
+    size_t i;
+
+    if ((memory == NULL) || (recycler == NULL)) {
+        return URI_ERROR_NULL;
+    }
+
+    if (backend == NULL) {
+        backend = &defaultMemoryManager;
+    } else if ((backend->malloc == NULL) || (backend->free == NULL)) {
+        return URI_ERROR_MEMORY_MANAGER_INCOMPLETE;
+    }
+
+    recycler->backend = backend;
+    for (i = 0; i < URI_RECYCLER_CLASS_COUNT; i++) {
+        recycler->freeLists[i] = NULL;
+    }
+
+    memory->malloc = uriRecyclerMalloc;
+    memory->calloc = uriEmulateCalloc;
+    memory->realloc = uriRecyclerRealloc;
+    memory->reallocarray = uriEmulateReallocarray;
+    memory->free = uriRecyclerFree;
+
+    memory->userData = recycler;
+
+    return URI_SUCCESS;
+}
+
+void uriFreeMemoryRecycler(UriMemoryRecycler * recycler) {
+    size_t i;
+
+    if (recycler == NULL) {
+        return;
+    }
+
+    for (i = 0; i < URI_RECYCLER_CLASS_COUNT; i++) {
+        char * buffer = (char *)recycler->freeLists[i];
+        while (buffer != NULL) {
+            char * const next = (char *)*(void **)buffer;
+            recycler->backend->free(recycler->backend, buffer - URI_MALLOC_ALIGNMENT);
+            buffer = next;
+        }
+        recycler->freeLists[i] = NULL;
+    }
+}
+
 /* mull-off */
 int uriTestMemoryManagerEx(UriMemoryManager * memory, UriBool challengeAlignment) {
     const size_t mallocSize = 7;
@@ -95,6 +95,8 @@ static UriBool URI_FUNC(ContainsUppercaseLetters)(
         const URI_CHAR * first, const URI_CHAR * afterLast);
 static UriBool URI_FUNC(ContainsUglyPercentEncoding)(
         const URI_CHAR * first, const URI_CHAR * afterLast);
+static UriBool URI_FUNC(PathTextNeedsNormalization)(
+        const URI_CHAR * first, const URI_CHAR * afterLastText);
 
 static void URI_FUNC(LowercaseInplace)(
         const URI_CHAR * first, const URI_CHAR * afterLast);
@@ -150,7 +152,7 @@ void URI_FUNC(PreventLeakage)(
             if (walker->text.afterLast > walker->text.first) {
                 memory->free(memory, (URI_CHAR *)walker->text.first);
             }
-            memory->free(memory, walker);
+            URI_FUNC(FreePathSegment)(uri, walker, memory);
             walker = next;
         }
         uri->pathHead = NULL;
@@ -215,6 +217,37 @@ static URI_INLINE UriBool URI_FUNC(ContainsUglyPercentEncoding)(
     return URI_FALSE;
 }
 
+/* Checks the text of a path segment for dot segments and ugly
+ * percent-encoding. NOTE: The raw path of a URI parsed by
+ * ParseSingleUriExLazyMm is a single path segment with slashes,
+ * so the text is looked at slash-separated piece by piece. */
+static UriBool URI_FUNC(PathTextNeedsNormalization)(
+        const URI_CHAR * first, const URI_CHAR * afterLastText) {
+    if ((first == NULL) || (afterLastText == NULL)) {
+        return URI_FALSE;
+    }
+
+    for (;;) {
+        const URI_CHAR * afterLast = first;
+        while ((afterLast < afterLastText) && (afterLast[0] != _UT('/'))) {
+            afterLast++;
+        }
+
+        if ((afterLast > first)
+                && ((((afterLast - first) == 1) && (first[0] == _UT('.')))
+                        || (((afterLast - first) == 2) && (first[0] == _UT('.'))
+                                && (first[1] == _UT('.')))
+                        || URI_FUNC(ContainsUglyPercentEncoding)(first, afterLast))) {
+            return URI_TRUE;
+        }
+
+        if (afterLast >= afterLastText) {
+            return URI_FALSE;
+        }
+        first = afterLast + 1;
+    }
+}
+
 static URI_INLINE void URI_FUNC(LowercaseInplace)(
         const URI_CHAR * first, const URI_CHAR * afterLast) {
     if ((first != NULL) && (afterLast != NULL) && (afterLast > first)) {
@@ -434,14 +467,14 @@ static URI_INLINE UriBool URI_FUNC(MakeOwnerEngine)(
                             && (ranger->text.afterLast > ranger->text.first)) {
                         memory->free(memory, (URI_CHAR *)ranger->text.first);
                     }
-                    memory->free(memory, ranger);
+                    URI_FUNC(FreePathSegment)(uri, ranger, memory);
                     ranger = next;
                 }
 
                 /* Kill path from walker */
                 while (walker != NULL) {
                     URI_TYPE(PathSegment) * const next = walker->next;
-                    memory->free(memory, walker);
+                    URI_FUNC(FreePathSegment)(uri, walker, memory);
                     walker = next;
                 }
 
@@ -506,6 +539,9 @@ int URI_FUNC(NormalizeSyntaxEx)(URI_TYPE(Uri) * uri, unsigned int mask) {
 int URI_FUNC(NormalizeSyntaxExMm)(
         URI_TYPE(Uri) * uri, unsigned int mask, UriMemoryManager * memory) {
     URI_CHECK_MEMORY_MANAGER(memory); /* may return */
+    if ((mask & URI_NORMALIZE_PATH) && !URI_FUNC(MaterializePath)(uri, memory)) {
+        return URI_ERROR_MALLOC;
+    }
     return URI_FUNC(NormalizeSyntaxEngine)(uri, mask, NULL, memory);
 }
 
@@ -721,13 +757,8 @@ static URI_INLINE int URI_FUNC(NormalizeSyntaxEngine)(URI_TYPE(Uri) * uri,
     if (outMask != NULL) {
         const URI_TYPE(PathSegment) * walker = uri->pathHead;
         while (walker != NULL) {
-            const URI_CHAR * const first = walker->text.first;
-            const URI_CHAR * const afterLast = walker->text.afterLast;
-            if ((first != NULL) && (afterLast != NULL) && (afterLast > first)
-                    && ((((afterLast - first) == 1) && (first[0] == _UT('.')))
-                            || (((afterLast - first) == 2) && (first[0] == _UT('.'))
-                                    && (first[1] == _UT('.')))
-                            || URI_FUNC(ContainsUglyPercentEncoding)(first, afterLast))) {
+            if (URI_FUNC(PathTextNeedsNormalization)(
+                        walker->text.first, walker->text.afterLast)) {
                 *outMask |= URI_NORMALIZE_PATH;
                 break;
             }
@@ -68,12 +68,20 @@
 #  ifndef URI_DOXYGEN
 #    include <uriparser/Uri.h>
 #    include <uriparser/UriIp4.h>
+#    include "UriCharClass.h"
 #    include "UriCommon.h"
+#    include "UriIp6Base.h"
 #    include "UriMemory.h"
 #    include "UriParseBase.h"
 #    include "UriSets.h"
 #  endif
 
+/*
+ * NOTE: There is one function per grammar rule below. Rules only ever call
+ *       rules further down the grammar, and repetitions are loops
+ *       (see SkipCharClass and the tail_call labels), so stack use
+ *       does not grow with the length of the input. Please keep it that way.
+ */
 static const URI_CHAR * URI_FUNC(ParseAuthority)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
 static const URI_CHAR * URI_FUNC(ParseAuthorityTwo)(URI_TYPE(ParserState) * state,
@@ -112,12 +120,11 @@ static const URI_CHAR * URI_FUNC(ParsePchar)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
 static const URI_CHAR * URI_FUNC(ParsePctEncoded)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
-static const URI_CHAR * URI_FUNC(ParsePctSubUnres)(URI_TYPE(ParserState) * state,
-        const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
 static const URI_CHAR * URI_FUNC(ParsePort)(
         const URI_CHAR * first, const URI_CHAR * afterLast);
 static const URI_CHAR * URI_FUNC(ParseQueryFrag)(URI_TYPE(ParserState) * state,
-        const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
+        const URI_CHAR * first, const URI_CHAR * afterLast, UriBool isQuery,
+        UriMemoryManager * memory);
 static const URI_CHAR * URI_FUNC(ParseSegment)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
 static const URI_CHAR * URI_FUNC(ParseSegmentNz)(URI_TYPE(ParserState) * state,
@@ -147,6 +154,8 @@ static void URI_FUNC(ResetParserStateExceptUri)(URI_TYPE(ParserState) * state);
 
 static UriBool URI_FUNC(PushPathSegment)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
+static URI_TYPE(PathSegmentBlock) * URI_FUNC(EnsureFlatPathBlock)(
+        URI_TYPE(ParserState) * state, const URI_CHAR * first, UriMemoryManager * memory);
 
 static void URI_FUNC(StopSyntax)(URI_TYPE(ParserState) * state, const URI_CHAR * errorPos,
         UriMemoryManager * memory);
@@ -154,22 +163,253 @@ static void URI_FUNC(StopMalloc)(
         URI_TYPE(ParserState) * state, UriMemoryManager * memory);
 
 static int URI_FUNC(ParseUriExMm)(URI_TYPE(ParserState) * state, const URI_CHAR * first,
-        const URI_CHAR * afterLast, UriMemoryManager * memory);
+        const URI_CHAR * afterLast, unsigned int flags, UriMemoryManager * memory);
+
+/* NOTE: Flags of public UriParseOptions are passed through as is */
+#  ifndef URI_PARSE_CONTEXT_FLAGS
+#    define URI_PARSE_CONTEXT_FLAGS 1
+#    define URI_PARSE_FLAT_PATH 0x100 /* store path segments in a single block */
+#    define URI_PARSE_VALIDATE_ONLY 0x200 /* check syntax, build and allocate nothing */
+#    define URI_PARSE_LAZY_PATH URI_PARSE_RAW_PATH_ONLY /* raw path as one segment */
+#    define URI_PARSE_INLINE_BLOCK 0x400 /* keep the block at .reserved of the URI */
+#  endif
+
+/*
+ * Settings of a parse beyond what the public parser state holds,
+ * referenced from state->reserved for the duration of a parse.
+ */
+typedef struct URI_TYPE(ParseContextStruct) {
+    unsigned int flags; /* URI_PARSE_* */
+    const URI_CHAR * afterLast; /* end of input */
+    UriIp6 ip6Scratch; /* IPv6 output when validating only or skipping host data */
+    const URI_CHAR * afterAuthority; /* end of authority once parsed, else NULL */
+} URI_TYPE(ParseContext);
+
+static URI_INLINE UriBool URI_FUNC(HasParseFlag)(
+        const URI_TYPE(ParserState) * state, unsigned int flag) {
+    const URI_TYPE(ParseContext) * const context = state->reserved;
+    return ((context != NULL) && ((context->flags & flag) != 0)) ? URI_TRUE : URI_FALSE;
+}
+
+/*
+ * Unhooks IPv6 scratch output from the URI, so that it is neither
+ * handed out nor freed as host data.
+ */
+static URI_INLINE void URI_FUNC(DropScratchHostData)(URI_TYPE(ParserState) * state) {
+    const URI_TYPE(ParseContext) * const context = state->reserved;
+    if ((context != NULL) && (state->uri->hostData.ip6 == &context->ip6Scratch)) {
+        state->uri->hostData.ip6 = NULL;
+    }
+}
 
 static URI_INLINE void URI_FUNC(StopSyntax)(URI_TYPE(ParserState) * state,
         const URI_CHAR * errorPos, UriMemoryManager * memory) {
-    URI_FUNC(FreeUriMembersMm)(state->uri, memory);
+    URI_FUNC(DropScratchHostData)(state);
+    if (!URI_FUNC(HasParseFlag)(
+                state, URI_PARSE_VALIDATE_ONLY | URI_PARSE_KEEP_PARTIAL)) {
+        URI_FUNC(FreeUriMembersMm)(state->uri, memory);
+    }
     state->errorPos = errorPos;
     state->errorCode = URI_ERROR_SYNTAX;
 }
 
 static URI_INLINE void URI_FUNC(StopMalloc)(
         URI_TYPE(ParserState) * state, UriMemoryManager * memory) {
-    URI_FUNC(FreeUriMembersMm)(state->uri, memory);
+    URI_FUNC(DropScratchHostData)(state);
+    if (!URI_FUNC(HasParseFlag)(state, URI_PARSE_VALIDATE_ONLY)) {
+        URI_FUNC(FreeUriMembersMm)(state->uri, memory);
+    }
     state->errorPos = NULL;
     state->errorCode = URI_ERROR_MALLOC;
 }
 
+/*
+ * Makes IPv4 and IPv6 host data go to flat path segment storage
+ * when parsing flat, see AllocateHostIp4; first is the position
+ * to count the path segments left to parse from.
+ */
+static UriBool URI_FUNC(PrepareHostData)(URI_TYPE(ParserState) * state,
+        const URI_CHAR * first, UriMemoryManager * memory) {
+    if (!URI_FUNC(HasParseFlag)(state, URI_PARSE_FLAT_PATH)) {
+        return URI_TRUE;
+    }
+    return (URI_FUNC(EnsureFlatPathBlock)(state, first, memory) != NULL) ? URI_TRUE
+                                                                          : URI_FALSE;
+}
+
+/*
+ * Fills in host data for a host that may be an IPv4 address
+ * or a registered name.
+ */
+static URI_INLINE UriBool URI_FUNC(DetectHostIp4)(
+        URI_TYPE(ParserState) * state, UriMemoryManager * memory) {
+    if (URI_FUNC(HasParseFlag)(
+                state, URI_PARSE_VALIDATE_ONLY | URI_PARSE_SKIP_HOST_DATA)) {
+        return URI_TRUE;
+    }
+
+    /* Valid IPv4 or just a regname? */
+    UriIp4 ip4;
+    if (URI_FUNC(ParseIpFourAddress)(
+                ip4.data, state->uri->hostText.first, state->uri->hostText.afterLast)) {
+        return URI_TRUE; /* Not IPv4 */
+    }
+
+    if (!URI_FUNC(PrepareHostData)(state, state->uri->hostText.afterLast, memory)) {
+        return URI_FALSE; /* Raises malloc error */
+    }
+    state->uri->hostData.ip4 = URI_FUNC(AllocateHostIp4)(
+            state->uri, memory); /* Freed when stopping on parse error */
+    if (state->uri->hostData.ip4 == NULL) {
+        return URI_FALSE; /* Raises malloc error */
+    }
+    *(state->uri->hostData.ip4) = ip4;
+    return URI_TRUE; /* Success */
+}
+
+/*
+ * Skips a run of characters that are all in character class(es) mask,
+ * see UriCharClass.h.
+ */
+static URI_INLINE const URI_CHAR * URI_FUNC(SkipCharClass)(
+        const URI_CHAR * first, const URI_CHAR * afterLast, unsigned int mask) {
+#  ifdef URI_PASS_ANSI
+    /* Long path segments, queries and fragments go block by block first */
+    if (((mask == URI_CLASS_PCHAR) || (mask == URI_CLASS_QUERY_FRAG))
+            && (afterLast - first >= 16)) {
+        first = uriSkipCharClassBlocks(first, afterLast, mask);
+    }
+#  endif
+
+    while ((first < afterLast) && URI_CHAR_IS(*first, mask)) {
+        first++;
+    }
+    return first;
+}
+
+/*
+ * Is code point a ucschar of RFC 3987, or with withPrivate
+ * (which is for queries only), an iprivate?
+ */
+static URI_INLINE UriBool URI_FUNC(IsIriCodePoint)(
+        unsigned long codePoint, UriBool withPrivate) {
+    if (((codePoint >= 0xA0) && (codePoint <= 0xD7FF))
+            || ((codePoint >= 0xF900) && (codePoint <= 0xFDCF))
+            || ((codePoint >= 0xFDF0) && (codePoint <= 0xFFEF))) {
+        return URI_TRUE;
+    }
+
+    /* Planes 1 to 14 except for the last two code points of each plane,
+     * and the first 4096 code points of plane 14 */
+    if ((codePoint >= 0x10000) && (codePoint <= 0xEFFFD)) {
+        return (((codePoint & 0xFFFF) <= 0xFFFD)
+                       && ((codePoint < 0xE0000) || (codePoint >= 0xE1000)))
+                       ? URI_TRUE
+                       : URI_FALSE;
+    }
+
+    if (withPrivate) {
+        return (((codePoint >= 0xE000) && (codePoint <= 0xF8FF))
+                       || ((codePoint >= 0xF0000) && (codePoint <= 0x10FFFD)
+                               && ((codePoint & 0xFFFF) <= 0xFFFD)))
+                       ? URI_TRUE
+                       : URI_FALSE;
+    }
+
+    return URI_FALSE;
+}
+
+/*
+ * Skips a single ucschar (or iprivate) of RFC 3987 at first, if any,
+ * encoded as UTF-8 with char and as UTF-16 or UTF-32 with wchar_t.
+ * Returns first for anything else, including malformed and overlong UTF-8.
+ */
+static const URI_CHAR * URI_FUNC(SkipIriChar)(
+        const URI_CHAR * first, const URI_CHAR * afterLast, UriBool withPrivate) {
+    unsigned long codePoint;
+    ptrdiff_t length;
+
+#  ifdef URI_PASS_ANSI
+    const unsigned char lead = (unsigned char)first[0];
+    if (lead < 0xC2) {
+        return first; /* ASCII, continuation byte or overlong lead byte */
+    } else if (lead < 0xE0) {
+        codePoint = lead & 0x1F;
+        length = 2;
+    } else if (lead < 0xF0) {
+        codePoint = lead & 0x0F;
+        length = 3;
+    } else if (lead < 0xF5) {
+        codePoint = lead & 0x07;
+        length = 4;
+    } else {
+        return first;
+    }
+
+    if (afterLast - first < length) {
+        return first;
+    }
+
+    for (ptrdiff_t i = 1; i < length; i++) {
+        const unsigned char trail = (unsigned char)first[i];
+        if ((trail & 0xC0) != 0x80) {
+            return first;
+        }
+        codePoint = (codePoint << 6) | (trail & 0x3F);
+    }
+
+    if (((length == 3) && (codePoint < 0x800))
+            || ((length == 4) && (codePoint < 0x10000))) {
+        return first; /* overlong */
+    }
+#  else
+    codePoint = (unsigned long)first[0];
+    length = 1;
+    if ((codePoint >= 0xD800) && (codePoint <= 0xDBFF) && (afterLast - first >= 2)
+            && ((unsigned long)first[1] >= 0xDC00)
+            && ((unsigned long)first[1] <= 0xDFFF)) {
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10)
+                + ((unsigned long)first[1] - 0xDC00);
+        length = 2;
+    }
+#  endif
+
+    return URI_FUNC(IsIriCodePoint)(codePoint, withPrivate) ? first + length : first;
+}
+
+/*
+ * Like SkipCharClass, but with URI_PARSE_IRI also skipping
+ * the ucschar characters RFC 3987 adds to classes of RFC 3986.
+ */
+static URI_INLINE const URI_CHAR * URI_FUNC(SkipCharClassIri)(
+        const URI_TYPE(ParserState) * state, const URI_CHAR * first,
+        const URI_CHAR * afterLast, unsigned int mask, UriBool withPrivate) {
+    for (;;) {
+        first = URI_FUNC(SkipCharClass)(first, afterLast, mask);
+        if ((first >= afterLast) || !URI_FUNC(HasParseFlag)(state, URI_PARSE_IRI)) {
+            return first;
+        }
+
+        const URI_CHAR * const afterIriChar =
+                URI_FUNC(SkipIriChar)(first, afterLast, withPrivate);
+        if (afterIriChar == first) {
+            return first;
+        }
+        first = afterIriChar;
+    }
+}
+
+/*
+ * Does a ucschar of RFC 3987 start at first, with URI_PARSE_IRI?
+ */
+static URI_INLINE UriBool URI_FUNC(StartsIriChar)(const URI_TYPE(ParserState) * state,
+        const URI_CHAR * first, const URI_CHAR * afterLast) {
+    return (URI_FUNC(HasParseFlag)(state, URI_PARSE_IRI)
+                   && (URI_FUNC(SkipIriChar)(first, afterLast, URI_FALSE) != first))
+                   ? URI_TRUE
+                   : URI_FALSE;
+}
+
 /*
  * [authority]-><[>[ipLit2][authorityTwo]
  * [authority]->[ownHostUserInfoNz]
@@ -200,6 +440,11 @@ static URI_INLINE const URI_CHAR * URI_FUNC(ParseAuthority)(URI_TYPE(ParserState
         return URI_FUNC(ParseOwnHostUserInfoNz)(state, first, afterLast, memory);
 
     default:
+        if (URI_FUNC(StartsIriChar)(state, first, afterLast)) {
+            state->uri->userInfo.first = first; /* USERINFO BEGIN */
+            return URI_FUNC(ParseOwnHostUserInfoNz)(state, first, afterLast, memory);
+        }
+
         /* "" regname host */
         state->uri->hostText.first = URI_FUNC(SafeToPointTo);
         state->uri->hostText.afterLast = URI_FUNC(SafeToPointTo);
@@ -240,19 +485,7 @@ static URI_INLINE const URI_CHAR * URI_FUNC(ParseAuthorityTwo)(
  */
 static const URI_CHAR * URI_FUNC(ParseHexZero)(
         const URI_CHAR * first, const URI_CHAR * afterLast) {
-tail_call:
-    if (first >= afterLast) {
-        return afterLast;
-    }
-
-    switch (*first) {
-    case URI_SET_HEXDIG(_UT):
-        first += 1;
-        goto tail_call;
-
-    default:
-        return first;
-    }
+    return URI_FUNC(SkipCharClass)(first, afterLast, URI_CLASS_HEXDIG);
 }
 
 /*
@@ -274,6 +507,9 @@ static URI_INLINE const URI_CHAR * URI_FUNC(ParseHierPart)(URI_TYPE(ParserState)
         return URI_FUNC(ParsePartHelperTwo)(state, first + 1, afterLast, memory);
 
     default:
+        if (URI_FUNC(StartsIriChar)(state, first, afterLast)) {
+            return URI_FUNC(ParsePathRootless)(state, first, afterLast, memory);
+        }
         return first;
     }
 }
@@ -290,21 +526,9 @@ static const URI_CHAR * URI_FUNC(ParseIpFutLoop)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory) {
     const URI_CHAR * const originalFirst = first;
 
-    while (first < afterLast) {
-        switch (*first) {
-        case _UT(':'):
-        case URI_SET_SUB_DELIMS(_UT):
-        case URI_SET_UNRESERVED(_UT):
-            first += 1;
-            break;
+    /* NOTE: Class userinfo is exactly unreserved, sub-delims and ":" */
+    first = URI_FUNC(SkipCharClass)(first, afterLast, URI_CLASS_USERINFO);
 
-        default:
-            goto done_looping;
-            break;
-        }
-    }
-
-done_looping:
     if (first == originalFirst) {
         URI_FUNC(StopSyntax)(state, first, memory);
         return NULL;
@@ -353,14 +577,11 @@ static const URI_CHAR * URI_FUNC(ParseIpFuture)(URI_TYPE(ParserState) * state,
             return NULL;
         }
         state->uri->hostText.first = first; /* HOST BEGIN */
-        state->uri->hostData.ipFuture.first = first; /* IPFUTURE BEGIN */
         afterIpFutLoop =
                 URI_FUNC(ParseIpFutLoop)(state, afterHexZero + 1, afterLast, memory);
         if (afterIpFutLoop == NULL) {
             return NULL;
         }
-        state->uri->hostText.afterLast = afterIpFutLoop; /* HOST END */
-        state->uri->hostData.ipFuture.afterLast = afterIpFutLoop; /* IPFUTURE END */
         return afterIpFutLoop;
     }
 
@@ -405,18 +626,49 @@ static URI_INLINE const URI_CHAR * URI_FUNC(ParseIpLit2)(URI_TYPE(ParserState) *
             URI_FUNC(StopSyntax)(state, afterIpFuture, memory);
             return NULL;
         }
+        /* Only now that "]" is there, so that URI_PARSE_KEEP_PARTIAL
+         * does not take an unclosed literal for a complete host */
+        state->uri->hostText.afterLast = afterIpFuture; /* HOST END */
+        state->uri->hostData.ipFuture = state->uri->hostText; /* IPFUTURE */
         return afterIpFuture + 1;
     }
 
     case _UT(':'):
     case _UT(']'):
     case URI_SET_HEXDIG(_UT):
-        state->uri->hostData.ip6 = memory->malloc(
-                memory, 1 * sizeof(UriIp6)); /* Freed when stopping on parse error */
+        if (URI_FUNC(HasParseFlag)(
+                    state, URI_PARSE_VALIDATE_ONLY | URI_PARSE_SKIP_HOST_DATA)) {
+            URI_TYPE(ParseContext) * const context = state->reserved;
+            state->uri->hostData.ip6 = &context->ip6Scratch;
+        } else if (URI_FUNC(PrepareHostData)(state, first, memory)) {
+            state->uri->hostData.ip6 = URI_FUNC(AllocateHostIp6)(
+                    state->uri, memory); /* Freed when stopping on parse error */
+        }
         if (state->uri->hostData.ip6 == NULL) {
             URI_FUNC(StopMalloc)(state, memory);
             return NULL;
         }
+
+        /* Fast path for well-formed input; the state machine below
+         * is left to pinpoint the position of syntax errors. */
+        {
+            const URI_CHAR * closing = first;
+            const URI_CHAR * const afterClosingMax =
+                    (afterLast - first > URI_IP6_TEXT_MAX_LEN)
+                            ? first + URI_IP6_TEXT_MAX_LEN + 1
+                            : afterLast;
+            while ((closing < afterClosingMax) && (*closing != _UT(']'))) {
+                closing++;
+            }
+            if ((closing < afterClosingMax)
+                    && (URI_FUNC(ParseIpSixText)(
+                                state->uri->hostData.ip6->data, first, closing)
+                            == URI_SUCCESS)) {
+                state->uri->hostText.afterLast = closing; /* HOST END */
+                return closing + 1;
+            }
+        }
+
         return URI_FUNC(ParseIPv6address2)(state, first, afterLast, memory);
 
     default:
@@ -733,6 +985,9 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(URI_TYPE(ParserState) * stat
 static const URI_CHAR * URI_FUNC(ParseMustBeSegmentNzNc)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory) {
 tail_call:
+    first = URI_FUNC(SkipCharClassIri)(state, first, afterLast,
+            URI_CLASS_UNRESERVED | URI_CLASS_SUB_DELIMS, URI_FALSE);
+
     if (first >= afterLast) {
         if (!URI_FUNC(PushPathSegment)(
                     state, state->uri->scheme.first, first, memory)) { /* SEGMENT BOTH */
@@ -755,8 +1010,6 @@ tail_call:
     }
 
     case _UT('@'):
-    case URI_SET_SUB_DELIMS(_UT):
-    case URI_SET_UNRESERVED(_UT):
         first += 1;
         goto tail_call;
 
@@ -828,19 +1081,7 @@ static URI_INLINE UriBool URI_FUNC(OnExitOwnHost2)(URI_TYPE(ParserState) * state
         const URI_CHAR * first, UriMemoryManager * memory) {
     state->uri->hostText.afterLast = first; /* HOST END */
 
-    /* Valid IPv4 or just a regname? */
-    state->uri->hostData.ip4 = memory->malloc(
-            memory, 1 * sizeof(UriIp4)); /* Freed when stopping on parse error */
-    if (state->uri->hostData.ip4 == NULL) {
-        return URI_FALSE; /* Raises malloc error */
-    }
-    if (URI_FUNC(ParseIpFourAddress)(state->uri->hostData.ip4->data,
-                state->uri->hostText.first, state->uri->hostText.afterLast)) {
-        /* Not IPv4 */
-        memory->free(memory, state->uri->hostData.ip4);
-        state->uri->hostData.ip4 = NULL;
-    }
-    return URI_TRUE; /* Success */
+    return URI_FUNC(DetectHostIp4)(state, memory);
 }
 
 /*
@@ -850,6 +1091,9 @@ static URI_INLINE UriBool URI_FUNC(OnExitOwnHost2)(URI_TYPE(ParserState) * state
 static const URI_CHAR * URI_FUNC(ParseOwnHost2)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory) {
 tail_call:
+    first = URI_FUNC(SkipCharClassIri)(state, first, afterLast,
+            URI_CLASS_UNRESERVED | URI_CLASS_SUB_DELIMS, URI_FALSE);
+
     if (first >= afterLast) {
         if (!URI_FUNC(OnExitOwnHost2)(state, first, memory)) {
             URI_FUNC(StopMalloc)(state, memory);
@@ -859,15 +1103,13 @@ tail_call:
     }
 
     switch (*first) {
-    case _UT('%'):
-    case URI_SET_SUB_DELIMS(_UT):
-    case URI_SET_UNRESERVED(_UT): {
-        const URI_CHAR * const afterPctSubUnres =
-                URI_FUNC(ParsePctSubUnres)(state, first, afterLast, memory);
-        if (afterPctSubUnres == NULL) {
+    case _UT('%'): {
+        const URI_CHAR * const afterPctEncoded =
+                URI_FUNC(ParsePctEncoded)(state, first, afterLast, memory);
+        if (afterPctEncoded == NULL) {
             return NULL;
         }
-        first = afterPctSubUnres;
+        first = afterPctEncoded;
         goto tail_call;
     }
 
@@ -887,19 +1129,7 @@ static URI_INLINE UriBool URI_FUNC(OnExitOwnHostUserInfo)(URI_TYPE(ParserState)
     state->uri->userInfo.first = NULL; /* Not a userInfo, reset */
     state->uri->hostText.afterLast = first; /* HOST END */
 
-    /* Valid IPv4 or just a regname? */
-    state->uri->hostData.ip4 = memory->malloc(
-            memory, 1 * sizeof(UriIp4)); /* Freed when stopping on parse error */
-    if (state->uri->hostData.ip4 == NULL) {
-        return URI_FALSE; /* Raises malloc error */
-    }
-    if (URI_FUNC(ParseIpFourAddress)(state->uri->hostData.ip4->data,
-                state->uri->hostText.first, state->uri->hostText.afterLast)) {
-        /* Not IPv4 */
-        memory->free(memory, state->uri->hostData.ip4);
-        state->uri->hostData.ip4 = NULL;
-    }
-    return URI_TRUE; /* Success */
+    return URI_FUNC(DetectHostIp4)(state, memory);
 }
 
 /*
@@ -915,26 +1145,19 @@ static const URI_CHAR * URI_FUNC(ParseOwnHostUserInfoNz)(URI_TYPE(ParserState) *
     const URI_CHAR * const originalFirst = first;
 
     while (first < afterLast) {
-        switch (*first) {
-        case _UT('%'):
-        case URI_SET_SUB_DELIMS(_UT):
-        case URI_SET_UNRESERVED(_UT): {
-            const URI_CHAR * const afterPctSubUnres =
-                    URI_FUNC(ParsePctSubUnres)(state, first, afterLast, memory);
-            if (afterPctSubUnres == NULL) {
-                return NULL;
-            }
-            first = afterPctSubUnres;
+        first = URI_FUNC(SkipCharClassIri)(state, first, afterLast,
+                URI_CLASS_UNRESERVED | URI_CLASS_SUB_DELIMS, URI_FALSE);
+
+        if ((first >= afterLast) || (*first != _UT('%'))) {
             break;
         }
 
-        default:
-            goto done_looping;
-            break;
+        first = URI_FUNC(ParsePctEncoded)(state, first, afterLast, memory);
+        if (first == NULL) {
+            return NULL;
         }
     }
 
-done_looping:
     if (first < afterLast) {
         switch (*first) {
         case _UT(':'):
@@ -972,19 +1195,7 @@ static URI_INLINE UriBool URI_FUNC(OnExitOwnPortUserInfo)(URI_TYPE(ParserState)
     state->uri->userInfo.first = NULL; /* Not a userInfo, reset */
     state->uri->portText.afterLast = first; /* PORT END */
 
-    /* Valid IPv4 or just a regname? */
-    state->uri->hostData.ip4 = memory->malloc(
-            memory, 1 * sizeof(UriIp4)); /* Freed when stopping on parse error */
-    if (state->uri->hostData.ip4 == NULL) {
-        return URI_FALSE; /* Raises malloc error */
-    }
-    if (URI_FUNC(ParseIpFourAddress)(state->uri->hostData.ip4->data,
-                state->uri->hostText.first, state->uri->hostText.afterLast)) {
-        /* Not IPv4 */
-        memory->free(memory, state->uri->hostData.ip4);
-        state->uri->hostData.ip4 = NULL;
-    }
-    return URI_TRUE; /* Success */
+    return URI_FUNC(DetectHostIp4)(state, memory);
 }
 
 /*
@@ -1002,7 +1213,8 @@ static URI_INLINE UriBool URI_FUNC(OnExitOwnPortUserInfo)(URI_TYPE(ParserState)
  */
 static const URI_CHAR * URI_FUNC(ParseOwnPortUserInfo)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory) {
-tail_call:
+    first = URI_FUNC(SkipCharClass)(first, afterLast, URI_CLASS_DIGIT);
+
     if (first >= afterLast) {
         if (!URI_FUNC(OnExitOwnPortUserInfo)(state, first, memory)) {
             URI_FUNC(StopMalloc)(state, memory);
@@ -1025,10 +1237,6 @@ tail_call:
         state->uri->portText.first = NULL; /* Not a port, reset */
         return URI_FUNC(ParseOwnUserInfo)(state, first + 1, afterLast, memory);
 
-    case URI_SET_DIGIT(_UT):
-        first += 1;
-        goto tail_call;
-
     case _UT('%'):
         state->uri->portText.first = NULL; /* Not a port, reset */
         const URI_CHAR * const afterPct =
@@ -1046,6 +1254,12 @@ tail_call:
         return URI_FUNC(ParseOwnHost)(state, first + 1, afterLast, memory);
 
     default:
+        if (URI_FUNC(StartsIriChar)(state, first, afterLast)) {
+            state->uri->hostText.afterLast = NULL; /* Not a host, reset */
+            state->uri->portText.first = NULL; /* Not a port, reset */
+            return URI_FUNC(ParseOwnUserInfo)(state, first, afterLast, memory);
+        }
+
         if (!URI_FUNC(OnExitOwnPortUserInfo)(state, first, memory)) {
             URI_FUNC(StopMalloc)(state, memory);
             return NULL;
@@ -1062,28 +1276,26 @@ tail_call:
 static const URI_CHAR * URI_FUNC(ParseOwnUserInfo)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory) {
 tail_call:
+    /* NOTE: Class userinfo is exactly unreserved, sub-delims and ":" */
+    first = URI_FUNC(SkipCharClassIri)(
+            state, first, afterLast, URI_CLASS_USERINFO, URI_FALSE);
+
     if (first >= afterLast) {
         URI_FUNC(StopSyntax)(state, afterLast, memory);
         return NULL;
     }
 
     switch (*first) {
-    case _UT('%'):
-    case URI_SET_SUB_DELIMS(_UT):
-    case URI_SET_UNRESERVED(_UT): {
-        const URI_CHAR * const afterPctSubUnres =
-                URI_FUNC(ParsePctSubUnres)(state, first, afterLast, memory);
-        if (afterPctSubUnres == NULL) {
+    case _UT('%'): {
+        const URI_CHAR * const afterPctEncoded =
+                URI_FUNC(ParsePctEncoded)(state, first, afterLast, memory);
+        if (afterPctEncoded == NULL) {
             return NULL;
         }
-        first = afterPctSubUnres;
+        first = afterPctEncoded;
         goto tail_call;
     }
 
-    case _UT(':'):
-        first += 1;
-        goto tail_call;
-
     case _UT('@'):
         /* SURE */
         state->uri->userInfo.afterLast = first; /* USERINFO END */
@@ -1120,6 +1332,10 @@ static URI_INLINE const URI_CHAR * URI_FUNC(ParsePartHelperTwo)(
         if (afterAuthority == NULL) {
             return NULL;
         }
+        if (state->reserved != NULL) {
+            URI_TYPE(ParseContext) * const context = state->reserved;
+            context->afterAuthority = afterAuthority;
+        }
         afterPathAbsEmpty =
                 URI_FUNC(ParsePathAbsEmpty)(state, afterAuthority, afterLast, memory);
 
@@ -1193,6 +1409,9 @@ static URI_INLINE const URI_CHAR * URI_FUNC(ParsePathAbsNoLeadSlash)(
     }
 
     default:
+        if (URI_FUNC(StartsIriChar)(state, first, afterLast)) {
+            return URI_FUNC(ParsePathRootless)(state, first, afterLast, memory);
+        }
         return first;
     }
 }
@@ -1231,14 +1450,18 @@ static const URI_CHAR * URI_FUNC(ParsePchar)(URI_TYPE(ParserState) * state,
         return NULL;
     }
 
+    if (URI_CHAR_IS(*first, URI_CLASS_PCHAR)) {
+        return first + 1;
+    }
+
     switch (*first) {
     case _UT('%'):
         return URI_FUNC(ParsePctEncoded)(state, first, afterLast, memory);
 
-    case URI_SET_PCHAR_WITHOUT_PERCENT(_UT):
-        return first + 1;
-
     default:
+        if (URI_FUNC(StartsIriChar)(state, first, afterLast)) {
+            return URI_FUNC(SkipIriChar)(first, afterLast, URI_FALSE);
+        }
         URI_FUNC(StopSyntax)(state, first, memory);
         return NULL;
     }
@@ -1266,59 +1489,29 @@ static const URI_CHAR * URI_FUNC(ParsePctEncoded)(URI_TYPE(ParserState) * state,
         return NULL;
     }
 
-    switch (first[1]) {
-    case URI_SET_HEXDIG(_UT):
-        if (afterLast - first < 3) {
-            URI_FUNC(StopSyntax)(state, afterLast, memory);
-            return NULL;
-        }
-
-        switch (first[2]) {
-        case URI_SET_HEXDIG(_UT):
-            return first + 3;
-
-        default:
-            URI_FUNC(StopSyntax)(state, first + 2, memory);
-            return NULL;
-        }
-
-    default:
+    if (!URI_CHAR_IS(first[1], URI_CLASS_HEXDIG)) {
         URI_FUNC(StopSyntax)(state, first + 1, memory);
         return NULL;
     }
 
-    /*
-    default:
-            URI_FUNC(StopSyntax)(state, first, memory);
-            return NULL;
-    }
-    */
-}
-
-/*
- * [pctSubUnres]->[pctEncoded]
- * [pctSubUnres]->[subDelims]
- * [pctSubUnres]->[unreserved]
- */
-static const URI_CHAR * URI_FUNC(ParsePctSubUnres)(URI_TYPE(ParserState) * state,
-        const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory) {
-    if (first >= afterLast) {
+    if (afterLast - first < 3) {
         URI_FUNC(StopSyntax)(state, afterLast, memory);
         return NULL;
     }
 
-    switch (*first) {
-    case _UT('%'):
-        return URI_FUNC(ParsePctEncoded)(state, first, afterLast, memory);
+    if (!URI_CHAR_IS(first[2], URI_CLASS_HEXDIG)) {
+        URI_FUNC(StopSyntax)(state, first + 2, memory);
+        return NULL;
+    }
 
-    case URI_SET_SUB_DELIMS(_UT):
-    case URI_SET_UNRESERVED(_UT):
-        return first + 1;
+    return first + 3;
 
+    /*
     default:
-        URI_FUNC(StopSyntax)(state, first, memory);
-        return NULL;
+            URI_FUNC(StopSyntax)(state, first, memory);
+            return NULL;
     }
+    */
 }
 
 /*
@@ -1327,19 +1520,7 @@ static const URI_CHAR * URI_FUNC(ParsePctSubUnres)(URI_TYPE(ParserState) * state
  */
 static const URI_CHAR * URI_FUNC(ParsePort)(
         const URI_CHAR * first, const URI_CHAR * afterLast) {
-tail_call:
-    if (first >= afterLast) {
-        return afterLast;
-    }
-
-    switch (*first) {
-    case URI_SET_DIGIT(_UT):
-        first += 1;
-        goto tail_call;
-
-    default:
-        return first;
-    }
+    return URI_FUNC(SkipCharClass)(first, afterLast, URI_CLASS_DIGIT);
 }
 
 /*
@@ -1347,30 +1528,31 @@ tail_call:
  * [queryFrag]-></>[queryFrag]
  * [queryFrag]-><?>[queryFrag]
  * [queryFrag]-><NULL>
+ *
+ * NOTE: With URI_PARSE_IRI, iprivate is allowed in queries (isQuery) only.
  */
 static const URI_CHAR * URI_FUNC(ParseQueryFrag)(URI_TYPE(ParserState) * state,
-        const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory) {
+        const URI_CHAR * first, const URI_CHAR * afterLast, UriBool isQuery,
+        UriMemoryManager * memory) {
 tail_call:
+    first = URI_FUNC(SkipCharClassIri)(
+            state, first, afterLast, URI_CLASS_QUERY_FRAG, isQuery);
+
     if (first >= afterLast) {
         return afterLast;
     }
 
     switch (*first) {
-    case URI_SET_PCHAR(_UT): {
-        const URI_CHAR * const afterPchar =
-                URI_FUNC(ParsePchar)(state, first, afterLast, memory);
-        if (afterPchar == NULL) {
+    case _UT('%'): {
+        const URI_CHAR * const afterPctEncoded =
+                URI_FUNC(ParsePctEncoded)(state, first, afterLast, memory);
+        if (afterPctEncoded == NULL) {
             return NULL;
         }
-        first = afterPchar;
+        first = afterPctEncoded;
         goto tail_call;
     }
 
-    case _UT('/'):
-    case _UT('?'):
-        first += 1;
-        goto tail_call;
-
     default:
         return first;
     }
@@ -1383,18 +1565,21 @@ tail_call:
 static const URI_CHAR * URI_FUNC(ParseSegment)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory) {
 tail_call:
+    first = URI_FUNC(SkipCharClassIri)(
+            state, first, afterLast, URI_CLASS_PCHAR, URI_FALSE);
+
     if (first >= afterLast) {
         return afterLast;
     }
 
     switch (*first) {
-    case URI_SET_PCHAR(_UT): {
-        const URI_CHAR * const afterPchar =
-                URI_FUNC(ParsePchar)(state, first, afterLast, memory);
-        if (afterPchar == NULL) {
+    case _UT('%'): {
+        const URI_CHAR * const afterPctEncoded =
+                URI_FUNC(ParsePctEncoded)(state, first, afterLast, memory);
+        if (afterPctEncoded == NULL) {
             return NULL;
         }
-        first = afterPchar;
+        first = afterPctEncoded;
         goto tail_call;
     }
 
@@ -1453,7 +1638,8 @@ static URI_INLINE UriBool URI_FUNC(OnExitSegmentNzNcOrScheme2)(
  */
 static const URI_CHAR * URI_FUNC(ParseSegmentNzNcOrScheme2)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory) {
-tail_call:
+    first = URI_FUNC(SkipCharClass)(first, afterLast, URI_CLASS_SCHEME);
+
     if (first >= afterLast) {
         if (!URI_FUNC(OnExitSegmentNzNcOrScheme2)(state, first, memory)) {
             URI_FUNC(StopMalloc)(state, memory);
@@ -1463,14 +1649,6 @@ tail_call:
     }
 
     switch (*first) {
-    case _UT('.'):
-    case _UT('+'):
-    case _UT('-'):
-    case URI_SET_ALPHA(_UT):
-    case URI_SET_DIGIT(_UT):
-        first += 1;
-        goto tail_call;
-
     case _UT('%'): {
         const URI_CHAR * const afterPctEncoded =
                 URI_FUNC(ParsePctEncoded)(state, first, afterLast, memory);
@@ -1533,6 +1711,10 @@ tail_call:
     }
 
     default:
+        if (URI_FUNC(StartsIriChar)(state, first, afterLast)) {
+            return URI_FUNC(ParseMustBeSegmentNzNc)(state, first, afterLast, memory);
+        }
+
         if (!URI_FUNC(OnExitSegmentNzNcOrScheme2)(state, first, memory)) {
             URI_FUNC(StopMalloc)(state, memory);
             return NULL;
@@ -1596,6 +1778,10 @@ static const URI_CHAR * URI_FUNC(ParseUriReference)(URI_TYPE(ParserState) * stat
     }
 
     default:
+        if (URI_FUNC(StartsIriChar)(state, first, afterLast)) {
+            state->uri->scheme.first = first; /* SEGMENT BEGIN, ABUSE SCHEME POINTER */
+            return URI_FUNC(ParseMustBeSegmentNzNc)(state, first, afterLast, memory);
+        }
         return URI_FUNC(ParseUriTail)(state, first, afterLast, memory);
     }
 }
@@ -1613,8 +1799,8 @@ static URI_INLINE const URI_CHAR * URI_FUNC(ParseUriTail)(URI_TYPE(ParserState)
 
     switch (*first) {
     case _UT('#'): {
-        const URI_CHAR * const afterQueryFrag =
-                URI_FUNC(ParseQueryFrag)(state, first + 1, afterLast, memory);
+        const URI_CHAR * const afterQueryFrag = URI_FUNC(ParseQueryFrag)(
+                state, first + 1, afterLast, URI_FALSE, memory);
         if (afterQueryFrag == NULL) {
             return NULL;
         }
@@ -1624,8 +1810,8 @@ static URI_INLINE const URI_CHAR * URI_FUNC(ParseUriTail)(URI_TYPE(ParserState)
     }
 
     case _UT('?'): {
-        const URI_CHAR * const afterQueryFrag =
-                URI_FUNC(ParseQueryFrag)(state, first + 1, afterLast, memory);
+        const URI_CHAR * const afterQueryFrag = URI_FUNC(ParseQueryFrag)(
+                state, first + 1, afterLast, URI_TRUE, memory);
         if (afterQueryFrag == NULL) {
             return NULL;
         }
@@ -1652,8 +1838,8 @@ static URI_INLINE const URI_CHAR * URI_FUNC(ParseUriTailTwo)(
 
     switch (*first) {
     case _UT('#'): {
-        const URI_CHAR * const afterQueryFrag =
-                URI_FUNC(ParseQueryFrag)(state, first + 1, afterLast, memory);
+        const URI_CHAR * const afterQueryFrag = URI_FUNC(ParseQueryFrag)(
+                state, first + 1, afterLast, URI_FALSE, memory);
         if (afterQueryFrag == NULL) {
             return NULL;
         }
@@ -1706,12 +1892,91 @@ static URI_INLINE void URI_FUNC(ResetParserStateExceptUri)(
     state->uri = uriBackup;
 }
 
+/*
+ * Allocates flat path segment storage for all the segments that are left
+ * to parse from first on, unless allocated before already;
+ * returns NULL if the block cannot be allocated.
+ */
+static URI_TYPE(PathSegmentBlock) * URI_FUNC(EnsureFlatPathBlock)(
+        URI_TYPE(ParserState) * state, const URI_CHAR * first,
+        UriMemoryManager * memory) {
+    URI_TYPE(PathSegmentBlock) * block = state->uri->reserved;
+
+    if (block == NULL) {
+        /* NOTE: Every segment but the first one follows a slash,
+         *       and the path ends at the first "?" or "#" */
+        const URI_TYPE(ParseContext) * const context = state->reserved;
+        const URI_CHAR * const afterLast = context->afterLast;
+        const size_t maxCapacity = ((size_t)-1 - sizeof(URI_TYPE(PathSegmentBlock)))
+                                 / sizeof(URI_TYPE(PathSegment));
+        size_t capacity = 1;
+        for (; first < afterLast; first++) {
+            if ((*first == _UT('?')) || (*first == _UT('#'))) {
+                break;
+            } else if (*first == _UT('/')) {
+                capacity++;
+            }
+        }
+        if (capacity > maxCapacity) {
+            return NULL;
+        }
+
+        block = memory->calloc(memory, 1,
+                sizeof(URI_TYPE(PathSegmentBlock))
+                        + capacity * sizeof(URI_TYPE(PathSegment)));
+        if (block == NULL) {
+            return NULL;
+        }
+        block->capacity = capacity;
+        block->segments = (URI_TYPE(PathSegment) *)(block + 1);
+        state->uri->reserved = block;
+    }
+
+    return block;
+}
+
+/*
+ * Hands out the next segment of flat path segment storage;
+ * returns NULL if the block is exhausted or cannot be allocated.
+ */
+static URI_TYPE(PathSegment) * URI_FUNC(NextFlatPathSegment)(
+        URI_TYPE(ParserState) * state, const URI_CHAR * first,
+        UriMemoryManager * memory) {
+    URI_TYPE(PathSegmentBlock) * const block =
+            URI_FUNC(EnsureFlatPathBlock)(state, first, memory);
+
+    if ((block == NULL) || (block->used >= block->capacity)) {
+        return NULL;
+    }
+    return &block->segments[block->used++];
+}
+
 static URI_INLINE UriBool URI_FUNC(PushPathSegment)(URI_TYPE(ParserState) * state,
         const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory) {
-    URI_TYPE(PathSegment) * segment =
-            memory->calloc(memory, 1, sizeof(URI_TYPE(PathSegment)));
+    URI_TYPE(PathSegment) * segment = NULL;
+    if (URI_FUNC(HasParseFlag)(state, URI_PARSE_VALIDATE_ONLY)) {
+        return URI_TRUE;
+    }
+    if ((state->uri->pathHead != NULL)
+            && URI_FUNC(HasParseFlag)(state, URI_PARSE_LAZY_PATH)) {
+        /* Extend the single raw path segment up to this segment,
+         * NOTE: Segments follow each other, separated by a single slash */
+        segment = state->uri->pathHead;
+        if (segment->text.first == URI_FUNC(SafeToPointTo)) {
+            segment->text.first = first - 1; /* empty first segment */
+        }
+        segment->text.afterLast = afterLast;
+        segment->reserved = (void *)&URI_FUNC(LazyPathMarker);
+        return URI_TRUE;
+    }
+    if (URI_FUNC(HasParseFlag)(state, URI_PARSE_FLAT_PATH)) {
+        segment = URI_FUNC(NextFlatPathSegment)(state, first, memory);
+    }
     if (segment == NULL) {
-        return URI_FALSE; /* Raises malloc error */
+        segment = memory->calloc(memory, 1, sizeof(URI_TYPE(PathSegment)));
+        if (segment == NULL) {
+            return URI_FALSE; /* Raises malloc error */
+        }
     }
     if (first == afterLast) {
         segment->text.first = URI_FUNC(SafeToPointTo);
@@ -1735,13 +2000,67 @@ static URI_INLINE UriBool URI_FUNC(PushPathSegment)(URI_TYPE(ParserState) * stat
     return URI_TRUE; /* Success */
 }
 
+static void URI_FUNC(DropIncompleteRange)(URI_TYPE(TextRange) * range) {
+    if ((range->first == NULL) || (range->afterLast == NULL)) {
+        range->first = NULL;
+        range->afterLast = NULL;
+    }
+}
+
+/*
+ * Resets the components that a parse stopped by a syntax error
+ * had begun but not finished, keeping those finished before the error.
+ * The authority is kept as a whole or not at all: only if it was
+ * followed by "/", "?", "#" or the end of input, since otherwise
+ * the error may have cut the host short (e.g. "us" of "us^er@host").
+ */
+static void URI_FUNC(DropIncompleteComponents)(URI_TYPE(Uri) * uri,
+        const URI_CHAR * afterAuthority, const URI_CHAR * afterLast,
+        UriMemoryManager * memory) {
+    UriBool authorityComplete = URI_FALSE;
+    if (afterAuthority == afterLast) {
+        authorityComplete = URI_TRUE;
+    } else if (afterAuthority != NULL) {
+        switch (*afterAuthority) {
+        case _UT('/'):
+        case _UT('?'):
+        case _UT('#'):
+            authorityComplete = URI_TRUE;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    URI_FUNC(DropIncompleteRange)(&uri->scheme);
+    URI_FUNC(DropIncompleteRange)(&uri->hostText);
+    URI_FUNC(DropIncompleteRange)(&uri->userInfo);
+    URI_FUNC(DropIncompleteRange)(&uri->portText);
+    URI_FUNC(DropIncompleteRange)(&uri->query);
+    URI_FUNC(DropIncompleteRange)(&uri->fragment);
+
+    if ((uri->hostText.first == NULL) || !authorityComplete) {
+        uri->hostText.first = NULL;
+        uri->hostText.afterLast = NULL;
+        uri->userInfo.first = NULL;
+        uri->userInfo.afterLast = NULL;
+        uri->portText.first = NULL;
+        uri->portText.afterLast = NULL;
+        URI_FUNC(FreeHostData)(uri, memory);
+        uri->hostData.ipFuture.first = NULL;
+        uri->hostData.ipFuture.afterLast = NULL;
+    }
+}
+
 int URI_FUNC(ParseUriEx)(URI_TYPE(ParserState) * state, const URI_CHAR * first,
         const URI_CHAR * afterLast) {
-    return URI_FUNC(ParseUriExMm)(state, first, afterLast, NULL);
+    return URI_FUNC(ParseUriExMm)(state, first, afterLast, 0, NULL);
 }
 
 static int URI_FUNC(ParseUriExMm)(URI_TYPE(ParserState) * state, const URI_CHAR * first,
-        const URI_CHAR * afterLast, UriMemoryManager * memory) {
+        const URI_CHAR * afterLast, unsigned int flags, UriMemoryManager * memory) {
+    URI_TYPE(ParseContext) context;
     const URI_CHAR * afterUriReference;
     URI_TYPE(Uri) * uri;
 
@@ -1755,23 +2074,46 @@ static int URI_FUNC(ParseUriExMm)(URI_TYPE(ParserState) * state, const URI_CHAR
 
     /* Init parser */
     URI_FUNC(ResetParserStateExceptUri)(state);
-    URI_FUNC(ResetUri)(uri);
+    if (flags & URI_PARSE_INLINE_BLOCK) {
+        void * const block = uri->reserved;
+        URI_FUNC(ResetUri)(uri);
+        uri->reserved = block;
+    } else {
+        URI_FUNC(ResetUri)(uri);
+    }
+
+    if (flags != 0) {
+        context.flags = flags;
+        context.afterLast = afterLast;
+        context.afterAuthority = NULL;
+        state->reserved = &context;
+    }
 
     /* Parse */
     afterUriReference = URI_FUNC(ParseUriReference)(state, first, afterLast, memory);
-    if (afterUriReference == NULL) {
-        /* Waterproof errorPos <= afterLast */
-        if (state->errorPos && (state->errorPos > afterLast)) {
-            state->errorPos = afterLast;
-        }
-        return state->errorCode;
-    }
-    if (afterUriReference != afterLast) {
+    if ((afterUriReference != NULL) && (afterUriReference != afterLast)) {
         if (afterUriReference < afterLast) {
             URI_FUNC(StopSyntax)(state, afterUriReference, memory);
         } else {
             URI_FUNC(StopSyntax)(state, afterLast, memory);
         }
+        afterUriReference = NULL;
+    }
+
+    URI_FUNC(DropScratchHostData)(state);
+    state->reserved = NULL; /* context is going out of scope */
+
+    if ((afterUriReference == NULL) && (state->errorCode == URI_ERROR_SYNTAX)
+            && (flags & URI_PARSE_KEEP_PARTIAL)) {
+        URI_FUNC(DropIncompleteComponents)(
+                uri, context.afterAuthority, afterLast, memory);
+    }
+
+    if (afterUriReference == NULL) {
+        /* Waterproof errorPos <= afterLast */
+        if (state->errorPos && (state->errorPos > afterLast)) {
+            state->errorPos = afterLast;
+        }
         return state->errorCode;
     }
     return URI_SUCCESS;
@@ -1797,9 +2139,9 @@ int URI_FUNC(ParseSingleUriEx)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
     return URI_FUNC(ParseSingleUriExMm)(uri, first, afterLast, errorPos, NULL);
 }
 
-int URI_FUNC(ParseSingleUriExMm)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
-        const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
-        UriMemoryManager * memory) {
+static int URI_FUNC(InternalParseSingleUriExMm)(URI_TYPE(Uri) * uri,
+        const URI_CHAR * first, const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
+        unsigned int flags, UriMemoryManager * memory) {
     URI_TYPE(ParserState) state;
     int res;
 
@@ -1811,18 +2153,212 @@ int URI_FUNC(ParseSingleUriExMm)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
 
     state.uri = uri;
 
-    res = URI_FUNC(ParseUriExMm)(&state, first, afterLast, memory);
+    res = URI_FUNC(ParseUriExMm)(&state, first, afterLast, flags, memory);
 
     if (res != URI_SUCCESS) {
         if (errorPos != NULL) {
             *errorPos = state.errorPos;
         }
-        URI_FUNC(FreeUriMembersMm)(uri, memory);
+        if ((res != URI_ERROR_SYNTAX) || !(flags & URI_PARSE_KEEP_PARTIAL)) {
+            URI_FUNC(FreeUriMembersMm)(uri, memory);
+        }
+    }
+
+    return res;
+}
+
+int URI_FUNC(ParseSingleUriExMm)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
+        const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
+        UriMemoryManager * memory) {
+    return URI_FUNC(InternalParseSingleUriExMm)(
+            uri, first, afterLast, errorPos, 0, memory);
+}
+
+int URI_FUNC(ParseSingleUriExFlatMm)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
+        const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
+        UriMemoryManager * memory) {
+    return URI_FUNC(InternalParseSingleUriExMm)(
+            uri, first, afterLast, errorPos, URI_PARSE_FLAT_PATH, memory);
+}
+
+int URI_FUNC(ParseSingleUriInlineMm)(URI_TYPE(UriInline) * uriInline,
+        const URI_CHAR * first, const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
+        UriMemoryManager * memory) {
+    URI_TYPE(PathSegmentBlock) * block;
+
+    if (uriInline == NULL) {
+        return URI_ERROR_NULL;
+    }
+
+    block = &uriInline->block;
+    memset(block, 0, sizeof(URI_TYPE(PathSegmentBlock)));
+    memset(uriInline->segments, 0, sizeof(uriInline->segments));
+    block->capacity = URI_INLINE_SEGMENT_COUNT;
+    block->isInline = URI_TRUE;
+    block->segments = uriInline->segments;
+    uriInline->uri.reserved = block;
+
+    return URI_FUNC(InternalParseSingleUriExMm)(&uriInline->uri, first, afterLast,
+            errorPos, URI_PARSE_FLAT_PATH | URI_PARSE_INLINE_BLOCK, memory);
+}
+
+int URI_FUNC(ParseSingleUriExLazyMm)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
+        const URI_CHAR * afterLast, const URI_CHAR ** errorPos,
+        UriMemoryManager * memory) {
+    return URI_FUNC(InternalParseSingleUriExMm)(
+            uri, first, afterLast, errorPos, URI_PARSE_LAZY_PATH, memory);
+}
+
+/*
+ * Returns the position where the authority of the URI reference
+ * [first, afterLast) ends, or where the scheme ends if there is no authority.
+ */
+static const URI_CHAR * URI_FUNC(FindAfterAuthority)(
+        const URI_CHAR * first, const URI_CHAR * afterLast) {
+    /* scheme ":" */
+    if ((first < afterLast) && URI_CHAR_IS(first[0], URI_CLASS_ALPHA)) {
+        const URI_CHAR * const afterScheme =
+                URI_FUNC(SkipCharClass)(first + 1, afterLast, URI_CLASS_SCHEME);
+        if ((afterScheme < afterLast) && (afterScheme[0] == _UT(':'))) {
+            first = afterScheme + 1;
+        }
+    }
+
+    /* "//" authority */
+    if ((afterLast - first < 2) || (first[0] != _UT('/')) || (first[1] != _UT('/'))) {
+        return first;
+    }
+    for (first += 2; first < afterLast; first++) {
+        switch (first[0]) {
+        case _UT('/'):
+        case _UT('?'):
+        case _UT('#'):
+            return first;
+        default:
+            break;
+        }
+    }
+    return afterLast;
+}
+
+int URI_FUNC(ParseSingleUriOptionsMm)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
+        const URI_CHAR * afterLast, const URI_CHAR ** errorPos, unsigned int options,
+        UriMemoryManager * memory) {
+    /* Check params */
+    if ((uri == NULL) || (first == NULL) || (afterLast == NULL)) {
+        return URI_ERROR_NULL;
+    }
+
+    if (options & URI_PARSE_STOP_AFTER_AUTHORITY) {
+        afterLast = URI_FUNC(FindAfterAuthority)(first, afterLast);
+    }
+
+    return URI_FUNC(InternalParseSingleUriExMm)(uri, first, afterLast, errorPos,
+            options
+                    & (URI_PARSE_SKIP_HOST_DATA | URI_PARSE_RAW_PATH_ONLY
+                            | URI_PARSE_KEEP_PARTIAL | URI_PARSE_IRI),
+            memory);
+}
+
+int URI_FUNC(ParseSingleUriOptions)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
+        const URI_CHAR * afterLast, const URI_CHAR ** errorPos, unsigned int options) {
+    if ((afterLast == NULL) && (first != NULL)) {
+        afterLast = first + URI_STRLEN(first);
+    }
+    return URI_FUNC(ParseSingleUriOptionsMm)(
+            uri, first, afterLast, errorPos, options, NULL);
+}
+
+int URI_FUNC(EnsurePathSegmentsMm)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
+    if (uri == NULL) {
+        return URI_ERROR_NULL;
+    }
+    URI_CHECK_MEMORY_MANAGER(memory); /* may return */
+
+    return URI_FUNC(MaterializePath)(uri, memory) ? URI_SUCCESS : URI_ERROR_MALLOC;
+}
+
+int URI_FUNC(EnsurePathSegments)(URI_TYPE(Uri) * uri) {
+    return URI_FUNC(EnsurePathSegmentsMm)(uri, NULL);
+}
+
+int URI_FUNC(ValidateUriEx)(
+        const URI_CHAR * first, const URI_CHAR * afterLast, const URI_CHAR ** errorPos) {
+    URI_TYPE(ParserState) state;
+    URI_TYPE(Uri) uri;
+    int res;
+
+    /* Check params */
+    if (first == NULL) {
+        return URI_ERROR_NULL;
+    }
+    if (afterLast == NULL) {
+        afterLast = first + URI_STRLEN(first);
+    }
+
+    state.uri = &uri;
+
+    /* NOTE: The memory manager is never called when validating only */
+    res = URI_FUNC(ParseUriExMm)(
+            &state, first, afterLast, URI_PARSE_VALIDATE_ONLY, &defaultMemoryManager);
+
+    if ((res != URI_SUCCESS) && (errorPos != NULL)) {
+        *errorPos = state.errorPos;
     }
 
     return res;
 }
 
+int URI_FUNC(ParseBatchExMm)(URI_TYPE(Uri) * uris, const URI_CHAR * const * firsts,
+        const URI_CHAR * const * afterLasts, size_t count, int * errorCodes,
+        const URI_CHAR ** errorPositions, UriMemoryManager * memory) {
+    URI_TYPE(ParserState) state;
+    int batchRes = URI_SUCCESS;
+    size_t i;
+
+    /* Check params */
+    if ((count > 0) && ((uris == NULL) || (firsts == NULL))) {
+        return URI_ERROR_NULL;
+    }
+    URI_CHECK_MEMORY_MANAGER(memory); /* may return */
+
+    for (i = 0; i < count; i++) {
+        const URI_CHAR * const first = firsts[i];
+        const URI_CHAR * afterLast = NULL;
+        int res;
+
+        if (first != NULL) {
+            afterLast = (afterLasts != NULL) ? afterLasts[i]
+                                             : first + URI_STRLEN(first);
+        }
+
+        state.errorPos = NULL;
+
+        if (afterLast == NULL) {
+            URI_FUNC(ResetUri)(&uris[i]);
+            res = URI_ERROR_NULL;
+        } else {
+            state.uri = &uris[i];
+            res = URI_FUNC(ParseUriExMm)(&state, first, afterLast, 0, memory);
+            if (res != URI_SUCCESS) {
+                URI_FUNC(FreeUriMembersMm)(&uris[i], memory);
+            }
+        }
+
+        if (errorCodes != NULL) {
+            errorCodes[i] = res;
+        }
+        if (errorPositions != NULL) {
+            errorPositions[i] = (res == URI_ERROR_SYNTAX) ? state.errorPos : NULL;
+        }
+        if ((res != URI_SUCCESS) && (batchRes == URI_SUCCESS)) {
+            batchRes = res;
+        }
+    }
+
+    return batchRes;
+}
+
 void URI_FUNC(FreeUriMembers)(URI_TYPE(Uri) * uri) {
     URI_FUNC(FreeUriMembersMm)(uri, NULL);
 }
@@ -1877,17 +2413,8 @@ int URI_FUNC(FreeUriMembersMm)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
         }
     }
 
-    /* Host data - IPv4 */
-    if (uri->hostData.ip4 != NULL) {
-        memory->free(memory, uri->hostData.ip4);
-        uri->hostData.ip4 = NULL;
-    }
-
-    /* Host data - IPv6 */
-    if (uri->hostData.ip6 != NULL) {
-        memory->free(memory, uri->hostData.ip6);
-        uri->hostData.ip6 = NULL;
-    }
+    /* Host data - IPv4 and IPv6 */
+    URI_FUNC(FreeHostData)(uri, memory);
 
     /* Port text */
     if (uri->owner && (uri->portText.first != NULL)) {
@@ -1924,7 +2451,33 @@ int URI_FUNC(FreeUriMembersMm)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
     return URI_SUCCESS;
 }
 
-UriBool URI_FUNC(_TESTING_ONLY_ParseIpSix)(const URI_CHAR * text) {
+int URI_FUNC(ScanIpSixLiteral)(const URI_CHAR * first, const URI_CHAR * afterLast,
+        const URI_CHAR ** errorPos) {
+    URI_TYPE(ParseContext) context;
+    URI_TYPE(ParserState) parser;
+    URI_TYPE(Uri) uri;
+
+    URI_FUNC(ResetUri)(&uri);
+    parser.uri = &uri;
+    URI_FUNC(ResetParserStateExceptUri)(&parser);
+    context.flags = URI_PARSE_VALIDATE_ONLY;
+    context.afterLast = afterLast;
+    context.afterAuthority = NULL;
+    parser.reserved = &context;
+    uri.hostData.ip6 = &context.ip6Scratch;
+
+    /* NOTE: The memory manager is never called when validating only */
+    if (URI_FUNC(ParseIPv6address2)(&parser, first, afterLast, &defaultMemoryManager)
+            == NULL) {
+        *errorPos = parser.errorPos;
+        return URI_ERROR_SYNTAX;
+    }
+    return URI_SUCCESS;
+}
+
+/* State machine reference for the fast IPv6 path, text needs the closing "]" */
+UriBool URI_FUNC(_TESTING_ONLY_ParseIpSixReference)(
+        unsigned char * output, const URI_CHAR * text) {
     UriMemoryManager * const memory = &defaultMemoryManager;
     URI_TYPE(Uri) uri;
     URI_TYPE(ParserState) parser;
@@ -1936,10 +2489,18 @@ UriBool URI_FUNC(_TESTING_ONLY_ParseIpSix)(const URI_CHAR * text) {
     URI_FUNC(ResetParserStateExceptUri)(&parser);
     parser.uri->hostData.ip6 = memory->malloc(memory, 1 * sizeof(UriIp6));
     res = URI_FUNC(ParseIPv6address2)(&parser, text, afterIpSix, memory);
+    if (res == afterIpSix) {
+        memcpy(output, uri.hostData.ip6->data, 16);
+    }
     URI_FUNC(FreeUriMembersMm)(&uri, memory);
     return res == afterIpSix ? URI_TRUE : URI_FALSE;
 }
 
+UriBool URI_FUNC(_TESTING_ONLY_ParseIpSix)(const URI_CHAR * text) {
+    unsigned char octets[16];
+    return URI_FUNC(_TESTING_ONLY_ParseIpSixReference)(octets, text);
+}
+
 UriBool URI_FUNC(_TESTING_ONLY_ParseIpFour)(const URI_CHAR * text) {
     unsigned char octets[4];
     int res = URI_FUNC(ParseIpFourAddress)(octets, text, text + URI_STRLEN(text));
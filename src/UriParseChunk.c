@@ -0,0 +1,969 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriParseChunk.c
+ * Holds the incremental parser implementation.
+ * NOTE: This source file includes itself twice.
+ */
+
+/* What encodings are enabled? */
+#include <uriparser/UriDefsConfig.h>
+#if (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* Include SELF twice */
+#  ifdef URI_ENABLE_ANSI
+#    define URI_PASS_ANSI 1
+#    include "UriParseChunk.c"
+#    undef URI_PASS_ANSI
+#  endif
+#  ifdef URI_ENABLE_UNICODE
+#    define URI_PASS_UNICODE 1
+#    include "UriParseChunk.c"
+#    undef URI_PASS_UNICODE
+#  endif
+#else
+#  ifdef URI_PASS_ANSI
+#    include <uriparser/UriDefsAnsi.h>
+#  else
+#    include <uriparser/UriDefsUnicode.h>
+#    include <wchar.h>
+#  endif
+
+#  ifndef URI_DOXYGEN
+#    include <uriparser/Uri.h>
+#    include <uriparser/UriIp4.h>
+#    include "UriCharClass.h"
+#    include "UriCommon.h"
+#    include "UriMemory.h"
+#    include "UriParseChunk.h"
+#    include "UriSets.h"
+#  endif
+
+#  include <string.h> /* for memcpy */
+
+#  define URI_CHUNK_MIN_CAPACITY 64
+
+void URI_FUNC(InitChunkGrammar)(URI_TYPE(ChunkGrammar) * grammar) {
+    grammar->rule = URI_CHUNK_URI_REFERENCE;
+    grammar->pendingHexDigits = 0;
+    grammar->hostKind = URI_CHUNK_HOST_REG_NAME;
+    grammar->absolutePath = URI_FALSE;
+    grammar->schemeAfterLast = URI_CHUNK_NONE;
+    grammar->authorityFirst = URI_CHUNK_NONE;
+    grammar->userInfoAfterLast = URI_CHUNK_NONE;
+    grammar->hostFirst = URI_CHUNK_NONE;
+    grammar->hostAfterLast = URI_CHUNK_NONE;
+    grammar->portFirst = URI_CHUNK_NONE;
+    grammar->authorityAfterLast = URI_CHUNK_NONE;
+    grammar->pathFirst = URI_CHUNK_NONE;
+    grammar->queryFirst = URI_CHUNK_NONE;
+    grammar->fragmentFirst = URI_CHUNK_NONE;
+}
+
+/*
+ * Enters query or fragment at the "?" or "#" at offset pos,
+ * or fails at any other character like [uriTail] does.
+ */
+static UriBool URI_FUNC(EnterUriTail)(
+        URI_TYPE(ChunkGrammar) * grammar, URI_CHAR c, size_t pos) {
+    switch (c) {
+    case _UT('?'):
+        grammar->queryFirst = pos + 1; /* QUERY BEGIN */
+        grammar->rule = URI_CHUNK_QUERY;
+        return URI_TRUE;
+
+    case _UT('#'):
+        grammar->fragmentFirst = pos + 1; /* FRAGMENT BEGIN */
+        grammar->rule = URI_CHUNK_FRAGMENT;
+        return URI_TRUE;
+
+    default:
+        return URI_FALSE;
+    }
+}
+
+/*
+ * NOTE: Where a rule ends at c, the rule following it gets to look at c, too.
+ */
+UriBool URI_FUNC(StepChunkGrammar)(URI_TYPE(ChunkGrammar) * grammar, URI_CHAR c,
+        size_t pos) {
+    if (grammar->pendingHexDigits > 0) {
+        if (!URI_CHAR_IS(c, URI_CLASS_HEXDIG)) {
+            return URI_FALSE;
+        }
+        grammar->pendingHexDigits--;
+        return URI_TRUE;
+    }
+
+    for (;;) {
+        switch (grammar->rule) {
+        case URI_CHUNK_URI_REFERENCE:
+            switch (c) {
+            case URI_SET_ALPHA(_UT):
+                grammar->rule = URI_CHUNK_SEGMENT_NZ_NC_OR_SCHEME;
+                return URI_TRUE;
+
+            case URI_SET_DIGIT(_UT):
+            case URI_SET_SUB_DELIMS(_UT):
+            case _UT('.'):
+            case _UT('_'):
+            case _UT('~'):
+            case _UT('-'):
+            case _UT('@'):
+                grammar->pathFirst = 0; /* SEGMENT BEGIN */
+                grammar->rule = URI_CHUNK_MUST_BE_SEGMENT_NZ_NC;
+                return URI_TRUE;
+
+            case _UT('%'):
+                grammar->pathFirst = 0; /* SEGMENT BEGIN */
+                grammar->pendingHexDigits = 2;
+                grammar->rule = URI_CHUNK_MUST_BE_SEGMENT_NZ_NC;
+                return URI_TRUE;
+
+            case _UT('/'):
+                grammar->rule = URI_CHUNK_PART_HELPER_TWO;
+                return URI_TRUE;
+
+            default:
+                return URI_FUNC(EnterUriTail)(grammar, c, pos);
+            }
+
+        case URI_CHUNK_SEGMENT_NZ_NC_OR_SCHEME:
+            if (URI_CHAR_IS(c, URI_CLASS_SCHEME)) {
+                return URI_TRUE;
+            }
+            switch (c) {
+            case _UT('%'):
+                grammar->pendingHexDigits = 2;
+                /* fall through */
+            case _UT('!'):
+            case _UT('$'):
+            case _UT('&'):
+            case _UT('('):
+            case _UT(')'):
+            case _UT('*'):
+            case _UT(','):
+            case _UT(';'):
+            case _UT('@'):
+            case _UT('_'):
+            case _UT('~'):
+            case _UT('='):
+            case _UT('\''):
+                grammar->pathFirst = 0; /* SEGMENT BEGIN */
+                grammar->rule = URI_CHUNK_MUST_BE_SEGMENT_NZ_NC;
+                return URI_TRUE;
+
+            case _UT(':'):
+                grammar->schemeAfterLast = pos; /* SCHEME END */
+                grammar->rule = URI_CHUNK_HIER_PART;
+                return URI_TRUE;
+
+            default:
+                grammar->pathFirst = 0; /* SEGMENT BEGIN */
+                grammar->rule = URI_CHUNK_MUST_BE_SEGMENT_NZ_NC;
+                continue;
+            }
+
+        case URI_CHUNK_MUST_BE_SEGMENT_NZ_NC:
+            if (URI_CHAR_IS(c, URI_CLASS_UNRESERVED | URI_CLASS_SUB_DELIMS)) {
+                return URI_TRUE;
+            }
+            switch (c) {
+            case _UT('%'):
+                grammar->pendingHexDigits = 2;
+                return URI_TRUE;
+
+            case _UT('@'):
+                return URI_TRUE;
+
+            case _UT('/'):
+                grammar->rule = URI_CHUNK_SEGMENT;
+                return URI_TRUE;
+
+            default:
+                return URI_FUNC(EnterUriTail)(grammar, c, pos);
+            }
+
+        case URI_CHUNK_SEGMENT:
+            if (URI_CHAR_IS(c, URI_CLASS_PATH)) {
+                return URI_TRUE;
+            }
+            if (c == _UT('%')) {
+                grammar->pendingHexDigits = 2;
+                return URI_TRUE;
+            }
+            return URI_FUNC(EnterUriTail)(grammar, c, pos);
+
+        case URI_CHUNK_HIER_PART:
+            switch (c) {
+            case URI_SET_PCHAR(_UT):
+                grammar->pathFirst = pos; /* SEGMENT BEGIN */
+                grammar->rule = URI_CHUNK_SEGMENT;
+                continue;
+
+            case _UT('/'):
+                grammar->rule = URI_CHUNK_PART_HELPER_TWO;
+                return URI_TRUE;
+
+            default:
+                return URI_FUNC(EnterUriTail)(grammar, c, pos);
+            }
+
+        case URI_CHUNK_PART_HELPER_TWO:
+            if (c == _UT('/')) {
+                grammar->authorityFirst = pos + 1; /* AUTHORITY BEGIN */
+                grammar->rule = URI_CHUNK_AUTHORITY;
+                return URI_TRUE;
+            }
+            grammar->absolutePath = URI_TRUE;
+            switch (c) {
+            case URI_SET_PCHAR(_UT):
+                grammar->pathFirst = pos; /* SEGMENT BEGIN */
+                grammar->rule = URI_CHUNK_SEGMENT;
+                continue;
+
+            default:
+                return URI_FUNC(EnterUriTail)(grammar, c, pos);
+            }
+
+        case URI_CHUNK_AUTHORITY:
+            switch (c) {
+            case _UT('['):
+                grammar->hostFirst = pos + 1; /* HOST BEGIN */
+                grammar->rule = URI_CHUNK_IP_LIT_2;
+                return URI_TRUE;
+
+            case URI_SET_PCHAR(_UT):
+                grammar->hostFirst = pos; /* USERINFO BEGIN */
+                grammar->rule = URI_CHUNK_OWN_HOST_USER_INFO;
+                continue;
+
+            default:
+                /* "" regname host */
+                grammar->hostFirst = pos;
+                grammar->hostAfterLast = pos;
+                grammar->authorityAfterLast = pos;
+                grammar->rule = URI_CHUNK_PATH_ABS_EMPTY;
+                continue;
+            }
+
+        case URI_CHUNK_OWN_HOST_USER_INFO:
+            if (URI_CHAR_IS(c, URI_CLASS_UNRESERVED | URI_CLASS_SUB_DELIMS)) {
+                return URI_TRUE;
+            }
+            switch (c) {
+            case _UT('%'):
+                grammar->pendingHexDigits = 2;
+                return URI_TRUE;
+
+            case _UT(':'):
+                grammar->hostAfterLast = pos; /* HOST END */
+                grammar->portFirst = pos + 1; /* PORT BEGIN */
+                grammar->rule = URI_CHUNK_OWN_PORT_USER_INFO;
+                return URI_TRUE;
+
+            case _UT('@'):
+                grammar->userInfoAfterLast = pos; /* USERINFO END */
+                grammar->hostFirst = pos + 1; /* HOST BEGIN */
+                grammar->rule = URI_CHUNK_OWN_HOST;
+                return URI_TRUE;
+
+            default:
+                grammar->hostAfterLast = pos; /* HOST END */
+                grammar->authorityAfterLast = pos;
+                grammar->rule = URI_CHUNK_PATH_ABS_EMPTY;
+                continue;
+            }
+
+        case URI_CHUNK_OWN_PORT_USER_INFO:
+            if (URI_CHAR_IS(c, URI_CLASS_DIGIT)) {
+                return URI_TRUE;
+            }
+            switch (c) {
+            case _UT('%'):
+                grammar->pendingHexDigits = 2;
+                /* fall through */
+            case URI_SET_SUB_DELIMS(_UT):
+            case _UT('-'):
+            case _UT('.'):
+            case _UT('_'):
+            case _UT('~'):
+            case _UT(':'):
+            case URI_SET_ALPHA(_UT):
+                grammar->portFirst = URI_CHUNK_NONE; /* Not a port, reset */
+                grammar->rule = URI_CHUNK_OWN_USER_INFO;
+                return URI_TRUE;
+
+            case _UT('@'):
+                grammar->portFirst = URI_CHUNK_NONE; /* Not a port, reset */
+                grammar->userInfoAfterLast = pos; /* USERINFO END */
+                grammar->hostFirst = pos + 1; /* HOST BEGIN */
+                grammar->rule = URI_CHUNK_OWN_HOST;
+                return URI_TRUE;
+
+            default:
+                grammar->authorityAfterLast = pos; /* PORT END */
+                grammar->rule = URI_CHUNK_PATH_ABS_EMPTY;
+                continue;
+            }
+
+        case URI_CHUNK_OWN_USER_INFO:
+            if (URI_CHAR_IS(c, URI_CLASS_USERINFO)) {
+                return URI_TRUE;
+            }
+            switch (c) {
+            case _UT('%'):
+                grammar->pendingHexDigits = 2;
+                return URI_TRUE;
+
+            case _UT('@'):
+                grammar->userInfoAfterLast = pos; /* USERINFO END */
+                grammar->hostFirst = pos + 1; /* HOST BEGIN */
+                grammar->rule = URI_CHUNK_OWN_HOST;
+                return URI_TRUE;
+
+            default:
+                return URI_FALSE;
+            }
+
+        case URI_CHUNK_OWN_HOST:
+            if (c == _UT('[')) {
+                grammar->hostFirst = pos + 1; /* HOST BEGIN */
+                grammar->rule = URI_CHUNK_IP_LIT_2;
+                return URI_TRUE;
+            }
+            grammar->rule = URI_CHUNK_OWN_HOST_2;
+            continue;
+
+        case URI_CHUNK_OWN_HOST_2:
+            if (URI_CHAR_IS(c, URI_CLASS_UNRESERVED | URI_CLASS_SUB_DELIMS)) {
+                return URI_TRUE;
+            }
+            if (c == _UT('%')) {
+                grammar->pendingHexDigits = 2;
+                return URI_TRUE;
+            }
+            grammar->hostAfterLast = pos; /* HOST END */
+            grammar->rule = URI_CHUNK_AUTHORITY_TWO;
+            continue;
+
+        case URI_CHUNK_IP_LIT_2:
+            switch (c) {
+            /* The leading "v" of IPvFuture is case-insensitive. */
+            case _UT('v'):
+            case _UT('V'):
+                grammar->hostKind = URI_CHUNK_HOST_IP_FUTURE;
+                grammar->rule = URI_CHUNK_IP_FUTURE_VERSION;
+                return URI_TRUE;
+
+            case _UT(':'):
+            case URI_SET_HEXDIG(_UT):
+                grammar->hostKind = URI_CHUNK_HOST_IP_SIX;
+                grammar->rule = URI_CHUNK_IP_SIX;
+                return URI_TRUE;
+
+            default:
+                /* NOTE: This includes "]", an empty literal is invalid */
+                return URI_FALSE;
+            }
+
+        case URI_CHUNK_IP_FUTURE_VERSION:
+            if (!URI_CHAR_IS(c, URI_CLASS_HEXDIG)) {
+                return URI_FALSE;
+            }
+            grammar->rule = URI_CHUNK_IP_FUTURE_HEX_ZERO;
+            return URI_TRUE;
+
+        case URI_CHUNK_IP_FUTURE_HEX_ZERO:
+            if (URI_CHAR_IS(c, URI_CLASS_HEXDIG)) {
+                return URI_TRUE;
+            }
+            if (c != _UT('.')) {
+                return URI_FALSE;
+            }
+            grammar->rule = URI_CHUNK_IP_FUTURE_LOOP_FIRST;
+            return URI_TRUE;
+
+        case URI_CHUNK_IP_FUTURE_LOOP_FIRST:
+            /* NOTE: Class userinfo is exactly unreserved, sub-delims and ":" */
+            if (!URI_CHAR_IS(c, URI_CLASS_USERINFO)) {
+                return URI_FALSE;
+            }
+            grammar->rule = URI_CHUNK_IP_FUTURE_LOOP;
+            return URI_TRUE;
+
+        case URI_CHUNK_IP_FUTURE_LOOP:
+            if (URI_CHAR_IS(c, URI_CLASS_USERINFO)) {
+                return URI_TRUE;
+            }
+            if (c != _UT(']')) {
+                return URI_FALSE;
+            }
+            grammar->hostAfterLast = pos; /* HOST END */
+            grammar->rule = URI_CHUNK_AUTHORITY_TWO;
+            return URI_TRUE;
+
+        case URI_CHUNK_IP_SIX:
+            switch (c) {
+            case _UT(':'):
+            case _UT('.'):
+            case URI_SET_HEXDIG(_UT):
+                /* NOTE: The text of the literal is checked by the caller */
+                return URI_TRUE;
+
+            case _UT(']'):
+                grammar->hostAfterLast = pos; /* HOST END */
+                grammar->rule = URI_CHUNK_AUTHORITY_TWO;
+                return URI_TRUE;
+
+            default:
+                return URI_FALSE;
+            }
+
+        case URI_CHUNK_AUTHORITY_TWO:
+            if (c == _UT(':')) {
+                grammar->portFirst = pos + 1; /* PORT BEGIN */
+                grammar->rule = URI_CHUNK_PORT;
+                return URI_TRUE;
+            }
+            grammar->authorityAfterLast = pos;
+            grammar->rule = URI_CHUNK_PATH_ABS_EMPTY;
+            continue;
+
+        case URI_CHUNK_PORT:
+            if (URI_CHAR_IS(c, URI_CLASS_DIGIT)) {
+                return URI_TRUE;
+            }
+            grammar->authorityAfterLast = pos; /* PORT END */
+            grammar->rule = URI_CHUNK_PATH_ABS_EMPTY;
+            continue;
+
+        case URI_CHUNK_PATH_ABS_EMPTY:
+            if (c == _UT('/')) {
+                grammar->pathFirst = pos + 1; /* SEGMENT BEGIN */
+                grammar->rule = URI_CHUNK_SEGMENT;
+                return URI_TRUE;
+            }
+            return URI_FUNC(EnterUriTail)(grammar, c, pos);
+
+        case URI_CHUNK_QUERY:
+            if (URI_CHAR_IS(c, URI_CLASS_QUERY_FRAG)) {
+                return URI_TRUE;
+            }
+            switch (c) {
+            case _UT('%'):
+                grammar->pendingHexDigits = 2;
+                return URI_TRUE;
+
+            case _UT('#'):
+                grammar->fragmentFirst = pos + 1; /* FRAGMENT BEGIN */
+                grammar->rule = URI_CHUNK_FRAGMENT;
+                return URI_TRUE;
+
+            default:
+                return URI_FALSE;
+            }
+
+        case URI_CHUNK_FRAGMENT:
+        default:
+            if (URI_CHAR_IS(c, URI_CLASS_QUERY_FRAG)) {
+                return URI_TRUE;
+            }
+            if (c == _UT('%')) {
+                grammar->pendingHexDigits = 2;
+                return URI_TRUE;
+            }
+            return URI_FALSE;
+        }
+    }
+}
+
+const URI_CHAR * URI_FUNC(SkipChunkGrammarRun)(const URI_TYPE(ChunkGrammar) * grammar,
+        const URI_CHAR * first, const URI_CHAR * afterLast) {
+    if (grammar->pendingHexDigits > 0) {
+        return first;
+    }
+
+    /* Most of the input is path, query and fragment */
+    switch (grammar->rule) {
+    case URI_CHUNK_SEGMENT:
+        while ((first < afterLast) && URI_CHAR_IS(first[0], URI_CLASS_PATH)) {
+            first++;
+        }
+        break;
+
+    case URI_CHUNK_QUERY:
+    case URI_CHUNK_FRAGMENT:
+        while ((first < afterLast) && URI_CHAR_IS(first[0], URI_CLASS_QUERY_FRAG)) {
+            first++;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return first;
+}
+
+UriBool URI_FUNC(FinishChunkGrammar)(URI_TYPE(ChunkGrammar) * grammar, size_t afterLast) {
+    /* Input cut off inside a percent-encoded triplet? */
+    if (grammar->pendingHexDigits > 0) {
+        return URI_FALSE;
+    }
+
+    switch (grammar->rule) {
+    case URI_CHUNK_SEGMENT_NZ_NC_OR_SCHEME:
+        grammar->pathFirst = 0; /* SEGMENT BEGIN */
+        break;
+
+    case URI_CHUNK_PART_HELPER_TWO:
+        grammar->absolutePath = URI_TRUE;
+        break;
+
+    case URI_CHUNK_AUTHORITY:
+        /* "" regname host */
+        grammar->hostFirst = afterLast;
+        grammar->hostAfterLast = afterLast;
+        break;
+
+    case URI_CHUNK_OWN_HOST_USER_INFO:
+    case URI_CHUNK_OWN_HOST:
+    case URI_CHUNK_OWN_HOST_2:
+        grammar->hostAfterLast = afterLast; /* HOST END */
+        break;
+
+    case URI_CHUNK_OWN_USER_INFO:
+    case URI_CHUNK_IP_LIT_2:
+    case URI_CHUNK_IP_FUTURE_VERSION:
+    case URI_CHUNK_IP_FUTURE_HEX_ZERO:
+    case URI_CHUNK_IP_FUTURE_LOOP_FIRST:
+    case URI_CHUNK_IP_FUTURE_LOOP:
+    case URI_CHUNK_IP_SIX:
+        return URI_FALSE;
+
+    default:
+        break;
+    }
+
+    if ((grammar->authorityFirst != URI_CHUNK_NONE)
+            && (grammar->authorityAfterLast == URI_CHUNK_NONE)) {
+        grammar->authorityAfterLast = afterLast;
+    }
+
+    grammar->rule = URI_CHUNK_DONE;
+    return URI_TRUE;
+}
+
+int URI_FUNC(BuildChunkUri)(const URI_TYPE(ChunkGrammar) * grammar, URI_TYPE(Uri) * uri,
+        const URI_CHAR * text, size_t afterLast, UriMemoryManager * memory) {
+    size_t pathAfterLast = afterLast;
+    size_t segmentCount = 0;
+    UriBool isIpFour = URI_FALSE;
+    UriIp4 ip4;
+    UriIp6 ip6;
+
+    URI_FUNC(ResetUri)(uri);
+    if (text == NULL) {
+        return URI_SUCCESS; /* Empty input */
+    }
+
+    if (grammar->fragmentFirst != URI_CHUNK_NONE) {
+        uri->fragment.first = text + grammar->fragmentFirst;
+        uri->fragment.afterLast = text + afterLast;
+        pathAfterLast = grammar->fragmentFirst - 1;
+    }
+    if (grammar->queryFirst != URI_CHUNK_NONE) {
+        uri->query.first = text + grammar->queryFirst;
+        uri->query.afterLast =
+                (grammar->fragmentFirst != URI_CHUNK_NONE) ? uri->fragment.first - 1
+                                                         : text + afterLast;
+        pathAfterLast = grammar->queryFirst - 1;
+    }
+
+    if (grammar->schemeAfterLast != URI_CHUNK_NONE) {
+        uri->scheme.first = text;
+        uri->scheme.afterLast = text + grammar->schemeAfterLast;
+    }
+
+    if (grammar->authorityFirst != URI_CHUNK_NONE) {
+        if (grammar->userInfoAfterLast != URI_CHUNK_NONE) {
+            uri->userInfo.first = text + grammar->authorityFirst;
+            uri->userInfo.afterLast = text + grammar->userInfoAfterLast;
+        }
+        uri->hostText.first = text + grammar->hostFirst;
+        uri->hostText.afterLast = text + grammar->hostAfterLast;
+        if (grammar->portFirst != URI_CHUNK_NONE) {
+            uri->portText.first = text + grammar->portFirst;
+            uri->portText.afterLast = text + grammar->authorityAfterLast;
+        }
+
+        switch (grammar->hostKind) {
+        case URI_CHUNK_HOST_IP_SIX:
+            if (URI_FUNC(ParseIpSixText)(
+                        ip6.data, uri->hostText.first, uri->hostText.afterLast)
+                    != URI_SUCCESS) {
+                /* NOTE: The parser accepted the literal already */
+                URI_FUNC(ResetUri)(uri);
+                return URI_ERROR_SYNTAX;
+            }
+            break;
+
+        case URI_CHUNK_HOST_IP_FUTURE:
+            uri->hostData.ipFuture = uri->hostText; /* IPFUTURE */
+            break;
+
+        default:
+            /* Valid IPv4 or just a regname? */
+            if (URI_FUNC(ParseIpFourAddress)(
+                        ip4.data, uri->hostText.first, uri->hostText.afterLast)
+                    == URI_SUCCESS) {
+                isIpFour = URI_TRUE;
+            }
+            break;
+        }
+    }
+
+    if (grammar->pathFirst != URI_CHUNK_NONE) {
+        size_t pos = grammar->pathFirst;
+        segmentCount = 1;
+        for (; pos < pathAfterLast; pos++) {
+            if (text[pos] == _UT('/')) {
+                segmentCount++;
+            }
+        }
+    }
+
+    if ((segmentCount > 0) || isIpFour
+            || (grammar->hostKind == URI_CHUNK_HOST_IP_SIX)) {
+        const size_t maxCapacity = ((size_t)-1 - sizeof(URI_TYPE(PathSegmentBlock)))
+                                 / sizeof(URI_TYPE(PathSegment));
+        URI_TYPE(PathSegmentBlock) * block = NULL;
+
+        if (segmentCount <= maxCapacity) {
+            block = memory->calloc(memory, 1,
+                    sizeof(URI_TYPE(PathSegmentBlock))
+                            + segmentCount * sizeof(URI_TYPE(PathSegment)));
+        }
+        if (block == NULL) {
+            URI_FUNC(ResetUri)(uri);
+            return URI_ERROR_MALLOC;
+        }
+        block->capacity = segmentCount;
+        block->used = segmentCount;
+        block->segments = (URI_TYPE(PathSegment) *)(block + 1);
+        uri->reserved = block;
+
+        if (isIpFour) {
+            block->host.ip4 = ip4;
+            uri->hostData.ip4 = &block->host.ip4;
+        } else if (grammar->hostKind == URI_CHUNK_HOST_IP_SIX) {
+            block->host.ip6 = ip6;
+            uri->hostData.ip6 = &block->host.ip6;
+        }
+
+        if (segmentCount > 0) {
+            URI_TYPE(PathSegment) * segment = block->segments;
+            size_t segmentFirst = grammar->pathFirst;
+            size_t pos = segmentFirst;
+
+            for (;; pos++) {
+                if ((pos < pathAfterLast) && (text[pos] != _UT('/'))) {
+                    continue;
+                }
+                if (pos == segmentFirst) {
+                    segment->text.first = URI_FUNC(SafeToPointTo);
+                    segment->text.afterLast = URI_FUNC(SafeToPointTo);
+                } else {
+                    segment->text.first = text + segmentFirst;
+                    segment->text.afterLast = text + pos;
+                }
+                if (pos >= pathAfterLast) {
+                    break;
+                }
+                segment->next = segment + 1;
+                segment++;
+                segmentFirst = pos + 1;
+            }
+
+            uri->pathHead = block->segments;
+            uri->pathTail = segment;
+        }
+    }
+
+    uri->absolutePath = grammar->absolutePath;
+    return URI_SUCCESS;
+}
+
+/*
+ * State of an incremental parse, opaque to users of the library.
+ */
+struct URI_TYPE(ChunkParserStateStruct) {
+    URI_TYPE(Uri) * uri; /* filled once the final chunk arrives */
+    int errorCode; /* sticky, 0 if none */
+    size_t errorOffset; /* from the start of input */
+
+    size_t maxLength; /* in characters, 0 for no limit */
+    UriMemoryManager * memory; /* for the state and its text buffer */
+    URI_CHAR * buffer; /* input received so far, pointed to by the URI */
+    size_t length; /* characters received so far */
+    size_t capacity; /* of the buffer in characters */
+
+    URI_TYPE(ChunkGrammar) grammar;
+};
+
+int URI_FUNC(AllocChunkParserStateMm)(URI_TYPE(ChunkParserState) ** state,
+        URI_TYPE(Uri) * uri, size_t maxLength, UriMemoryManager * memory) {
+    URI_TYPE(ChunkParserState) * newState;
+
+    if ((state == NULL) || (uri == NULL)) {
+        return URI_ERROR_NULL;
+    }
+
+    URI_CHECK_MEMORY_MANAGER(memory); /* may return */
+
+    newState = memory->malloc(memory, sizeof(URI_TYPE(ChunkParserState)));
+    if (newState == NULL) {
+        return URI_ERROR_MALLOC;
+    }
+
+    URI_FUNC(ResetUri)(uri);
+    newState->uri = uri;
+    newState->errorCode = URI_SUCCESS;
+    newState->errorOffset = 0;
+    newState->maxLength = maxLength;
+    newState->memory = memory;
+    newState->buffer = NULL;
+    newState->length = 0;
+    newState->capacity = 0;
+    URI_FUNC(InitChunkGrammar)(&newState->grammar);
+
+    *state = newState;
+    return URI_SUCCESS;
+}
+
+static int URI_FUNC(StopChunk)(
+        URI_TYPE(ChunkParserState) * state, int errorCode, size_t errorOffset) {
+    state->errorCode = errorCode;
+    state->errorOffset = errorOffset;
+    return errorCode;
+}
+
+/*
+ * Runs the IPv6 literal received so far, from its host offset up to
+ * offset afterLast, through the IPv6 rule of the parser and returns
+ * the offset of the first syntax error, or URI_CHUNK_NONE if the literal
+ * is fine up to there.
+ */
+static size_t URI_FUNC(CheckIpSixPrefix)(
+        const URI_TYPE(ChunkParserState) * state, size_t afterLast) {
+    const URI_CHAR * errorPos = NULL;
+
+    if ((URI_FUNC(ScanIpSixLiteral)(state->buffer + state->grammar.hostFirst,
+                 state->buffer + afterLast, &errorPos)
+                == URI_SUCCESS)
+            || (errorPos == state->buffer + afterLast)) {
+        return URI_CHUNK_NONE;
+    }
+    return (size_t)(errorPos - state->buffer);
+}
+
+/*
+ * Advances the grammar over the characters received from offset first on.
+ */
+static int URI_FUNC(ScanChunk)(URI_TYPE(ChunkParserState) * state, size_t first) {
+    URI_TYPE(ChunkGrammar) * const grammar = &state->grammar;
+    const URI_CHAR * const text = state->buffer;
+    const size_t afterLast = state->length;
+    size_t pos = first;
+
+    while (pos < afterLast) {
+        UriBool inIpSix;
+        UriBool accepted;
+
+        pos = (size_t)(URI_FUNC(SkipChunkGrammarRun)(grammar, text + pos,
+                               text + afterLast)
+                       - text);
+        if (pos >= afterLast) {
+            break;
+        }
+
+        inIpSix = (grammar->rule == URI_CHUNK_IP_SIX) ? URI_TRUE : URI_FALSE;
+        accepted = URI_FUNC(StepChunkGrammar)(grammar, text[pos], pos);
+
+        /* Check the literal where it ends, an error may be further back */
+        if (inIpSix && ((accepted == URI_FALSE) || (grammar->rule != URI_CHUNK_IP_SIX))) {
+            const size_t errorOffset = URI_FUNC(CheckIpSixPrefix)(state, pos + 1);
+            if (errorOffset != URI_CHUNK_NONE) {
+                return URI_FUNC(StopChunk)(state, URI_ERROR_SYNTAX, errorOffset);
+            }
+        }
+        if (accepted == URI_FALSE) {
+            return URI_FUNC(StopChunk)(state, URI_ERROR_SYNTAX, pos);
+        }
+        pos++;
+    }
+
+    /* Reject a broken IPv6 literal without waiting for its end */
+    if (grammar->rule == URI_CHUNK_IP_SIX) {
+        const size_t errorOffset = URI_FUNC(CheckIpSixPrefix)(state, afterLast);
+        if (errorOffset != URI_CHUNK_NONE) {
+            return URI_FUNC(StopChunk)(state, URI_ERROR_SYNTAX, errorOffset);
+        }
+    }
+
+    return URI_SUCCESS;
+}
+
+
+static UriBool URI_FUNC(AppendChunk)(URI_TYPE(ChunkParserState) * state,
+        const URI_CHAR * first, size_t chunkLength) {
+    UriMemoryManager * const memory = state->memory;
+
+    if (chunkLength > state->capacity - state->length) {
+        size_t newCapacity =
+                (state->capacity < URI_CHUNK_MIN_CAPACITY) ? URI_CHUNK_MIN_CAPACITY
+                                                           : state->capacity;
+        URI_CHAR * newBuffer;
+
+        while (newCapacity - state->length < chunkLength) {
+            /* check for unsigned overflow */
+            if (newCapacity > ((size_t)-1) / 2) {
+                newCapacity = state->length + chunkLength;
+                break;
+            }
+            newCapacity *= 2;
+        }
+
+        newBuffer = memory->reallocarray(
+                memory, state->buffer, newCapacity, sizeof(URI_CHAR));
+        if (newBuffer == NULL) {
+            return URI_FALSE;
+        }
+
+        state->buffer = newBuffer;
+        state->capacity = newCapacity;
+    }
+
+    memcpy(state->buffer + state->length, first, chunkLength * sizeof(URI_CHAR));
+    state->length += chunkLength;
+    return URI_TRUE;
+}
+
+int URI_FUNC(ParseChunk)(URI_TYPE(ChunkParserState) * state, const URI_CHAR * first,
+        const URI_CHAR * afterLast, UriBool isFinal) {
+    size_t chunkLength;
+    int res;
+
+    if ((state == NULL) || ((first == NULL) != (afterLast == NULL))
+            || (first > afterLast)) {
+        return URI_ERROR_NULL;
+    }
+
+    if (state->errorCode != URI_SUCCESS) {
+        return state->errorCode;
+    }
+
+    if (state->grammar.rule == URI_CHUNK_DONE) {
+        return URI_ERROR_PARSECHUNK_FINISHED;
+    }
+
+    chunkLength = (size_t)(afterLast - first);
+
+    if ((state->maxLength != 0) && (chunkLength > state->maxLength - state->length)) {
+        return URI_FUNC(StopChunk)(
+                state, URI_ERROR_PARSECHUNK_TOO_LONG, state->maxLength);
+    }
+
+    if (chunkLength > 0) {
+        const size_t chunkFirst = state->length;
+
+        if (URI_FUNC(AppendChunk)(state, first, chunkLength) == URI_FALSE) {
+            return URI_FUNC(StopChunk)(state, URI_ERROR_MALLOC, 0);
+        }
+
+        res = URI_FUNC(ScanChunk)(state, chunkFirst);
+        if (res != URI_SUCCESS) {
+            return res;
+        }
+    }
+
+    if (isFinal == URI_FALSE) {
+        return URI_SUCCESS;
+    }
+
+    if (URI_FUNC(FinishChunkGrammar)(&state->grammar, state->length) == URI_FALSE) {
+        return URI_FUNC(StopChunk)(state, URI_ERROR_SYNTAX, state->length);
+    }
+
+    res = URI_FUNC(BuildChunkUri)(
+            &state->grammar, state->uri, state->buffer, state->length, state->memory);
+    if (res != URI_SUCCESS) {
+        return URI_FUNC(StopChunk)(state, res,
+                (res == URI_ERROR_SYNTAX) ? state->grammar.hostFirst : 0);
+    }
+    return URI_SUCCESS;
+}
+
+URI_TYPE(Uri) * URI_FUNC(GetChunkParserUri)(const URI_TYPE(ChunkParserState) * state) {
+    return state->uri;
+}
+
+int URI_FUNC(GetChunkParserErrorCode)(const URI_TYPE(ChunkParserState) * state) {
+    return state->errorCode;
+}
+
+size_t URI_FUNC(GetChunkParserErrorOffset)(const URI_TYPE(ChunkParserState) * state) {
+    return state->errorOffset;
+}
+
+void URI_FUNC(FreeChunkParserState)(URI_TYPE(ChunkParserState) * state) {
+    UriMemoryManager * memory;
+
+    if (state == NULL) {
+        return;
+    }
+
+    memory = state->memory;
+    if (state->buffer != NULL) {
+        memory->free(memory, state->buffer);
+    }
+    memory->free(memory, state);
+}
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if (defined(URI_PASS_ANSI) && !defined(URI_PARSE_CHUNK_H_ANSI)) \
+        || (defined(URI_PASS_UNICODE) && !defined(URI_PARSE_CHUNK_H_UNICODE)) \
+        || (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* What encodings are enabled? */
+#  include <uriparser/UriDefsConfig.h>
+#  if (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* Include SELF twice */
+#    ifdef URI_ENABLE_ANSI
+#      define URI_PASS_ANSI 1
+#      include "UriParseChunk.h"
+#      undef URI_PASS_ANSI
+#    endif
+#    ifdef URI_ENABLE_UNICODE
+#      define URI_PASS_UNICODE 1
+#      include "UriParseChunk.h"
+#      undef URI_PASS_UNICODE
+#    endif
+/* Only one pass for each encoding */
+#  elif (defined(URI_PASS_ANSI) && !defined(URI_PARSE_CHUNK_H_ANSI) \
+          && defined(URI_ENABLE_ANSI)) \
+          || (defined(URI_PASS_UNICODE) && !defined(URI_PARSE_CHUNK_H_UNICODE) \
+                  && defined(URI_ENABLE_UNICODE))
+#    ifdef URI_PASS_ANSI
+#      define URI_PARSE_CHUNK_H_ANSI 1
+#      include <uriparser/UriDefsAnsi.h>
+#    else
+#      define URI_PARSE_CHUNK_H_UNICODE 1
+#      include <uriparser/UriDefsUnicode.h>
+#    endif
+
+#    include <stddef.h>
+
+/* Grammar rule being parsed, named after the functions of UriParse.c;
+ * in each of these, the characters received so far form a valid prefix */
+#    define URI_CHUNK_URI_REFERENCE 0
+#    define URI_CHUNK_SEGMENT_NZ_NC_OR_SCHEME 1
+#    define URI_CHUNK_MUST_BE_SEGMENT_NZ_NC 2
+#    define URI_CHUNK_SEGMENT 3 /* any segment after the first, or pathRootless */
+#    define URI_CHUNK_HIER_PART 4
+#    define URI_CHUNK_PART_HELPER_TWO 5 /* right after a leading "/" */
+#    define URI_CHUNK_AUTHORITY 6 /* right after "//" */
+#    define URI_CHUNK_OWN_HOST_USER_INFO 7
+#    define URI_CHUNK_OWN_PORT_USER_INFO 8
+#    define URI_CHUNK_OWN_USER_INFO 9
+#    define URI_CHUNK_OWN_HOST 10 /* right after "@" */
+#    define URI_CHUNK_OWN_HOST_2 11
+#    define URI_CHUNK_IP_LIT_2 12 /* right after "[" */
+#    define URI_CHUNK_IP_FUTURE_VERSION 13 /* right after "v" */
+#    define URI_CHUNK_IP_FUTURE_HEX_ZERO 14
+#    define URI_CHUNK_IP_FUTURE_LOOP_FIRST 15 /* right after "." */
+#    define URI_CHUNK_IP_FUTURE_LOOP 16
+#    define URI_CHUNK_IP_SIX 17
+#    define URI_CHUNK_AUTHORITY_TWO 18 /* right after the host */
+#    define URI_CHUNK_PORT 19
+#    define URI_CHUNK_PATH_ABS_EMPTY 20 /* right after the authority */
+#    define URI_CHUNK_QUERY 21
+#    define URI_CHUNK_FRAGMENT 22
+#    define URI_CHUNK_DONE 23
+
+/* Kind of host, for host data */
+#    define URI_CHUNK_HOST_REG_NAME 0 /* registered name or IPv4 */
+#    define URI_CHUNK_HOST_IP_SIX 1
+#    define URI_CHUNK_HOST_IP_FUTURE 2
+
+/* Offset of a component that has not been found (yet) */
+#    define URI_CHUNK_NONE ((size_t)-1)
+
+/* Grammar of UriParse.c as rules that can be resumed at any character,
+ * with the offsets of the components found so far */
+typedef struct URI_TYPE(ChunkGrammarStruct) {
+    unsigned char rule; /* URI_CHUNK_* grammar rule being parsed */
+    unsigned char pendingHexDigits; /* still due for a "%" */
+    unsigned char hostKind; /* URI_CHUNK_HOST_* */
+    UriBool absolutePath; /* path absolute without authority */
+    size_t schemeAfterLast; /* offset of the ":" after the scheme */
+    size_t authorityFirst; /* after "//" */
+    size_t userInfoAfterLast; /* offset of the "@" after the user info */
+    size_t hostFirst; /* within brackets for IP literals */
+    size_t hostAfterLast;
+    size_t portFirst; /* after ":" */
+    size_t authorityAfterLast;
+    size_t pathFirst; /* first path segment */
+    size_t queryFirst; /* after "?" */
+    size_t fragmentFirst; /* after "#" */
+} URI_TYPE(ChunkGrammar);
+
+void URI_FUNC(InitChunkGrammar)(URI_TYPE(ChunkGrammar) * grammar);
+
+/* Skips characters from first on that leave the grammar as it is,
+ * i.e. plain runs of path, query and fragment. */
+const URI_CHAR * URI_FUNC(SkipChunkGrammarRun)(const URI_TYPE(ChunkGrammar) * grammar,
+        const URI_CHAR * first, const URI_CHAR * afterLast);
+
+/* Advances the grammar by the character c at offset pos, or returns URI_FALSE
+ * if c cannot come next. The text of IPv6 literals is left to the caller to
+ * check using ScanIpSixLiteral, from offset hostFirst on, before leaving
+ * rule URI_CHUNK_IP_SIX and when it returns URI_FALSE there. */
+UriBool URI_FUNC(StepChunkGrammar)(URI_TYPE(ChunkGrammar) * grammar, URI_CHAR c,
+        size_t pos);
+
+/* Ends the rule being parsed at the end of input at offset afterLast,
+ * or returns URI_FALSE if the input cannot end there. */
+UriBool URI_FUNC(FinishChunkGrammar)(URI_TYPE(ChunkGrammar) * grammar, size_t afterLast);
+
+/* Fills uri from the offsets of a finished grammar into text,
+ * with all path segments and IPv4/IPv6 host data in a single block. */
+int URI_FUNC(BuildChunkUri)(const URI_TYPE(ChunkGrammar) * grammar, URI_TYPE(Uri) * uri,
+        const URI_CHAR * text, size_t afterLast, UriMemoryManager * memory);
+
+#  endif
+#endif
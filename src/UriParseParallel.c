@@ -0,0 +1,335 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriParseParallel.c
+ * Holds the parallel batch parser implementation.
+ * NOTE: This source file includes itself twice.
+ */
+
+/* What encodings are enabled? */
+#include <uriparser/UriDefsConfig.h>
+#if (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* Include SELF twice */
+#  ifdef URI_ENABLE_ANSI
+#    define URI_PASS_ANSI 1
+#    include "UriParseParallel.c"
+#    undef URI_PASS_ANSI
+#  endif
+#  ifdef URI_ENABLE_UNICODE
+#    define URI_PASS_UNICODE 1
+#    include "UriParseParallel.c"
+#    undef URI_PASS_UNICODE
+#  endif
+#else
+#  ifdef URI_PASS_ANSI
+#    include <uriparser/UriDefsAnsi.h>
+#  else
+#    include <uriparser/UriDefsUnicode.h>
+#    include <wchar.h>
+#  endif
+
+#  ifndef URI_DOXYGEN
+#    include <uriparser/Uri.h>
+#    include "UriMemory.h"
+#  endif
+
+#  include "UriConfig.h" /* for URIPARSER_ENABLE_THREADS */
+
+#  ifdef URIPARSER_ENABLE_THREADS
+#    include <pthread.h>
+#    define URI_PARALLEL_LOCK(worker) pthread_mutex_lock(&(worker)->mutex)
+#    define URI_PARALLEL_UNLOCK(worker) pthread_mutex_unlock(&(worker)->mutex)
+#  else
+#    define URI_PARALLEL_LOCK(worker) ((void)0)
+#    define URI_PARALLEL_UNLOCK(worker) ((void)0)
+#  endif
+
+/* Number of consecutive items that a worker takes or steals at a time */
+#  define URI_PARALLEL_BLOCK_SIZE 64
+
+typedef struct URI_TYPE(ParallelBatchStruct) {
+    URI_TYPE(Uri) * uris;
+    const URI_CHAR * const * firsts;
+    const URI_CHAR * const * afterLasts;
+    int * errorCodes;
+    const URI_CHAR ** errorPositions;
+    unsigned int * memoryIndices;
+} URI_TYPE(ParallelBatch);
+
+typedef struct URI_TYPE(ParallelWorkerStruct) {
+    const URI_TYPE(ParallelBatch) * batch;
+    struct URI_TYPE(ParallelWorkerStruct) * workers;
+    unsigned int workerCount;
+    unsigned int index;
+    UriMemoryManager * memory;
+
+    /* Items not yet taken; the owner takes from the front,
+     * other workers steal from the back. Guarded by the mutex. */
+    size_t next;
+    size_t afterLast;
+#  ifdef URIPARSER_ENABLE_THREADS
+    pthread_mutex_t mutex;
+#  endif
+
+    /* Earliest block that failed to parse, touched by this worker only */
+    size_t firstFailure;
+    int firstFailureCode;
+} URI_TYPE(ParallelWorker);
+
+static UriBool URI_FUNC(TakeParallelBlock)(URI_TYPE(ParallelWorker) * victim,
+        UriBool fromBack, size_t * first, size_t * afterLast) {
+    UriBool taken = URI_FALSE;
+
+    URI_PARALLEL_LOCK(victim);
+    if (victim->next < victim->afterLast) {
+        const size_t remaining = victim->afterLast - victim->next;
+        const size_t blockSize = (remaining < URI_PARALLEL_BLOCK_SIZE)
+                                         ? remaining
+                                         : URI_PARALLEL_BLOCK_SIZE;
+
+        if (fromBack == URI_TRUE) {
+            *afterLast = victim->afterLast;
+            *first = victim->afterLast - blockSize;
+            victim->afterLast = *first;
+        } else {
+            *first = victim->next;
+            *afterLast = victim->next + blockSize;
+            victim->next = *afterLast;
+        }
+        taken = URI_TRUE;
+    }
+    URI_PARALLEL_UNLOCK(victim);
+
+    return taken;
+}
+
+static void URI_FUNC(ParseParallelBlock)(
+        URI_TYPE(ParallelWorker) * worker, size_t first, size_t afterLast) {
+    const URI_TYPE(ParallelBatch) * const batch = worker->batch;
+    size_t i;
+
+    const int res = URI_FUNC(ParseBatchExMm)(batch->uris + first, batch->firsts + first,
+            (batch->afterLasts != NULL) ? batch->afterLasts + first : NULL,
+            afterLast - first,
+            (batch->errorCodes != NULL) ? batch->errorCodes + first : NULL,
+            (batch->errorPositions != NULL) ? batch->errorPositions + first : NULL,
+            worker->memory);
+
+    /* Blocks do not overlap, so the earliest failing block
+     * holds the earliest failing item */
+    if ((res != URI_SUCCESS) && (first < worker->firstFailure)) {
+        worker->firstFailure = first;
+        worker->firstFailureCode = res;
+    }
+
+    if (batch->memoryIndices != NULL) {
+        for (i = first; i < afterLast; i++) {
+            batch->memoryIndices[i] = worker->index;
+        }
+    }
+}
+
+static void URI_FUNC(RunParallelWorker)(URI_TYPE(ParallelWorker) * worker) {
+    size_t first;
+    size_t afterLast;
+    unsigned int i;
+
+    while (URI_FUNC(TakeParallelBlock)(worker, URI_FALSE, &first, &afterLast)
+            == URI_TRUE) {
+        URI_FUNC(ParseParallelBlock)(worker, first, afterLast);
+    }
+
+    /* Own items are done, help the others */
+    for (i = 1; i < worker->workerCount; i++) {
+        URI_TYPE(ParallelWorker) * const victim =
+                worker->workers + (worker->index + i) % worker->workerCount;
+
+        while (URI_FUNC(TakeParallelBlock)(victim, URI_TRUE, &first, &afterLast)
+                == URI_TRUE) {
+            URI_FUNC(ParseParallelBlock)(worker, first, afterLast);
+        }
+    }
+}
+
+#  ifdef URIPARSER_ENABLE_THREADS
+static void * URI_FUNC(ParallelWorkerMain)(void * arg) {
+    URI_FUNC(RunParallelWorker)((URI_TYPE(ParallelWorker) *)arg);
+    return NULL;
+}
+#  endif
+
+int URI_FUNC(ParseBatchParallelExMm)(URI_TYPE(Uri) * uris,
+        const URI_CHAR * const * firsts, const URI_CHAR * const * afterLasts,
+        size_t count, int * errorCodes, const URI_CHAR ** errorPositions,
+        unsigned int threadCount, UriMemoryManager * const * memories,
+        unsigned int * memoryIndices) {
+    URI_TYPE(ParallelBatch) batch;
+    URI_TYPE(ParallelWorker) * workers;
+    UriMemoryManager * bookkeepingMemory;
+    const size_t blockCount =
+            count / URI_PARALLEL_BLOCK_SIZE + ((count % URI_PARALLEL_BLOCK_SIZE) ? 1 : 0);
+    unsigned int workerCount;
+    unsigned int w;
+    int res = URI_SUCCESS;
+    size_t firstFailure = (size_t)-1;
+
+    /* Check params */
+    if ((count > 0) && ((uris == NULL) || (firsts == NULL))) {
+        return URI_ERROR_NULL;
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    for (w = 0; w < threadCount; w++) {
+        if ((memories != NULL) && (memories[w] != NULL)
+                && (uriMemoryManagerIsComplete(memories[w]) != URI_TRUE)) {
+            return URI_ERROR_MEMORY_MANAGER_INCOMPLETE;
+        }
+    }
+
+    if (count == 0) {
+        return URI_SUCCESS;
+    }
+
+    /* No need for more workers than blocks */
+    workerCount = (blockCount < threadCount) ? (unsigned int)blockCount : threadCount;
+
+    bookkeepingMemory = ((memories != NULL) && (memories[0] != NULL))
+                                ? memories[0]
+                                : &defaultMemoryManager;
+    workers = bookkeepingMemory->malloc(
+            bookkeepingMemory, workerCount * sizeof(URI_TYPE(ParallelWorker)));
+    if (workers == NULL) {
+        return URI_ERROR_MALLOC;
+    }
+
+    batch.uris = uris;
+    batch.firsts = firsts;
+    batch.afterLasts = afterLasts;
+    batch.errorCodes = errorCodes;
+    batch.errorPositions = errorPositions;
+    batch.memoryIndices = memoryIndices;
+
+#  ifdef URIPARSER_ENABLE_THREADS
+    for (w = 0; w < workerCount; w++) {
+        if (pthread_mutex_init(&workers[w].mutex, NULL) != 0) {
+            break;
+        }
+    }
+    if (w == 0) {
+        bookkeepingMemory->free(bookkeepingMemory, workers);
+        return URI_ERROR_MALLOC;
+    }
+    workerCount = w; /* mutexes for all workers left */
+#  else
+    workerCount = 1;
+#  endif
+
+    /* Hand out contiguous runs of items, as evenly as possible */
+    for (w = 0; w < workerCount; w++) {
+        URI_TYPE(ParallelWorker) * const worker = workers + w;
+        const size_t share = count / workerCount;
+        const size_t extra = count % workerCount;
+
+        worker->batch = &batch;
+        worker->workers = workers;
+        worker->workerCount = workerCount;
+        worker->index = w;
+        worker->memory = ((memories != NULL) && (memories[w] != NULL))
+                                 ? memories[w]
+                                 : &defaultMemoryManager;
+        worker->next = share * w + ((w < extra) ? w : extra);
+        worker->afterLast = worker->next + share + ((w < extra) ? 1 : 0);
+        worker->firstFailure = (size_t)-1;
+        worker->firstFailureCode = URI_SUCCESS;
+    }
+
+#  ifdef URIPARSER_ENABLE_THREADS
+    {
+        pthread_t * const threads = bookkeepingMemory->malloc(
+                bookkeepingMemory, workerCount * sizeof(pthread_t));
+        UriBool * const started = bookkeepingMemory->calloc(
+                bookkeepingMemory, workerCount, sizeof(UriBool));
+
+        /* NOTE: Workers that cannot be started or allocated for
+         *       get their items stolen by the others, so this cannot fail. */
+        if ((threads != NULL) && (started != NULL)) {
+            for (w = 1; w < workerCount; w++) {
+                started[w] = (pthread_create(threads + w, NULL,
+                                      URI_FUNC(ParallelWorkerMain), workers + w)
+                                     == 0)
+                                     ? URI_TRUE
+                                     : URI_FALSE;
+            }
+        }
+
+        /* The calling thread is worker 0 */
+        URI_FUNC(RunParallelWorker)(workers);
+
+        if ((threads != NULL) && (started != NULL)) {
+            for (w = 1; w < workerCount; w++) {
+                if (started[w] == URI_TRUE) {
+                    pthread_join(threads[w], NULL);
+                }
+            }
+        }
+
+        bookkeepingMemory->free(bookkeepingMemory, threads);
+        bookkeepingMemory->free(bookkeepingMemory, started);
+    }
+#  else
+    URI_FUNC(RunParallelWorker)(workers);
+#  endif
+
+    for (w = 0; w < workerCount; w++) {
+        if (workers[w].firstFailure < firstFailure) {
+            firstFailure = workers[w].firstFailure;
+            res = workers[w].firstFailureCode;
+        }
+#  ifdef URIPARSER_ENABLE_THREADS
+        pthread_mutex_destroy(&workers[w].mutex);
+#  endif
+    }
+
+    bookkeepingMemory->free(bookkeepingMemory, workers);
+
+    return res;
+}
+
+#endif
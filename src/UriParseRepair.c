@@ -0,0 +1,423 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriParseRepair.c
+ * Holds the parse-and-repair implementation.
+ * NOTE: This source file includes itself twice.
+ */
+
+/* What encodings are enabled? */
+#include <uriparser/UriDefsConfig.h>
+#if (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* Include SELF twice */
+#  ifdef URI_ENABLE_ANSI
+#    define URI_PASS_ANSI 1
+#    include "UriParseRepair.c"
+#    undef URI_PASS_ANSI
+#  endif
+#  ifdef URI_ENABLE_UNICODE
+#    define URI_PASS_UNICODE 1
+#    include "UriParseRepair.c"
+#    undef URI_PASS_UNICODE
+#  endif
+#else
+#  ifdef URI_PASS_ANSI
+#    include <uriparser/UriDefsAnsi.h>
+#  else
+#    include <uriparser/UriDefsUnicode.h>
+#    include <wchar.h>
+#  endif
+
+#  ifndef URI_DOXYGEN
+#    include <uriparser/Uri.h>
+#    include "UriCharClass.h"
+#    include "UriCommon.h"
+#    include "UriMemory.h"
+#    include "UriParseChunk.h"
+#  endif
+
+#  include <limits.h> /* for INT_MAX */
+#  include <string.h> /* for memcpy */
+
+/*
+ * Repair in progress: the grammar of UriParseChunk.c is run over the
+ * repaired copy as it is written, with offsets into that copy. Until the
+ * first character that needs percent-encoding, the copy is the input itself.
+ */
+typedef struct URI_TYPE(RepairStateStruct) {
+    URI_TYPE(ChunkGrammar) grammar;
+    const URI_CHAR * read; /* next character of input */
+    const URI_CHAR * first;
+    const URI_CHAR * afterLast;
+    URI_CHAR * out;
+    size_t outRoom; /* characters that fit into out before the terminator */
+    size_t length; /* of the copy so far, can exceed outRoom */
+    UriBool copying; /* whether the copy is in out rather than the input */
+    const URI_CHAR * lastAt; /* last "@" of the authority, NULL if none */
+    const URI_CHAR * ipSixFirst; /* input text of an IPv6 literal */
+} URI_TYPE(RepairState);
+
+static UriBool URI_FUNC(IsPctEncodedAt)(
+        const URI_CHAR * read, const URI_CHAR * afterLast) {
+    return ((afterLast - read >= 3) && URI_CHAR_IS(read[1], URI_CLASS_HEXDIG)
+                   && URI_CHAR_IS(read[2], URI_CLASS_HEXDIG))
+                   ? URI_TRUE
+                   : URI_FALSE;
+}
+
+/*
+ * Switches the copy over to out, from the input it was identical to.
+ */
+static void URI_FUNC(StartCopy)(URI_TYPE(RepairState) * state) {
+    if (state->copying == URI_FALSE) {
+        const size_t fit =
+                (state->length < state->outRoom) ? state->length : state->outRoom;
+        memcpy(state->out, state->first, fit * sizeof(URI_CHAR));
+        state->copying = URI_TRUE;
+    }
+}
+
+/*
+ * Appends count characters from input as is.
+ */
+static void URI_FUNC(CopyAsIs)(
+        URI_TYPE(RepairState) * state, const URI_CHAR * first, size_t count) {
+    if (state->copying && (state->length < state->outRoom)) {
+        const size_t room = state->outRoom - state->length;
+        memcpy(state->out + state->length, first,
+                ((count < room) ? count : room) * sizeof(URI_CHAR));
+    }
+    state->length += count;
+}
+
+static void URI_FUNC(AppendChar)(URI_TYPE(RepairState) * state, URI_CHAR c) {
+    if (state->length < state->outRoom) {
+        state->out[state->length] = c;
+    }
+    state->length++;
+}
+
+/*
+ * Remembers where the authority just entered ends user info,
+ * so that any "@" before that can be told to be part of it.
+ */
+static void URI_FUNC(FindLastAt)(URI_TYPE(RepairState) * state) {
+    const URI_CHAR * walker = state->read + 1;
+
+    state->lastAt = NULL;
+    for (; walker < state->afterLast; walker++) {
+        switch (walker[0]) {
+        case _UT('@'):
+            state->lastAt = walker;
+            break;
+
+        case _UT('/'):
+        case _UT('?'):
+        case _UT('#'):
+            return;
+
+        default:
+            break;
+        }
+    }
+}
+
+static UriBool URI_FUNC(IsAtAhead)(const URI_TYPE(RepairState) * state) {
+    return ((state->lastAt != NULL) && (state->read <= state->lastAt)) ? URI_TRUE
+                                                                       : URI_FALSE;
+}
+
+/*
+ * Whether the character at state->read is allowed as is but must not be
+ * taken for a delimiter: a "%" not starting a percent-encoded triplet,
+ * or an "@" inside user info.
+ */
+static UriBool URI_FUNC(NeedsEscaping)(const URI_TYPE(RepairState) * state) {
+    switch (state->read[0]) {
+    case _UT('%'):
+        return URI_FUNC(IsPctEncodedAt)(state->read, state->afterLast) ? URI_FALSE
+                                                                       : URI_TRUE;
+
+    case _UT('@'):
+        switch (state->grammar.rule) {
+        case URI_CHUNK_AUTHORITY:
+        case URI_CHUNK_OWN_HOST_USER_INFO:
+        case URI_CHUNK_OWN_PORT_USER_INFO:
+        case URI_CHUNK_OWN_USER_INFO:
+            return ((state->lastAt != NULL) && (state->read < state->lastAt))
+                           ? URI_TRUE
+                           : URI_FALSE;
+
+        default:
+            return URI_FALSE;
+        }
+
+    default:
+        return URI_FALSE;
+    }
+}
+
+/*
+ * Feeds c to the grammar at the end of the copy. A port cannot turn
+ * into user info without an "@" to follow, ports are copied as is.
+ */
+static UriBool URI_FUNC(StepRepair)(URI_TYPE(RepairState) * state, URI_CHAR c) {
+    if (URI_FUNC(StepChunkGrammar)(&state->grammar, c, state->length) == URI_FALSE) {
+        return URI_FALSE;
+    }
+    if (state->grammar.rule == URI_CHUNK_OWN_USER_INFO) {
+        return URI_FUNC(IsAtAhead)(state);
+    }
+    return URI_TRUE;
+}
+
+/*
+ * Appends the code point at state->read percent-encoded (in uppercase,
+ * like uriEscapeExA does) where the grammar accepts that.
+ * NOTE: With wchar_t, characters beyond ASCII are percent-encoded as UTF-8,
+ *       like uriToStringAsUriW does.
+ */
+static UriBool URI_FUNC(AppendEscaped)(URI_TYPE(RepairState) * state) {
+    const URI_TYPE(ChunkGrammar) backup = state->grammar;
+    const URI_CHAR * walker = state->read;
+    unsigned char utf8[4];
+    const int utf8Length = URI_FUNC(NextCodePointUtf8)(&walker, state->afterLast, utf8);
+
+    /* NOTE: Once a "%" is accepted, the rest of the triplets are, too */
+    if (URI_FUNC(StepRepair)(state, _UT('%')) == URI_FALSE) {
+        state->grammar = backup;
+        return URI_FALSE;
+    }
+
+    URI_FUNC(StartCopy)(state);
+    for (int i = 0; i < utf8Length; i++) {
+        const URI_CHAR triplet[3] = {_UT('%'),
+                URI_FUNC(HexToLetterEx)(utf8[i] >> 4, URI_TRUE),
+                URI_FUNC(HexToLetterEx)(utf8[i] & 0x0f, URI_TRUE)};
+        for (int k = 0; k < 3; k++) {
+            if ((i > 0) || (k > 0)) {
+                URI_FUNC(StepChunkGrammar)(&state->grammar, triplet[k], state->length);
+            }
+            URI_FUNC(AppendChar)(state, triplet[k]);
+        }
+    }
+
+    state->read = walker;
+    return URI_TRUE;
+}
+
+/*
+ * Runs the IPv6 literal read so far through the IPv6 rule of the parser,
+ * and returns the offset into the copy of the first syntax error,
+ * or URI_CHUNK_NONE if the literal is fine up to there.
+ * NOTE: Literals are copied as is, so that offsets map one to one.
+ */
+static size_t URI_FUNC(CheckIpSixLiteral)(
+        const URI_TYPE(RepairState) * state, const URI_CHAR * afterLast) {
+    const URI_CHAR * errorPos = NULL;
+
+    if ((URI_FUNC(ScanIpSixLiteral)(state->ipSixFirst, afterLast, &errorPos)
+                == URI_SUCCESS)
+            || (errorPos == afterLast)) {
+        return URI_CHUNK_NONE;
+    }
+    return state->grammar.hostFirst + (size_t)(errorPos - state->ipSixFirst);
+}
+
+/*
+ * Writes a copy of the input with all characters percent-encoded that
+ * are not allowed where they are, while running the grammar over it.
+ * Returns URI_ERROR_SYNTAX for errors that percent-encoding cannot fix,
+ * e.g. in scheme, IP literals and port, with *errorOffset into the copy
+ * and state->read at the character not copied yet.
+ */
+static int URI_FUNC(RepairUri)(URI_TYPE(RepairState) * state, size_t * errorOffset) {
+    URI_TYPE(ChunkGrammar) * const grammar = &state->grammar;
+
+    while (state->read < state->afterLast) {
+        const URI_CHAR * const afterRun =
+                URI_FUNC(SkipChunkGrammarRun)(grammar, state->read, state->afterLast);
+        URI_FUNC(CopyAsIs)(state, state->read, (size_t)(afterRun - state->read));
+        state->read = afterRun;
+        if (state->read >= state->afterLast) {
+            break;
+        }
+
+        if (grammar->rule == URI_CHUNK_IP_SIX) {
+            /* Literals are copied as is, check where they end */
+            const UriBool accepted =
+                    URI_FUNC(StepChunkGrammar)(grammar, state->read[0], state->length);
+            if ((accepted == URI_FALSE) || (grammar->rule != URI_CHUNK_IP_SIX)) {
+                *errorOffset = URI_FUNC(CheckIpSixLiteral)(state, state->read + 1);
+                if (*errorOffset != URI_CHUNK_NONE) {
+                    return URI_ERROR_SYNTAX;
+                }
+            }
+            if (accepted == URI_FALSE) {
+                *errorOffset = state->length;
+                return URI_ERROR_SYNTAX;
+            }
+        } else if (URI_FUNC(NeedsEscaping)(state) == URI_FALSE) {
+            const URI_TYPE(ChunkGrammar) backup = *grammar;
+            if (URI_FUNC(StepRepair)(state, state->read[0]) == URI_FALSE) {
+                *grammar = backup;
+                if (URI_FUNC(AppendEscaped)(state) == URI_FALSE) {
+                    *errorOffset = state->length;
+                    return URI_ERROR_SYNTAX;
+                }
+                continue;
+            }
+
+            if (grammar->rule != backup.rule) {
+                if (grammar->rule == URI_CHUNK_AUTHORITY) {
+                    URI_FUNC(FindLastAt)(state);
+                } else if (grammar->rule == URI_CHUNK_IP_LIT_2) {
+                    state->ipSixFirst = state->read + 1;
+                }
+            }
+        } else {
+            if (URI_FUNC(AppendEscaped)(state) == URI_FALSE) {
+                *errorOffset = state->length;
+                return URI_ERROR_SYNTAX;
+            }
+            continue;
+        }
+
+        URI_FUNC(CopyAsIs)(state, state->read, 1);
+        state->read++;
+    }
+
+    /* Input ending inside an IPv6 literal */
+    if (grammar->rule == URI_CHUNK_IP_SIX) {
+        *errorOffset = URI_FUNC(CheckIpSixLiteral)(state, state->afterLast);
+        if (*errorOffset != URI_CHUNK_NONE) {
+            return URI_ERROR_SYNTAX;
+        }
+    }
+
+    if (URI_FUNC(FinishChunkGrammar)(grammar, state->length) == URI_FALSE) {
+        *errorOffset = state->length;
+        return URI_ERROR_SYNTAX;
+    }
+    return URI_SUCCESS;
+}
+
+int URI_FUNC(ParseSingleUriRepairMm)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
+        const URI_CHAR * afterLast, URI_CHAR * out, int outCapacity, int * charsRequired,
+        UriBool * repaired, const URI_CHAR ** errorPos, UriMemoryManager * memory) {
+    URI_TYPE(RepairState) state;
+    size_t errorOffset = 0;
+    int res;
+
+    if ((uri == NULL) || (first == NULL) || (afterLast == NULL) || (out == NULL)) {
+        return URI_ERROR_NULL;
+    }
+
+    URI_CHECK_MEMORY_MANAGER(memory); /* may return */
+
+    if (repaired != NULL) {
+        *repaired = URI_FALSE;
+    }
+    if (charsRequired != NULL) {
+        *charsRequired = 0;
+    }
+    URI_FUNC(ResetUri)(uri);
+
+    URI_FUNC(InitChunkGrammar)(&state.grammar);
+    state.read = first;
+    state.first = first;
+    state.afterLast = afterLast;
+    state.out = out;
+    state.outRoom = (outCapacity > 0) ? (size_t)outCapacity - 1 : 0;
+    state.length = 0;
+    state.copying = URI_FALSE;
+    state.lastAt = NULL;
+    state.ipSixFirst = NULL;
+
+    res = URI_FUNC(RepairUri)(&state, &errorOffset);
+    if (res != URI_SUCCESS) {
+        /* Keep the rest as is, for the error position to point into */
+        URI_FUNC(StartCopy)(&state);
+        URI_FUNC(CopyAsIs)(&state, state.read, (size_t)(afterLast - state.read));
+    }
+
+    if (state.copying) {
+        if (state.length > (size_t)INT_MAX) {
+            return URI_ERROR_OUTPUT_TOO_LARGE;
+        }
+        if (charsRequired != NULL) {
+            *charsRequired = (int)state.length;
+        }
+        if ((outCapacity <= 0) || (state.length > state.outRoom)) {
+            return URI_ERROR_OUTPUT_TOO_LARGE;
+        }
+        out[state.length] = _UT('\0');
+    }
+
+    if (res != URI_SUCCESS) {
+        if (errorPos != NULL) {
+            *errorPos = out + errorOffset;
+        }
+        return res;
+    }
+
+    /* Clean input is parsed in place */
+    res = URI_FUNC(BuildChunkUri)(&state.grammar, uri, state.copying ? out : first,
+            state.length, memory);
+    if (res == URI_ERROR_SYNTAX) {
+        if (errorPos != NULL) {
+            *errorPos = (state.copying ? out : first) + state.grammar.hostFirst;
+        }
+    } else if ((res == URI_SUCCESS) && state.copying && (repaired != NULL)) {
+        *repaired = URI_TRUE;
+    }
+    return res;
+}
+
+int URI_FUNC(ParseSingleUriRepair)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
+        const URI_CHAR * afterLast, URI_CHAR * out, int outCapacity, int * charsRequired,
+        UriBool * repaired, const URI_CHAR ** errorPos) {
+    if ((first != NULL) && (afterLast == NULL)) {
+        afterLast = first + URI_STRLEN(first);
+    }
+    return URI_FUNC(ParseSingleUriRepairMm)(uri, first, afterLast, out, outCapacity,
+            charsRequired, repaired, errorPos, NULL);
+}
+
+#endif
@@ -403,10 +403,15 @@ static URI_INLINE int URI_FUNC(ToStringEngine)(URI_CHAR * dest, const URI_TYPE(U
 
                             (*charsRequired) += 1;
                         }
-                    } else if (uri->hostData.ipFuture.first != NULL) {
-                        /* IPvFuture */
-                        const size_t charsToWrite = uri->hostData.ipFuture.afterLast
-                                                    - uri->hostData.ipFuture.first;
+                    } else if ((uri->hostData.ipFuture.first != NULL)
+                               || URI_FUNC(IsHostIpSixText)(uri)) {
+                        /* IPvFuture, or IPv6 without host data */
+                        const URI_TYPE(TextRange) * const ipLiteral =
+                                (uri->hostData.ipFuture.first != NULL)
+                                        ? &uri->hostData.ipFuture
+                                        : &uri->hostText;
+                        const size_t charsToWrite =
+                                ipLiteral->afterLast - ipLiteral->first;
                         if (dest != NULL) {
                             if (written + 1 <= maxChars) {
                                 memcpy(dest + written, _UT("["), 1 * sizeof(URI_CHAR));
@@ -430,7 +435,7 @@ static URI_INLINE int URI_FUNC(ToStringEngine)(URI_CHAR * dest, const URI_TYPE(U
                                     return URI_ERROR_TOSTRING_TOO_LONG;
                                 }
 
-                                memcpy(dest + written, uri->hostData.ipFuture.first,
+                                memcpy(dest + written, ipLiteral->first,
                                         charsToWrite * sizeof(URI_CHAR));
                                 written += charsToWrite;
                             } else {
@@ -785,4 +790,121 @@ static URI_INLINE int URI_FUNC(ToStringEngine)(URI_CHAR * dest, const URI_TYPE(U
     }
 }
 
+static URI_INLINE unsigned long URI_FUNC(CodeUnitValue)(URI_CHAR c) {
+#  ifdef URI_PASS_ANSI
+    return (unsigned char)c;
+#  else
+    return (unsigned long)c;
+#  endif
+}
+
+/*
+ * Returns how many characters longer [first, afterLast) gets when
+ * percent-encoding all non-ASCII characters as UTF-8.
+ */
+static size_t URI_FUNC(ExtraCharsAsUri)(
+        const URI_CHAR * first, const URI_CHAR * afterLast) {
+    size_t extra = 0;
+    const URI_CHAR * walker = first;
+    while (walker < afterLast) {
+        const URI_CHAR * const before = walker;
+        unsigned char utf8[4];
+        const int utf8Length = URI_FUNC(NextCodePointUtf8)(&walker, afterLast, utf8);
+        if (utf8[0] >= 0x80) {
+            extra += 3 * (size_t)utf8Length - (size_t)(walker - before);
+        }
+    }
+    return extra;
+}
+
+static size_t URI_FUNC(ExtraCharsAsUriRange)(const URI_TYPE(TextRange) * range) {
+    if ((range->first == NULL) || (range->afterLast == NULL)) {
+        return 0;
+    }
+    return URI_FUNC(ExtraCharsAsUri)(range->first, range->afterLast);
+}
+
+int URI_FUNC(ToStringAsUriCharsRequired)(
+        const URI_TYPE(Uri) * uri, int * charsRequired) {
+    const int res = URI_FUNC(ToStringCharsRequired)(uri, charsRequired);
+    if (res != URI_SUCCESS) {
+        return res;
+    }
+
+    size_t extra = URI_FUNC(ExtraCharsAsUriRange)(&uri->userInfo)
+            + URI_FUNC(ExtraCharsAsUriRange)(&uri->hostText)
+            + URI_FUNC(ExtraCharsAsUriRange)(&uri->query)
+            + URI_FUNC(ExtraCharsAsUriRange)(&uri->fragment);
+    const URI_TYPE(PathSegment) * walker = uri->pathHead;
+    for (; walker != NULL; walker = walker->next) {
+        extra += URI_FUNC(ExtraCharsAsUriRange)(&walker->text);
+    }
+
+    // Detect and avoid integer overflow
+    if (extra > (size_t)INT_MAX - *charsRequired) {
+        return URI_ERROR_TOSTRING_TOO_LONG;
+    }
+
+    *charsRequired += (int)extra;
+    return URI_SUCCESS;
+}
+
+int URI_FUNC(ToStringAsUri)(
+        URI_CHAR * dest, const URI_TYPE(Uri) * uri, int maxChars, int * charsWritten) {
+    int written = 0;
+    const int res = URI_FUNC(ToString)(dest, uri, maxChars, &written);
+    if (res != URI_SUCCESS) {
+        if (charsWritten != NULL) {
+            *charsWritten = written;
+        }
+        return res;
+    }
+
+    /* Percent-encode in place, back to front */
+    const URI_CHAR * read = dest + written - 1; /* at terminator */
+    const size_t extra = URI_FUNC(ExtraCharsAsUri)(dest, read);
+    if (extra > (size_t)(maxChars - written)) {
+        dest[0] = _UT('\0');
+        if (charsWritten != NULL) {
+            *charsWritten = 0;
+        }
+        return URI_ERROR_TOSTRING_TOO_LONG;
+    }
+
+    URI_CHAR * write = dest + written - 1 + extra;
+    write[0] = _UT('\0');
+    while (read > dest) {
+        read--;
+        if (URI_FUNC(CodeUnitValue)(read[0]) < 0x80) {
+            write--;
+            write[0] = read[0];
+            continue;
+        }
+
+#  ifdef URI_PASS_UNICODE
+        if (((unsigned long)read[0] >= 0xDC00) && ((unsigned long)read[0] <= 0xDFFF)
+                && (read > dest) && ((unsigned long)read[-1] >= 0xD800)
+                && ((unsigned long)read[-1] <= 0xDBFF)) {
+            read--;
+        }
+#  endif
+        const URI_CHAR * walker = read;
+        unsigned char utf8[4];
+        const int utf8Length =
+                URI_FUNC(NextCodePointUtf8)(&walker, dest + written - 1, utf8);
+
+        write -= 3 * utf8Length;
+        for (int i = 0; i < utf8Length; i++) {
+            write[3 * i] = _UT('%');
+            write[3 * i + 1] = URI_FUNC(HexToLetterEx)(utf8[i] >> 4, URI_TRUE);
+            write[3 * i + 2] = URI_FUNC(HexToLetterEx)(utf8[i] & 0x0f, URI_TRUE);
+        }
+    }
+
+    if (charsWritten != NULL) {
+        *charsWritten = written + (int)extra;
+    }
+    return URI_SUCCESS;
+}
+
 #endif
@@ -380,14 +380,42 @@ int URI_FUNC(AddBaseUriEx)(URI_TYPE(Uri) * absDest, const URI_TYPE(Uri) * relSou
 int URI_FUNC(AddBaseUriExMm)(URI_TYPE(Uri) * absDest, const URI_TYPE(Uri) * relSource,
         const URI_TYPE(Uri) * absBase, UriResolutionOptions options,
         UriMemoryManager * memory) {
+    URI_TYPE(Uri) splitRelSource;
+    URI_TYPE(Uri) splitAbsBase;
+    const UriBool relSourceLazy = URI_FUNC(IsPathLazy)(relSource);
+    const UriBool absBaseLazy = URI_FUNC(IsPathLazy)(absBase);
     int res;
 
     URI_CHECK_MEMORY_MANAGER(memory); /* may return */
 
+    /* Work on split copies of lazy paths, see ParseSingleUriExLazyMm */
+    if (relSourceLazy) {
+        if (!URI_FUNC(MaterializePathShallow)(&splitRelSource, relSource, memory)) {
+            return URI_ERROR_MALLOC;
+        }
+        relSource = &splitRelSource;
+    }
+    if (absBaseLazy) {
+        if (!URI_FUNC(MaterializePathShallow)(&splitAbsBase, absBase, memory)) {
+            if (relSourceLazy) {
+                URI_FUNC(FreeUriPath)(&splitRelSource, memory);
+            }
+            return URI_ERROR_MALLOC;
+        }
+        absBase = &splitAbsBase;
+    }
+
     res = URI_FUNC(AddBaseUriImpl)(absDest, relSource, absBase, options, memory);
     if ((res != URI_SUCCESS) && (absDest != NULL)) {
         URI_FUNC(FreeUriMembersMm)(absDest, memory);
     }
+
+    if (relSourceLazy) {
+        URI_FUNC(FreeUriPath)(&splitRelSource, memory);
+    }
+    if (absBaseLazy) {
+        URI_FUNC(FreeUriPath)(&splitAbsBase, memory);
+    }
     return res;
 }
 
@@ -153,13 +153,7 @@ int URI_FUNC(InternalSetHostMm)(URI_TYPE(Uri) * uri, UriHostType hostType,
         uri->hostText.afterLast = NULL;
     }
 
-    if (uri->hostData.ip4 != NULL) {
-        memory->free(memory, uri->hostData.ip4);
-        uri->hostData.ip4 = NULL;
-    } else if (uri->hostData.ip6 != NULL) {
-        memory->free(memory, uri->hostData.ip6);
-        uri->hostData.ip6 = NULL;
-    }
+    URI_FUNC(FreeHostData)(uri, memory);
 
     /* Already done setting? */
     if (first == NULL) {
@@ -203,7 +197,7 @@ int URI_FUNC(InternalSetHostMm)(URI_TYPE(Uri) * uri, UriHostType hostType,
     /* Fill .hostData as needed */
     switch (hostType) {
     case URI_HOST_TYPE_IP4: {
-        uri->hostData.ip4 = memory->malloc(memory, sizeof(UriIp4));
+        uri->hostData.ip4 = URI_FUNC(AllocateHostIp4)(uri, memory);
         if (uri->hostData.ip4 == NULL) {
             return URI_ERROR_MALLOC;
         }
@@ -217,7 +211,7 @@ int URI_FUNC(InternalSetHostMm)(URI_TYPE(Uri) * uri, UriHostType hostType,
 #  endif
     } break;
     case URI_HOST_TYPE_IP6: {
-        uri->hostData.ip6 = memory->malloc(memory, sizeof(UriIp6));
+        uri->hostData.ip6 = URI_FUNC(AllocateHostIp6)(uri, memory);
         if (uri->hostData.ip6 == NULL) {
             return URI_ERROR_MALLOC;
         }
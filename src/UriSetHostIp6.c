@@ -60,18 +60,14 @@
 
 #  ifndef URI_DOXYGEN
 #    include <uriparser/Uri.h>
+#    include "UriCommon.h"
 #    include "UriMemory.h"
 #    include "UriSetHostBase.h"
 #    include "UriSetHostCommon.h"
 #  endif
 
-#  include <assert.h>
 #  include <string.h> /* for memcpy */
 
-#  define URI_MAX_IP6_LEN \
-      (8 * 4 + 7 * 1) /* i.e. 8 full quads plus 7 colon separators \
-                       */
-
 int URI_FUNC(ParseIpSixAddressMm)(UriIp6 * output, const URI_CHAR * first,
         const URI_CHAR * afterLast, UriMemoryManager * memory) {
     /* NOTE: output is allowed to be NULL */
@@ -81,54 +77,17 @@ int URI_FUNC(ParseIpSixAddressMm)(UriIp6 * output, const URI_CHAR * first,
 
     URI_CHECK_MEMORY_MANAGER(memory); /* may return */
 
-    /* Are we dealing with potential IPvFuture input? */
-    if (first < afterLast) {
-        switch (first[0]) {
-        case _UT('v'):
-        case _UT('V'):
-            return URI_ERROR_SYNTAX;
-        default:
-            break;
-        }
-    }
-
-    /* Are we dealing with IPv6 input? */
-    /* Assemble "//[..]" input wrap for upcoming parse as a URI
-     * NOTE: If the input contains closing "]" on its own, the resulting
-     *       string will not be valid URI syntax, and hence there is
-     *       no risk of false positives from "bracket injection". */
-    URI_CHAR candidate[3 + URI_MAX_IP6_LEN + 1 + 1] = _UT("//[");
-    const size_t inputLenChars = (afterLast - first);
-
-    /* Detect overflow */
-    if (inputLenChars > URI_MAX_IP6_LEN) {
+    /* NOTE: IPvFuture input is rejected right away for its leading "v" */
+    UriIp6 ip6;
+    if (URI_FUNC(ParseIpSixText)(ip6.data, first, afterLast) != URI_SUCCESS) {
         return URI_ERROR_SYNTAX;
     }
 
-    memcpy(candidate + 3, first, inputLenChars * sizeof(URI_CHAR));
-    memcpy(candidate + 3 + inputLenChars, _UT("]"),
-            2 * sizeof(URI_CHAR)); /* includes zero terminator */
-
-    /* Parse as an RFC 3986 URI */
-    const size_t candidateLenChars = 3 + inputLenChars + 1;
-    URI_TYPE(Uri) uri;
-    const int res = URI_FUNC(ParseSingleUriExMm)(
-            &uri, candidate, candidate + candidateLenChars, NULL, memory);
-
-    assert((res == URI_SUCCESS) || (res == URI_ERROR_SYNTAX)
-            || (res == URI_ERROR_MALLOC));
-
-    if (res == URI_SUCCESS) {
-        assert(uri.hostData.ip6 != NULL);
-
-        if (output != NULL) {
-            memcpy(output->data, uri.hostData.ip6->data, sizeof(output->data));
-        }
-
-        URI_FUNC(FreeUriMembersMm)(&uri, memory);
+    if (output != NULL) {
+        memcpy(output->data, ip6.data, sizeof(output->data));
     }
 
-    return res;
+    return URI_SUCCESS;
 }
 
 int URI_FUNC(ParseIpSixAddress)(
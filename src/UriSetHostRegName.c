@@ -60,10 +60,11 @@
 
 #  ifndef URI_DOXYGEN
 #    include <uriparser/Uri.h>
+#    include "UriCharClass.h"
+#    include "UriCommon.h"
 #    include "UriMemory.h"
 #    include "UriSetHostBase.h"
 #    include "UriSetHostCommon.h"
-#    include "UriSets.h"
 #  endif
 
 UriBool URI_FUNC(IsWellFormedHostRegName)(
@@ -73,41 +74,8 @@ UriBool URI_FUNC(IsWellFormedHostRegName)(
     }
 
     /* reg-name = *( unreserved / pct-encoded / sub-delims ) */
-    while (first < afterLast) {
-        switch (first[0]) {
-        case URI_SET_UNRESERVED(_UT):
-            break;
-
-        /* pct-encoded */
-        case _UT('%'):
-            if (afterLast - first < 3) {
-                return URI_FALSE;
-            }
-            switch (first[1]) {
-            case URI_SET_HEXDIG(_UT):
-                break;
-            default:
-                return URI_FALSE;
-            }
-            switch (first[2]) {
-            case URI_SET_HEXDIG(_UT):
-                break;
-            default:
-                return URI_FALSE;
-            }
-            first += 2;
-            break;
-
-        case URI_SET_SUB_DELIMS(_UT):
-            break;
-
-        default:
-            return URI_FALSE;
-        }
-
-        first++;
-    }
-    return URI_TRUE;
+    return URI_FUNC(IsCharClassOrPctEncoded)(
+            first, afterLast, URI_CLASS_UNRESERVED | URI_CLASS_SUB_DELIMS);
 }
 
 int URI_FUNC(SetHostRegNameMm)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
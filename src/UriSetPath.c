@@ -60,9 +60,9 @@
 
 #  ifndef URI_DOXYGEN
 #    include <uriparser/Uri.h>
+#    include "UriCharClass.h"
 #    include "UriCommon.h"
 #    include "UriMemory.h"
-#    include "UriSets.h"
 #  endif
 
 #  include <assert.h>
@@ -105,41 +105,7 @@ UriBool URI_FUNC(IsWellFormedPath)(
      * .. and leaves the rest to pre-return removal of ambiguity
      * from cases like "path1:/path2" and "//path1/path2" inside SetPath.
      */
-    while (first < afterLast) {
-        switch (first[0]) {
-        case URI_SET_PCHAR_WITHOUT_PERCENT(_UT):
-            break;
-
-        /* pct-encoded */
-        case _UT('%'):
-            if (afterLast - first < 3) {
-                return URI_FALSE;
-            }
-            switch (first[1]) {
-            case URI_SET_HEXDIG(_UT):
-                break;
-            default:
-                return URI_FALSE;
-            }
-            switch (first[2]) {
-            case URI_SET_HEXDIG(_UT):
-                break;
-            default:
-                return URI_FALSE;
-            }
-            first += 2;
-            break;
-
-        case _UT('/'):
-            break;
-
-        default:
-            return URI_FALSE;
-        }
-
-        first++;
-    }
-    return URI_TRUE;
+    return URI_FUNC(IsCharClassOrPctEncoded)(first, afterLast, URI_CLASS_PATH);
 }
 
 static void URI_FUNC(DropEmptyFirstPathSegment)(
@@ -155,7 +121,7 @@ static void URI_FUNC(DropEmptyFirstPathSegment)(
 
     originalHead->text.first = NULL;
     originalHead->text.afterLast = NULL;
-    memory->free(memory, originalHead);
+    URI_FUNC(FreePathSegment)(uri, originalHead, memory);
 }
 
 /* URIs without a host encode a leading slash in the path as .absolutePath == URI_TRUE.
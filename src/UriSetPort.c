@@ -60,9 +60,9 @@
 
 #  ifndef URI_DOXYGEN
 #    include <uriparser/Uri.h>
+#    include "UriCharClass.h"
 #    include "UriCommon.h"
 #    include "UriMemory.h"
-#    include "UriSets.h"
 #  endif
 
 #  include <assert.h>
@@ -74,10 +74,7 @@ UriBool URI_FUNC(IsWellFormedPort)(const URI_CHAR * first, const URI_CHAR * afte
 
     /* NOTE: Grammar reads "port = *DIGIT" which includes the empty string. */
     while (first < afterLast) {
-        switch (first[0]) {
-        case URI_SET_DIGIT(_UT):
-            break;
-        default:
+        if (!URI_CHAR_IS(first[0], URI_CLASS_DIGIT)) {
             return URI_FALSE;
         }
         first++;
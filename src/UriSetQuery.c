@@ -60,9 +60,9 @@
 
 #  ifndef URI_DOXYGEN
 #    include <uriparser/Uri.h>
+#    include "UriCharClass.h"
 #    include "UriCommon.h"
 #    include "UriMemory.h"
-#    include "UriSets.h"
 #  endif
 
 #  include <assert.h>
@@ -77,42 +77,7 @@ UriBool URI_FUNC(IsWellFormedQuery)(const URI_CHAR * first, const URI_CHAR * aft
      *   query         = *( pchar / "/" / "?" )
      *   pchar         = unreserved / pct-encoded / sub-delims / ":" / "@"
      */
-    while (first < afterLast) {
-        switch (first[0]) {
-        case URI_SET_PCHAR_WITHOUT_PERCENT(_UT):
-            break;
-
-        /* pct-encoded */
-        case _UT('%'):
-            if (afterLast - first < 3) {
-                return URI_FALSE;
-            }
-            switch (first[1]) {
-            case URI_SET_HEXDIG(_UT):
-                break;
-            default:
-                return URI_FALSE;
-            }
-            switch (first[2]) {
-            case URI_SET_HEXDIG(_UT):
-                break;
-            default:
-                return URI_FALSE;
-            }
-            first += 2;
-            break;
-
-        case _UT('/'):
-        case _UT('?'):
-            break;
-
-        default:
-            return URI_FALSE;
-        }
-
-        first++;
-    }
-    return URI_TRUE;
+    return URI_FUNC(IsCharClassOrPctEncoded)(first, afterLast, URI_CLASS_QUERY_FRAG);
 }
 
 int URI_FUNC(SetQueryMm)(URI_TYPE(Uri) * uri, const URI_CHAR * first,
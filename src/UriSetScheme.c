@@ -60,9 +60,9 @@
 
 #  ifndef URI_DOXYGEN
 #    include <uriparser/Uri.h>
+#    include "UriCharClass.h"
 #    include "UriCommon.h"
 #    include "UriMemory.h"
-#    include "UriSets.h"
 #  endif
 
 #  include <assert.h>
@@ -80,29 +80,16 @@ UriBool URI_FUNC(IsWellFormedScheme)(const URI_CHAR * first, const URI_CHAR * af
         return URI_FALSE;
     }
 
-    switch (first[0]) {
-    case URI_SET_ALPHA(_UT):
-        break;
-
-    default:
+    if (!URI_CHAR_IS(first[0], URI_CLASS_ALPHA)) {
         return URI_FALSE;
     }
 
     first++;
 
     while (first < afterLast) {
-        switch (first[0]) {
-        case URI_SET_ALPHA(_UT):
-        case URI_SET_DIGIT(_UT):
-        case _UT('+'):
-        case _UT('-'):
-        case _UT('.'):
-            break;
-
-        default:
+        if (!URI_CHAR_IS(first[0], URI_CLASS_SCHEME)) {
             return URI_FALSE;
         }
-
         first++;
     }
     return URI_TRUE;
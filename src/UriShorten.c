@@ -408,14 +408,42 @@ int URI_FUNC(RemoveBaseUri)(URI_TYPE(Uri) * dest, const URI_TYPE(Uri) * absSourc
 int URI_FUNC(RemoveBaseUriMm)(URI_TYPE(Uri) * dest, const URI_TYPE(Uri) * absSource,
         const URI_TYPE(Uri) * absBase, UriBool domainRootMode,
         UriMemoryManager * memory) {
+    URI_TYPE(Uri) splitAbsSource;
+    URI_TYPE(Uri) splitAbsBase;
+    const UriBool absSourceLazy = URI_FUNC(IsPathLazy)(absSource);
+    const UriBool absBaseLazy = URI_FUNC(IsPathLazy)(absBase);
     int res;
 
     URI_CHECK_MEMORY_MANAGER(memory); /* may return */
 
+    /* Work on split copies of lazy paths, see ParseSingleUriExLazyMm */
+    if (absSourceLazy) {
+        if (!URI_FUNC(MaterializePathShallow)(&splitAbsSource, absSource, memory)) {
+            return URI_ERROR_MALLOC;
+        }
+        absSource = &splitAbsSource;
+    }
+    if (absBaseLazy) {
+        if (!URI_FUNC(MaterializePathShallow)(&splitAbsBase, absBase, memory)) {
+            if (absSourceLazy) {
+                URI_FUNC(FreeUriPath)(&splitAbsSource, memory);
+            }
+            return URI_ERROR_MALLOC;
+        }
+        absBase = &splitAbsBase;
+    }
+
     res = URI_FUNC(RemoveBaseUriImpl)(dest, absSource, absBase, domainRootMode, memory);
     if ((res != URI_SUCCESS) && (dest != NULL)) {
         URI_FUNC(FreeUriMembersMm)(dest, memory);
     }
+
+    if (absSourceLazy) {
+        URI_FUNC(FreeUriPath)(&splitAbsSource, memory);
+    }
+    if (absBaseLazy) {
+        URI_FUNC(FreeUriPath)(&splitAbsBase, memory);
+    }
     return res;
 }
 
@@ -0,0 +1,203 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <uriparser/Uri.h>
+
+#include <cstring>
+#include <cwchar>
+
+extern "C" {
+#include "../src/UriCharClass.h"
+}
+#include "../src/UriSets.h"
+
+namespace {
+
+#define URI_TEST_PLAIN(x) x
+
+static bool isDigit(int c) {
+    switch (c) {
+    case URI_SET_DIGIT(URI_TEST_PLAIN):
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool isAlpha(int c) {
+    switch (c) {
+    case URI_SET_ALPHA(URI_TEST_PLAIN):
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool isHexdig(int c) {
+    switch (c) {
+    case URI_SET_HEXDIG(URI_TEST_PLAIN):
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool isUnreserved(int c) {
+    switch (c) {
+    case URI_SET_UNRESERVED(URI_TEST_PLAIN):
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool isSubDelims(int c) {
+    switch (c) {
+    case URI_SET_SUB_DELIMS(URI_TEST_PLAIN):
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool isPcharWithoutPercent(int c) {
+    switch (c) {
+    case URI_SET_PCHAR_WITHOUT_PERCENT(URI_TEST_PLAIN):
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool hasClass(int c, unsigned int mask) {
+    return (uriCharClassTable[c] & mask) != 0;
+}
+
+static const char * skipCharClass(
+        const char * first, const char * afterLast, unsigned int mask) {
+    first = uriSkipCharClassBlocks(first, afterLast, mask);
+    while ((first < afterLast) && URI_CHAR_IS(*first, mask)) {
+        first++;
+    }
+    return first;
+}
+
+}  // namespace
+
+TEST(CharClassSuite, TableMatchesSwitchSets) {
+    for (int c = 0; c < 256; c++) {
+        SCOPED_TRACE(c);
+        const bool pchar = isPcharWithoutPercent(c);
+        const bool scheme = isAlpha(c) || isDigit(c) || (c == '+') || (c == '-')
+                || (c == '.');
+
+        EXPECT_EQ(hasClass(c, URI_CLASS_DIGIT), isDigit(c));
+        EXPECT_EQ(hasClass(c, URI_CLASS_ALPHA), isAlpha(c));
+        EXPECT_EQ(hasClass(c, URI_CLASS_HEXDIG), isHexdig(c));
+        EXPECT_EQ(hasClass(c, URI_CLASS_UNRESERVED), isUnreserved(c));
+        EXPECT_EQ(hasClass(c, URI_CLASS_SUB_DELIMS), isSubDelims(c));
+        EXPECT_EQ(hasClass(c, URI_CLASS_PCHAR), pchar);
+        EXPECT_EQ(hasClass(c, URI_CLASS_QUERY_FRAG), pchar || (c == '/') || (c == '?'));
+        EXPECT_EQ(hasClass(c, URI_CLASS_SCHEME), scheme);
+        EXPECT_EQ(hasClass(c, URI_CLASS_USERINFO),
+                isUnreserved(c) || isSubDelims(c) || (c == ':'));
+        EXPECT_EQ(hasClass(c, URI_CLASS_PATH), pchar || (c == '/'));
+        EXPECT_EQ(hasClass(c, URI_CLASS_QUERY_VALUE),
+                (pchar || (c == '/') || (c == '?')) && (c != '&') && (c != '+')
+                        && (c != '='));
+    }
+}
+
+TEST(CharClassSuite, HighBytesAreInNoClass) {
+    for (int c = 0x80; c < 0x100; c++) {
+        const char asChar = static_cast<char>(c);
+        EXPECT_EQ(URI_CHAR_CLASS(asChar), 0);
+    }
+}
+
+TEST(CharClassSuite, WideCharsAboveLatin1AreInNoClass) {
+    // NOTE: The low byte of each of these is a member of (most) classes,
+    //       so plain truncation to 8 bits would give false positives.
+    const wchar_t candidates[] = {L'\x0161', L'\x0130', L'\x2061', L'\xFF30'};
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+        const wchar_t c = candidates[i];
+        EXPECT_EQ(URI_CHAR_CLASS(c), 0);
+        EXPECT_FALSE(uriIsWellFormedQueryW(&c, &c + 1));
+        EXPECT_FALSE(uriIsWellFormedSchemeW(&c, &c + 1));
+    }
+
+    const wchar_t * const input = L"http://example.org/p\x0161th";
+    UriUriW uri;
+    const wchar_t * errorPos = NULL;
+    EXPECT_EQ(uriParseSingleUriW(&uri, input, &errorPos), URI_ERROR_SYNTAX);
+    EXPECT_EQ(errorPos, input + 20);
+}
+
+TEST(CharClassSuite, BlockSkippingStopsAtFirstNonMember) {
+    const unsigned int masks[]
+            = {URI_CLASS_PCHAR, URI_CLASS_QUERY_FRAG, URI_CLASS_UNRESERVED};
+    char buffer[48];
+
+    for (size_t m = 0; m < sizeof(masks) / sizeof(masks[0]); m++) {
+        for (int c = 0; c < 256; c++) {
+            const bool member = hasClass(c, masks[m]);
+            for (size_t pos = 0; pos < sizeof(buffer); pos++) {
+                SCOPED_TRACE(c);
+                SCOPED_TRACE(pos);
+                memset(buffer, 'a', sizeof(buffer));
+                buffer[pos] = static_cast<char>(c);
+
+                const char * const afterLast = buffer + sizeof(buffer);
+                const char * const expected = member ? afterLast : buffer + pos;
+                ASSERT_EQ(skipCharClass(buffer, afterLast, masks[m]), expected);
+            }
+        }
+    }
+}
+
+TEST(CharClassSuite, LongQueryAndFragmentErrorPositions) {
+    const char * const inputs[] = {
+            "http://example.org/?aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\\bbbb",
+            "http://example.org/?aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa%zzbbb",
+            "http://example.org/#aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa bbbb",
+            "http://example.org/#aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa#bbbb",
+            "http://example.org/aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\xC3\xA4" "bbb",
+    };
+    const size_t errorOffsets[] = {55, 54, 55, 55, 55};
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        SCOPED_TRACE(inputs[i]);
+        UriUriA uri;
+        const char * errorPos = NULL;
+        EXPECT_EQ(uriParseSingleUriA(&uri, inputs[i], &errorPos), URI_ERROR_SYNTAX);
+        EXPECT_EQ(errorPos, inputs[i] + errorOffsets[i]);
+    }
+
+    const char * const valid = "http://example.org/aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa/b"
+                               "?q=aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa%20/?x"
+                               "#aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa/?";
+    UriUriA uri;
+    ASSERT_EQ(uriParseSingleUriA(&uri, valid, NULL), URI_SUCCESS);
+    EXPECT_EQ(uri.query.afterLast, strchr(valid, '#'));
+    EXPECT_EQ(uri.fragment.afterLast, valid + strlen(valid));
+    uriFreeUriMembersA(&uri);
+}
@@ -0,0 +1,128 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef URI_TEST_FAILING_MEMORY_MANAGER_H
+#  define URI_TEST_FAILING_MEMORY_MANAGER_H 1
+
+#  include <cerrno>
+#  include <cstdlib>
+
+#  include <uriparser/Uri.h>
+
+// For uriEmulateReallocarray
+extern "C" {
+#  include "../src/UriMemory.h"
+}
+
+namespace {
+
+static void * failingMalloc(UriMemoryManager * memory, size_t size);
+static void * failingCalloc(UriMemoryManager * memory, size_t nmemb, size_t size);
+static void * failingRealloc(UriMemoryManager * memory, void * ptr, size_t size);
+static void * failingReallocarray(
+        UriMemoryManager * memory, void * ptr, size_t nmemb, size_t size);
+static void countingFree(UriMemoryManager * memory, void * ptr);
+
+class FailingMemoryManager {
+private:
+    UriMemoryManager memoryManager;
+    unsigned int callCountAlloc;
+    unsigned int callCountFree;
+    unsigned int failAllocAfterTimes;
+
+    friend void * failingMalloc(UriMemoryManager * memory, size_t size);
+    friend void * failingCalloc(UriMemoryManager * memory, size_t nmemb, size_t size);
+    friend void * failingRealloc(UriMemoryManager * memory, void * ptr, size_t size);
+    friend void * failingReallocarray(
+            UriMemoryManager * memory, void * ptr, size_t nmemb, size_t size);
+    friend void countingFree(UriMemoryManager * memory, void * ptr);
+
+public:
+    FailingMemoryManager(unsigned int failAllocAfterTimes = 0)
+        : callCountAlloc(0), callCountFree(0), failAllocAfterTimes(failAllocAfterTimes) {
+        this->memoryManager.malloc = failingMalloc;
+        this->memoryManager.calloc = failingCalloc;
+        this->memoryManager.realloc = failingRealloc;
+        this->memoryManager.reallocarray = failingReallocarray;
+        this->memoryManager.free = countingFree;
+        this->memoryManager.userData = this;
+    }
+
+    UriMemoryManager * operator&() {
+        return &(this->memoryManager);
+    }
+
+    unsigned int getCallCountAlloc() const {
+        return this->callCountAlloc;
+    }
+
+    unsigned int getCallCountFree() const {
+        return this->callCountFree;
+    }
+};
+
+static void * failingMalloc(UriMemoryManager * memory, size_t size) {
+    FailingMemoryManager * const fmm =
+            static_cast<FailingMemoryManager *>(memory->userData);
+    fmm->callCountAlloc++;
+    if (fmm->callCountAlloc > fmm->failAllocAfterTimes) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return malloc(size);
+}
+
+static void * failingCalloc(UriMemoryManager * memory, size_t nmemb, size_t size) {
+    FailingMemoryManager * const fmm =
+            static_cast<FailingMemoryManager *>(memory->userData);
+    fmm->callCountAlloc++;
+    if (fmm->callCountAlloc > fmm->failAllocAfterTimes) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return calloc(nmemb, size);
+}
+
+static void * failingRealloc(UriMemoryManager * memory, void * ptr, size_t size) {
+    FailingMemoryManager * const fmm =
+            static_cast<FailingMemoryManager *>(memory->userData);
+    fmm->callCountAlloc++;
+    if (fmm->callCountAlloc > fmm->failAllocAfterTimes) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return realloc(ptr, size);
+}
+
+static void * failingReallocarray(
+        UriMemoryManager * memory, void * ptr, size_t nmemb, size_t size) {
+    return uriEmulateReallocarray(memory, ptr, nmemb, size);
+}
+
+static void countingFree(UriMemoryManager * memory, void * ptr) {
+    FailingMemoryManager * const fmm =
+            static_cast<FailingMemoryManager *>(memory->userData);
+    fmm->callCountFree++;
+    return free(ptr);
+}
+
+}  // namespace
+
+#endif /* URI_TEST_FAILING_MEMORY_MANAGER_H */
@@ -0,0 +1,251 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <uriparser/Uri.h>
+
+#include <cstring>
+#include <string>
+
+#include "FailingMemoryManager.h"
+
+namespace {
+
+bool toStringEquals(const UriUriA * uri, const char * expected) {
+    char buffer[100];
+    if (uriToStringA(buffer, uri, sizeof(buffer), NULL) != URI_SUCCESS) {
+        return false;
+    }
+    return strcmp(buffer, expected) == 0;
+}
+
+bool testNoAllocationHelper(const char * uriText) {
+    FailingMemoryManager failingMemoryManager;
+    UriUriA uri;
+
+    if (uriParseSingleUriExFlatMmA(&uri, uriText, uriText + strlen(uriText), NULL,
+                &failingMemoryManager)
+            != URI_SUCCESS) {
+        return false;
+    }
+
+    uriFreeUriMembersMmA(&uri, &failingMemoryManager);
+    return failingMemoryManager.getCallCountAlloc() == 0;
+}
+
+bool testPathManipulationHelper(const char * uriText, const char * expected) {
+    FailingMemoryManager countingMemoryManager(1000);
+    UriUriA uri;
+
+    if (uriParseSingleUriExFlatMmA(&uri, uriText, uriText + strlen(uriText), NULL,
+                &countingMemoryManager)
+            != URI_SUCCESS) {
+        return false;
+    }
+
+    if ((uriNormalizeSyntaxExMmA(&uri, URI_NORMALIZE_PATH, &countingMemoryManager)
+                != URI_SUCCESS)
+            || !toStringEquals(&uri, expected)) {
+        uriFreeUriMembersMmA(&uri, &countingMemoryManager);
+        return false;
+    }
+
+    UriUriA copy;
+    if (uriCopyUriMmA(&copy, &uri, &countingMemoryManager) != URI_SUCCESS) {
+        uriFreeUriMembersMmA(&uri, &countingMemoryManager);
+        return false;
+    }
+    const bool copyEqual = toStringEquals(&copy, expected);
+    uriFreeUriMembersMmA(&copy, &countingMemoryManager);
+
+    const char * const newPath = "/p/q";
+    const bool pathSet = (uriSetPathMmA(&uri, newPath, newPath + strlen(newPath),
+                                  &countingMemoryManager)
+                                 == URI_SUCCESS)
+                         && (uri.pathHead != NULL);
+
+    uriFreeUriMembersMmA(&uri, &countingMemoryManager);
+    return copyEqual && pathSet
+           && (countingMemoryManager.getCallCountAlloc()
+                   == countingMemoryManager.getCallCountFree());
+}
+
+size_t largestCallocSize = 0;
+
+void * recordingCalloc(UriMemoryManager * /*memory*/, size_t nmemb, size_t size) {
+    if (nmemb * size > largestCallocSize) {
+        largestCallocSize = nmemb * size;
+    }
+    return calloc(nmemb, size);
+}
+
+bool testIpHostDataHelper(const char * uriText) {
+    FailingMemoryManager countingMemoryManager(1000);
+    UriUriA uri;
+
+    if (uriParseSingleUriExFlatMmA(&uri, uriText, uriText + strlen(uriText), NULL,
+                &countingMemoryManager)
+            != URI_SUCCESS) {
+        return false;
+    }
+
+    bool success = countingMemoryManager.getCallCountAlloc() == 1;
+    if (uri.hostData.ip4 != NULL) {
+        success = success && (uri.hostData.ip4->data[3] == 4);
+    } else {
+        success = success && (uri.hostData.ip6 != NULL)
+                  && (uri.hostData.ip6->data[15] == 1);
+    }
+
+    uriFreeUriMembersMmA(&uri, &countingMemoryManager);
+    return success && (countingMemoryManager.getCallCountFree() == 1);
+}
+
+}  // namespace
+
+TEST(FlatPathSuite, SingleAllocationForWholePath) {
+    UriUriA uri;
+    const char * const first = "mailto:a/b/c/d/e?q=/x/y";
+    const char * const afterLast = first + strlen(first);
+    FailingMemoryManager countingMemoryManager(1000);
+
+    ASSERT_EQ(uriParseSingleUriExFlatMmA(
+                      &uri, first, afterLast, NULL, &countingMemoryManager),
+            URI_SUCCESS);
+    EXPECT_EQ(countingMemoryManager.getCallCountAlloc(), 1U);
+
+    const char * const expectedSegments[] = {"a", "b", "c", "d", "e"};
+    const UriPathSegmentA * walker = uri.pathHead;
+    for (size_t i = 0; i < sizeof(expectedSegments) / sizeof(expectedSegments[0]); i++) {
+        ASSERT_TRUE(walker != NULL);
+        EXPECT_EQ(std::string(walker->text.first, walker->text.afterLast),
+                expectedSegments[i]);
+        if (walker->next == NULL) {
+            EXPECT_EQ(walker, uri.pathTail);
+        }
+        walker = walker->next;
+    }
+    EXPECT_TRUE(walker == NULL);
+    EXPECT_TRUE(toStringEquals(&uri, first));
+
+    uriFreeUriMembersMmA(&uri, &countingMemoryManager);
+    EXPECT_EQ(countingMemoryManager.getCallCountFree(), 1U);
+}
+
+TEST(FlatPathSuite, SlashesAfterPathDoNotGrowBlock) {
+    UriUriA uri;
+    const std::string text = "http://h/a?" + std::string(1000, '/') + "#"
+                             + std::string(1000, '/');
+    UriMemoryManager recordingMemoryManager;
+    memcpy(&recordingMemoryManager, &defaultMemoryManager, sizeof(UriMemoryManager));
+    recordingMemoryManager.calloc = recordingCalloc;
+    largestCallocSize = 0;
+
+    ASSERT_EQ(uriParseSingleUriExFlatMmA(&uri, text.c_str(), text.c_str() + text.size(),
+                      NULL, &recordingMemoryManager),
+            URI_SUCCESS);
+    EXPECT_LT(largestCallocSize, 10 * sizeof(UriPathSegmentA));
+    ASSERT_TRUE(uri.pathHead != NULL);
+    EXPECT_TRUE(uri.pathHead->next == NULL);
+
+    uriFreeUriMembersMmA(&uri, &recordingMemoryManager);
+}
+
+TEST(FlatPathSuite, NoAllocationWithoutPath) {
+    ASSERT_TRUE(testNoAllocationHelper("mailto:?q=/x/y#/z"));
+}
+
+TEST(FlatPathSuite, SyntaxErrorAfterPathDoesNotLeak) {
+    UriUriA uri;
+    const char * const first = "mailto:a/b/c?%zz";
+    const char * const afterLast = first + strlen(first);
+    const char * errorPos = NULL;
+    FailingMemoryManager countingMemoryManager(1000);
+
+    ASSERT_EQ(uriParseSingleUriExFlatMmA(
+                      &uri, first, afterLast, &errorPos, &countingMemoryManager),
+            URI_ERROR_SYNTAX);
+    EXPECT_EQ(errorPos, first + 14);
+    EXPECT_EQ(countingMemoryManager.getCallCountAlloc(),
+            countingMemoryManager.getCallCountFree());
+}
+
+TEST(FlatPathSuite, PathManipulationMatchesRegularParse) {
+    ASSERT_TRUE(testPathManipulationHelper(
+            "http://example.org/a/./b/../c/", "http://example.org/a/c/"));
+    ASSERT_TRUE(testPathManipulationHelper(
+            "http://example.org/a/b/..", "http://example.org/a/"));
+    ASSERT_TRUE(testPathManipulationHelper("a/../../b/./c", "../b/c"));
+    ASSERT_TRUE(testPathManipulationHelper("/./x/.", "/x/"));
+    ASSERT_TRUE(testPathManipulationHelper("./a:b/.", "./a:b/"));
+    ASSERT_TRUE(testPathManipulationHelper("/..", "/"));
+    ASSERT_TRUE(testPathManipulationHelper("x/..", ""));
+}
+
+TEST(FlatPathSuite, IpHostDataInsidePathBlock) {
+    ASSERT_TRUE(testIpHostDataHelper("http://1.2.3.4/a/b"));
+    ASSERT_TRUE(testIpHostDataHelper("//[::1]/a"));
+    ASSERT_TRUE(testIpHostDataHelper("//[::1]"));
+    ASSERT_TRUE(testIpHostDataHelper("http://1.2.3.4"));
+}
+
+TEST(FlatPathSuite, NoAllocationForRegNameHost) {
+    ASSERT_TRUE(testNoAllocationHelper("http://example.org?q=1"));
+}
+
+TEST(FlatPathSuite, SettersKeepInlineHostDataValid) {
+    UriUriA uri;
+    const char * const first = "http://1.2.3.4/a/b";
+    const char * const afterLast = first + strlen(first);
+    FailingMemoryManager countingMemoryManager(1000);
+
+    ASSERT_EQ(uriParseSingleUriExFlatMmA(
+                      &uri, first, afterLast, NULL, &countingMemoryManager),
+            URI_SUCCESS);
+
+    const char * const newPath = "/x";
+    ASSERT_EQ(uriSetPathMmA(
+                      &uri, newPath, newPath + strlen(newPath), &countingMemoryManager),
+            URI_SUCCESS);
+    ASSERT_TRUE(uri.hostData.ip4 != NULL);
+    EXPECT_EQ(uri.hostData.ip4->data[0], 1);
+    EXPECT_TRUE(toStringEquals(&uri, "http://1.2.3.4/x"));
+
+    const char * const newHost = "::2";
+    ASSERT_EQ(uriSetHostIp6MmA(
+                      &uri, newHost, newHost + strlen(newHost), &countingMemoryManager),
+            URI_SUCCESS);
+    ASSERT_TRUE(uri.hostData.ip6 != NULL);
+    EXPECT_TRUE(uri.hostData.ip4 == NULL);
+    EXPECT_EQ(uri.hostData.ip6->data[15], 2);
+    EXPECT_TRUE(
+            toStringEquals(&uri, "http://[0000:0000:0000:0000:0000:0000:0000:0002]/x"));
+
+    UriUriA copy;
+    ASSERT_EQ(uriCopyUriMmA(&copy, &uri, &countingMemoryManager), URI_SUCCESS);
+    EXPECT_TRUE(
+            toStringEquals(&copy, "http://[0000:0000:0000:0000:0000:0000:0000:0002]/x"));
+    uriFreeUriMembersMmA(&copy, &countingMemoryManager);
+
+    uriFreeUriMembersMmA(&uri, &countingMemoryManager);
+    EXPECT_EQ(countingMemoryManager.getCallCountAlloc(),
+            countingMemoryManager.getCallCountFree());
+}
@@ -484,6 +484,14 @@ int testParseUri(const char * uriText, const char ** expectedErrorPos = NULL) {
         *expectedErrorPos = state.errorPos;
     }
     uriFreeUriMembersA(&uri);
+
+    // Validation without parsing needs to come to the same conclusion
+    const char * validateErrorPos = NULL;
+    EXPECT_EQ(uriValidateUriExA(uriText, NULL, &validateErrorPos), res);
+    if (res == URI_ERROR_SYNTAX) {
+        EXPECT_EQ(validateErrorPos, state.errorPos);
+    }
+
     return res;
 }
 
@@ -0,0 +1,138 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <uriparser/Uri.h>
+
+#include <cstring>
+
+#include "FailingMemoryManager.h"
+
+namespace {
+
+bool toStringEquals(const UriUriA * uri, const char * expected) {
+    char buffer[100];
+    if (uriToStringA(buffer, uri, sizeof(buffer), NULL) != URI_SUCCESS) {
+        return false;
+    }
+    return strcmp(buffer, expected) == 0;
+}
+
+bool testNoAllocationHelper(const char * uriText) {
+    FailingMemoryManager failingMemoryManager;
+    UriUriInlineA uriInline;
+
+    if (uriParseSingleUriInlineMmA(&uriInline, uriText, uriText + strlen(uriText), NULL,
+                &failingMemoryManager)
+            != URI_SUCCESS) {
+        return false;
+    }
+
+    const bool equal = toStringEquals(&uriInline.uri, uriText);
+    uriFreeUriMembersMmA(&uriInline.uri, &failingMemoryManager);
+    return equal && (failingMemoryManager.getCallCountAlloc() == 0)
+           && (failingMemoryManager.getCallCountFree() == 0);
+}
+
+bool testPathManipulationHelper(const char * uriText, const char * expected) {
+    FailingMemoryManager countingMemoryManager(1000);
+    UriUriInlineA uriInline;
+
+    if (uriParseSingleUriInlineMmA(&uriInline, uriText, uriText + strlen(uriText), NULL,
+                &countingMemoryManager)
+            != URI_SUCCESS) {
+        return false;
+    }
+
+    if ((uriNormalizeSyntaxExMmA(
+                 &uriInline.uri, URI_NORMALIZE_PATH, &countingMemoryManager)
+                != URI_SUCCESS)
+            || !toStringEquals(&uriInline.uri, expected)) {
+        uriFreeUriMembersMmA(&uriInline.uri, &countingMemoryManager);
+        return false;
+    }
+
+    UriUriA copy;
+    if (uriCopyUriMmA(&copy, &uriInline.uri, &countingMemoryManager) != URI_SUCCESS) {
+        uriFreeUriMembersMmA(&uriInline.uri, &countingMemoryManager);
+        return false;
+    }
+    const bool copyEqual = toStringEquals(&copy, expected);
+    uriFreeUriMembersMmA(&copy, &countingMemoryManager);
+
+    const char * const newPath = "/p/q";
+    const bool pathSet = (uriSetPathMmA(&uriInline.uri, newPath,
+                                  newPath + strlen(newPath), &countingMemoryManager)
+                                 == URI_SUCCESS)
+                         && (uriInline.uri.pathHead != NULL);
+
+    uriFreeUriMembersMmA(&uriInline.uri, &countingMemoryManager);
+    return copyEqual && pathSet
+           && (countingMemoryManager.getCallCountAlloc()
+                   == countingMemoryManager.getCallCountFree());
+}
+
+}  // namespace
+
+TEST(InlinePathSuite, NoAllocationForShortPath) {
+    ASSERT_TRUE(testNoAllocationHelper("http://example.org/a/b/c/d?q#f"));
+    ASSERT_TRUE(testNoAllocationHelper("http://1.2.3.4/a"));
+    ASSERT_TRUE(
+            testNoAllocationHelper("//[0000:0000:0000:0000:0000:0000:0000:0001]/a/b/"));
+    ASSERT_TRUE(testNoAllocationHelper("mailto:someone@example.org"));
+    ASSERT_TRUE(testNoAllocationHelper(""));
+}
+
+TEST(InlinePathSuite, LongPathSpillsToHeap) {
+    const char * const first = "/a/b/c/d/e/f";
+    const char * const afterLast = first + strlen(first);
+    FailingMemoryManager countingMemoryManager(1000);
+    UriUriInlineA uriInline;
+
+    ASSERT_EQ(uriParseSingleUriInlineMmA(
+                      &uriInline, first, afterLast, NULL, &countingMemoryManager),
+            URI_SUCCESS);
+    EXPECT_EQ(countingMemoryManager.getCallCountAlloc(), 2U);
+    EXPECT_TRUE(toStringEquals(&uriInline.uri, first));
+
+    uriFreeUriMembersMmA(&uriInline.uri, &countingMemoryManager);
+    EXPECT_EQ(countingMemoryManager.getCallCountFree(), 2U);
+}
+
+TEST(InlinePathSuite, SyntaxErrorDoesNotLeak) {
+    const char * const first = "/a/b/c/d/e/f?%zz";
+    const char * const afterLast = first + strlen(first);
+    FailingMemoryManager countingMemoryManager(1000);
+    UriUriInlineA uriInline;
+
+    ASSERT_EQ(uriParseSingleUriInlineMmA(
+                      &uriInline, first, afterLast, NULL, &countingMemoryManager),
+            URI_ERROR_SYNTAX);
+    EXPECT_EQ(countingMemoryManager.getCallCountAlloc(),
+            countingMemoryManager.getCallCountFree());
+}
+
+TEST(InlinePathSuite, PathManipulationMatchesRegularParse) {
+    ASSERT_TRUE(testPathManipulationHelper(
+            "http://1.2.3.4/a/./b/../c/", "http://1.2.3.4/a/c/"));
+    ASSERT_TRUE(testPathManipulationHelper("a/../../b/./c/d/e/..", "../b/c/d/"));
+    ASSERT_TRUE(testPathManipulationHelper("/..", "/"));
+}
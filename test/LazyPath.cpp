@@ -0,0 +1,256 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <uriparser/Uri.h>
+
+#include <cstring>
+#include <string>
+
+#include "FailingMemoryManager.h"
+
+namespace {
+
+bool toStringEquals(const UriUriA * uri, const char * expected) {
+    char buffer[100];
+    if (uriToStringA(buffer, uri, sizeof(buffer), NULL) != URI_SUCCESS) {
+        return false;
+    }
+    return strcmp(buffer, expected) == 0;
+}
+
+bool segmentsEqual(const UriPathSegmentA * a, const UriPathSegmentA * b) {
+    while ((a != NULL) && (b != NULL)) {
+        if (std::string(a->text.first, a->text.afterLast)
+                != std::string(b->text.first, b->text.afterLast)) {
+            return false;
+        }
+        a = a->next;
+        b = b->next;
+    }
+    return (a == NULL) && (b == NULL);
+}
+
+bool testMatchesRegularParseHelper(const char * uriText) {
+    const char * const afterLast = uriText + strlen(uriText);
+    UriUriA regular;
+    UriUriA lazy;
+    UriUriA copy;
+
+    if (uriParseSingleUriExA(&regular, uriText, afterLast, NULL) != URI_SUCCESS) {
+        return false;
+    }
+    if (uriParseSingleUriExLazyMmA(&lazy, uriText, afterLast, NULL, NULL)
+            != URI_SUCCESS) {
+        uriFreeUriMembersA(&regular);
+        return false;
+    }
+    if (uriCopyUriMmA(&copy, &lazy, NULL) != URI_SUCCESS) {
+        uriFreeUriMembersA(&lazy);
+        uriFreeUriMembersA(&regular);
+        return false;
+    }
+
+    bool success = toStringEquals(&lazy, uriText) && uriEqualsUriA(&lazy, &regular)
+                   && uriEqualsUriA(&regular, &lazy) && uriEqualsUriA(&copy, &lazy);
+
+    success = success && (uriEnsurePathSegmentsA(&lazy) == URI_SUCCESS)
+              && (uriEnsurePathSegmentsA(&copy) == URI_SUCCESS)
+              && segmentsEqual(lazy.pathHead, regular.pathHead)
+              && segmentsEqual(copy.pathHead, regular.pathHead);
+
+    uriFreeUriMembersA(&copy);
+    uriFreeUriMembersA(&lazy);
+    uriFreeUriMembersA(&regular);
+    return success;
+}
+
+bool testDiffersHelper(const char * lazyText, const char * regularText) {
+    UriUriA lazy;
+    UriUriA regular;
+
+    if (uriParseSingleUriExLazyMmA(
+                &lazy, lazyText, lazyText + strlen(lazyText), NULL, NULL)
+            != URI_SUCCESS) {
+        return false;
+    }
+    if (uriParseSingleUriA(&regular, regularText, NULL) != URI_SUCCESS) {
+        uriFreeUriMembersA(&lazy);
+        return false;
+    }
+
+    const bool differ =
+            !uriEqualsUriA(&lazy, &regular) && !uriEqualsUriA(&regular, &lazy);
+    uriFreeUriMembersA(&regular);
+    uriFreeUriMembersA(&lazy);
+    return differ;
+}
+
+bool testPathManipulationHelper(const char * uriText, const char * expected) {
+    FailingMemoryManager countingMemoryManager(1000);
+    UriUriA uri;
+    unsigned int outMask = 0;
+
+    if (uriParseSingleUriExLazyMmA(&uri, uriText, uriText + strlen(uriText), NULL,
+                &countingMemoryManager)
+            != URI_SUCCESS) {
+        return false;
+    }
+
+    const bool success =
+            (uriNormalizeSyntaxMaskRequiredExA(&uri, &outMask) == URI_SUCCESS)
+            && ((outMask & URI_NORMALIZE_PATH) != 0)
+            && (uriMakeOwnerMmA(&uri, &countingMemoryManager) == URI_SUCCESS)
+            && (uriNormalizeSyntaxExMmA(&uri, URI_NORMALIZE_PATH, &countingMemoryManager)
+                    == URI_SUCCESS)
+            && toStringEquals(&uri, expected);
+
+    uriFreeUriMembersMmA(&uri, &countingMemoryManager);
+    return success
+           && (countingMemoryManager.getCallCountAlloc()
+                   == countingMemoryManager.getCallCountFree());
+}
+
+}  // namespace
+
+TEST(LazyPathSuite, SingleAllocationUntilSplit) {
+    UriUriA uri;
+    const char * const first = "mailto:a/b//c/?q=/x/y";
+    const char * const afterLast = first + strlen(first);
+    FailingMemoryManager countingMemoryManager(1000);
+
+    ASSERT_EQ(uriParseSingleUriExLazyMmA(
+                      &uri, first, afterLast, NULL, &countingMemoryManager),
+            URI_SUCCESS);
+    EXPECT_EQ(countingMemoryManager.getCallCountAlloc(), 1U);
+    ASSERT_TRUE(uri.pathHead != NULL);
+    EXPECT_EQ(uri.pathHead, uri.pathTail);
+    EXPECT_EQ(std::string(uri.pathHead->text.first, uri.pathHead->text.afterLast),
+            "a/b//c/");
+    EXPECT_TRUE(toStringEquals(&uri, first));
+
+    ASSERT_EQ(uriEnsurePathSegmentsMmA(&uri, &countingMemoryManager), URI_SUCCESS);
+    ASSERT_EQ(uriEnsurePathSegmentsMmA(&uri, &countingMemoryManager), URI_SUCCESS);
+
+    const char * const expectedSegments[] = {"a", "b", "", "c", ""};
+    const UriPathSegmentA * walker = uri.pathHead;
+    for (size_t i = 0; i < sizeof(expectedSegments) / sizeof(expectedSegments[0]); i++) {
+        ASSERT_TRUE(walker != NULL);
+        EXPECT_EQ(std::string(walker->text.first, walker->text.afterLast),
+                expectedSegments[i]);
+        if (walker->next == NULL) {
+            EXPECT_EQ(walker, uri.pathTail);
+        }
+        walker = walker->next;
+    }
+    EXPECT_TRUE(walker == NULL);
+    EXPECT_TRUE(toStringEquals(&uri, first));
+
+    uriFreeUriMembersMmA(&uri, &countingMemoryManager);
+    EXPECT_EQ(countingMemoryManager.getCallCountAlloc(),
+            countingMemoryManager.getCallCountFree());
+}
+
+TEST(LazyPathSuite, MatchesRegularParse) {
+    ASSERT_TRUE(testMatchesRegularParseHelper(""));
+    ASSERT_TRUE(testMatchesRegularParseHelper("a"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("/"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("//"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("///"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("/a//"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("//host"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("//host/"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("//host//a/"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("http://example.org/a/b/c?q#f"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("a:b/c"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("./a:b/c"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("../x/./y"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("mailto:/x"));
+    ASSERT_TRUE(testMatchesRegularParseHelper("file:///C:/dir/file.txt"));
+}
+
+TEST(LazyPathSuite, DiffersFromOtherPath) {
+    ASSERT_TRUE(testDiffersHelper("/a/b", "/a/c"));
+    ASSERT_TRUE(testDiffersHelper("/a/b", "/a/b/"));
+    ASSERT_TRUE(testDiffersHelper("/a/b", "/a"));
+    ASSERT_TRUE(testDiffersHelper("/a//b", "/a/b"));
+    ASSERT_TRUE(testDiffersHelper("/a/b", "/ab"));
+}
+
+TEST(LazyPathSuite, PathManipulationMatchesRegularParse) {
+    ASSERT_TRUE(testPathManipulationHelper(
+            "http://example.org/a/./b/../c/", "http://example.org/a/c/"));
+    ASSERT_TRUE(testPathManipulationHelper(
+            "http://example.org/a/b/..", "http://example.org/a/"));
+    ASSERT_TRUE(testPathManipulationHelper("a/../../b/./c", "../b/c"));
+    ASSERT_TRUE(testPathManipulationHelper("/./x/.", "/x/"));
+    ASSERT_TRUE(testPathManipulationHelper("/..", "/"));
+    ASSERT_TRUE(testPathManipulationHelper("x/..", ""));
+}
+
+TEST(LazyPathSuite, DroppingSchemeMatchesRegularParse) {
+    const char * const first = "s:x/y:z";
+    UriUriA uri;
+
+    ASSERT_EQ(uriParseSingleUriExLazyMmA(&uri, first, first + strlen(first), NULL, NULL),
+            URI_SUCCESS);
+    ASSERT_EQ(uriSetSchemeA(&uri, NULL, NULL), URI_SUCCESS);
+    EXPECT_TRUE(toStringEquals(&uri, "x/y:z"));
+    uriFreeUriMembersA(&uri);
+}
+
+TEST(LazyPathSuite, AddAndRemoveBaseUri) {
+    const char * const relFirst = "../g/./h";
+    const char * const baseFirst = "http://a/b/c/d;p?q";
+    FailingMemoryManager countingMemoryManager(1000);
+    UriUriA rel;
+    UriUriA base;
+    UriUriA resolved;
+    UriUriA shortened;
+
+    ASSERT_EQ(uriParseSingleUriExLazyMmA(&rel, relFirst, relFirst + strlen(relFirst),
+                      NULL, &countingMemoryManager),
+            URI_SUCCESS);
+    ASSERT_EQ(uriParseSingleUriExLazyMmA(&base, baseFirst, baseFirst + strlen(baseFirst),
+                      NULL, &countingMemoryManager),
+            URI_SUCCESS);
+
+    ASSERT_EQ(uriAddBaseUriExMmA(&resolved, &rel, &base, URI_RESOLVE_STRICTLY,
+                      &countingMemoryManager),
+            URI_SUCCESS);
+    EXPECT_TRUE(toStringEquals(&resolved, "http://a/b/g/h"));
+
+    ASSERT_EQ(uriRemoveBaseUriMmA(&shortened, &resolved, &base, URI_FALSE,
+                      &countingMemoryManager),
+            URI_SUCCESS);
+    EXPECT_TRUE(toStringEquals(&shortened, "../g/h"));
+
+    // The lazy paths of the input URIs are left alone
+    EXPECT_EQ(rel.pathHead, rel.pathTail);
+    EXPECT_EQ(base.pathHead, base.pathTail);
+
+    uriFreeUriMembersMmA(&shortened, &countingMemoryManager);
+    uriFreeUriMembersMmA(&resolved, &countingMemoryManager);
+    uriFreeUriMembersMmA(&base, &countingMemoryManager);
+    uriFreeUriMembersMmA(&rel, &countingMemoryManager);
+    EXPECT_EQ(countingMemoryManager.getCallCountAlloc(),
+            countingMemoryManager.getCallCountFree());
+}
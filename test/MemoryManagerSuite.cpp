@@ -33,97 +33,9 @@ extern "C" {
 #include "../src/UriMemory.h"
 }
 
-namespace {
-
-static void * failingMalloc(UriMemoryManager * memory, size_t size);
-static void * failingCalloc(UriMemoryManager * memory, size_t nmemb, size_t size);
-static void * failingRealloc(UriMemoryManager * memory, void * ptr, size_t size);
-static void * failingReallocarray(
-        UriMemoryManager * memory, void * ptr, size_t nmemb, size_t size);
-static void countingFree(UriMemoryManager * memory, void * ptr);
-
-class FailingMemoryManager {
-private:
-    UriMemoryManager memoryManager;
-    unsigned int callCountAlloc;
-    unsigned int callCountFree;
-    unsigned int failAllocAfterTimes;
-
-    friend void * failingMalloc(UriMemoryManager * memory, size_t size);
-    friend void * failingCalloc(UriMemoryManager * memory, size_t nmemb, size_t size);
-    friend void * failingRealloc(UriMemoryManager * memory, void * ptr, size_t size);
-    friend void * failingReallocarray(
-            UriMemoryManager * memory, void * ptr, size_t nmemb, size_t size);
-    friend void countingFree(UriMemoryManager * memory, void * ptr);
-
-public:
-    FailingMemoryManager(unsigned int failAllocAfterTimes = 0)
-        : callCountAlloc(0), callCountFree(0), failAllocAfterTimes(failAllocAfterTimes) {
-        this->memoryManager.malloc = failingMalloc;
-        this->memoryManager.calloc = failingCalloc;
-        this->memoryManager.realloc = failingRealloc;
-        this->memoryManager.reallocarray = failingReallocarray;
-        this->memoryManager.free = countingFree;
-        this->memoryManager.userData = this;
-    }
-
-    UriMemoryManager * operator&() {
-        return &(this->memoryManager);
-    }
-
-    unsigned int getCallCountAlloc() const {
-        return this->callCountAlloc;
-    }
-
-    unsigned int getCallCountFree() const {
-        return this->callCountFree;
-    }
-};
-
-static void * failingMalloc(UriMemoryManager * memory, size_t size) {
-    FailingMemoryManager * const fmm =
-            static_cast<FailingMemoryManager *>(memory->userData);
-    fmm->callCountAlloc++;
-    if (fmm->callCountAlloc > fmm->failAllocAfterTimes) {
-        errno = ENOMEM;
-        return NULL;
-    }
-    return malloc(size);
-}
-
-static void * failingCalloc(UriMemoryManager * memory, size_t nmemb, size_t size) {
-    FailingMemoryManager * const fmm =
-            static_cast<FailingMemoryManager *>(memory->userData);
-    fmm->callCountAlloc++;
-    if (fmm->callCountAlloc > fmm->failAllocAfterTimes) {
-        errno = ENOMEM;
-        return NULL;
-    }
-    return calloc(nmemb, size);
-}
-
-static void * failingRealloc(UriMemoryManager * memory, void * ptr, size_t size) {
-    FailingMemoryManager * const fmm =
-            static_cast<FailingMemoryManager *>(memory->userData);
-    fmm->callCountAlloc++;
-    if (fmm->callCountAlloc > fmm->failAllocAfterTimes) {
-        errno = ENOMEM;
-        return NULL;
-    }
-    return realloc(ptr, size);
-}
-
-static void * failingReallocarray(
-        UriMemoryManager * memory, void * ptr, size_t nmemb, size_t size) {
-    return uriEmulateReallocarray(memory, ptr, nmemb, size);
-}
+#include "FailingMemoryManager.h"
 
-static void countingFree(UriMemoryManager * memory, void * ptr) {
-    FailingMemoryManager * const fmm =
-            static_cast<FailingMemoryManager *>(memory->userData);
-    fmm->callCountFree++;
-    return free(ptr);
-}
+namespace {
 
 static UriUriA parse(const char * sourceUriString) {
     UriParserStateA state;
@@ -294,6 +206,18 @@ TEST(FailingMemoryManagerSuite, DissectQueryMallocExMm) {
             URI_ERROR_MALLOC);
 }
 
+TEST(FailingMemoryManagerSuite, EscapeMallocExMm) {
+    char * dest = NULL;
+    const char * const first = "k1 v1";
+    const UriBool spaceToPlus = URI_TRUE;  // not of interest
+    const UriBool normalizeBreaks = URI_TRUE;  // not of interest
+    FailingMemoryManager failingMemoryManager;
+
+    ASSERT_EQ(uriEscapeMallocExMmA(&dest, first, NULL, spaceToPlus, normalizeBreaks,
+                      &failingMemoryManager),
+            URI_ERROR_MALLOC);
+}
+
 TEST(FailingMemoryManagerSuite, FreeQueryListMm) {
     UriQueryListA * const queryList = parseQueryList("k1=v1");
     FailingMemoryManager failingMemoryManager;
@@ -322,9 +246,9 @@ TEST(FailingMemoryManagerSuite, IsWellFormedHostIp6Mm) {
     EXPECT_EQ(failingMemoryManager.getCallCountAlloc(), 0U);
 
     EXPECT_EQ(uriIsWellFormedHostIp6MmA(first, afterLast, &failingMemoryManager),
-            URI_ERROR_MALLOC);
+            URI_SUCCESS);
 
-    EXPECT_EQ(failingMemoryManager.getCallCountAlloc(), 1U);
+    EXPECT_EQ(failingMemoryManager.getCallCountAlloc(), 0U);
 }
 
 TEST(FailingMemoryManagerSuite, IsWellFormedHostIpFutureMm) {
@@ -466,3 +390,274 @@ TEST(FailingMemoryManagerSuite, RemoveBaseUriMm) {
     uriFreeUriMembersA(&absoluteSource);
     uriFreeUriMembersA(&absoluteBase);
 }
+
+TEST(FailingMemoryManagerSuite, ParseSingleUriExFlatMm) {
+    UriUriA uri;
+    const char * const first = "k1=v1&k2=v2";
+    const char * const afterLast = first + strlen(first);
+    FailingMemoryManager failingMemoryManager;
+
+    ASSERT_EQ(uriParseSingleUriExFlatMmA(
+                      &uri, first, afterLast, NULL, &failingMemoryManager),
+            URI_ERROR_MALLOC);
+}
+
+namespace {
+
+static void assertToString(const UriUriA * uri, const char * expected) {
+    char buffer[100];
+    ASSERT_EQ(uriToStringA(buffer, uri, sizeof(buffer), NULL), URI_SUCCESS);
+    EXPECT_STREQ(buffer, expected);
+}
+
+}  // namespace
+
+TEST(FailingMemoryManagerSuite, ParseSingleUriExLazyMm) {
+    UriUriA uri;
+    const char * const first = "k1=v1&k2=v2";
+    const char * const afterLast = first + strlen(first);
+    FailingMemoryManager failingMemoryManager;
+
+    ASSERT_EQ(uriParseSingleUriExLazyMmA(
+                      &uri, first, afterLast, NULL, &failingMemoryManager),
+            URI_ERROR_MALLOC);
+}
+
+TEST(FailingMemoryManagerSuite, EnsurePathSegmentsMm) {
+    UriUriA uri;
+    const char * const first = "mailto:a/b/c";
+    const char * const afterLast = first + strlen(first);
+    FailingMemoryManager failingMemoryManager;
+
+    ASSERT_EQ(uriParseSingleUriExLazyMmA(&uri, first, afterLast, NULL, NULL),
+            URI_SUCCESS);
+    ASSERT_EQ(uriEnsurePathSegmentsMmA(&uri, &failingMemoryManager), URI_ERROR_MALLOC);
+    EXPECT_EQ(uri.pathHead, uri.pathTail);
+    assertToString(&uri, first);
+    uriFreeUriMembersA(&uri);
+}
+
+TEST(MemoryArenaSuite, PassesMemoryManagerTestsWithBuffer) {
+    UriMemoryManager memory;
+    UriMemoryArena arena;
+    long double buffer[64];
+
+    ASSERT_EQ(uriInitArenaMemoryManager(
+                      &memory, &arena, buffer, sizeof(buffer), 0, NULL),
+            URI_SUCCESS);
+    ASSERT_EQ(uriTestMemoryManagerEx(&memory, URI_TRUE), URI_SUCCESS);
+    uriFreeMemoryArena(&arena);
+}
+
+TEST(MemoryArenaSuite, PassesMemoryManagerTestsWithChunks) {
+    UriMemoryManager memory;
+    UriMemoryArena arena;
+    FailingMemoryManager backend(1000);
+
+    ASSERT_EQ(uriInitArenaMemoryManager(&memory, &arena, NULL, 0, 32, &backend),
+            URI_SUCCESS);
+    ASSERT_EQ(uriTestMemoryManagerEx(&memory, URI_TRUE), URI_SUCCESS);
+    EXPECT_GT(backend.getCallCountAlloc(), 1U);
+
+    uriFreeMemoryArena(&arena);
+    EXPECT_EQ(backend.getCallCountAlloc(), backend.getCallCountFree());
+}
+
+TEST(MemoryArenaSuite, InvalidArguments) {
+    UriMemoryManager memory;
+    UriMemoryArena arena;
+    UriMemoryManager backend;
+    char buffer[64];
+
+    EXPECT_EQ(uriInitArenaMemoryManager(NULL, &arena, buffer, sizeof(buffer), 0, NULL),
+            URI_ERROR_NULL);
+    EXPECT_EQ(uriInitArenaMemoryManager(&memory, NULL, buffer, sizeof(buffer), 0, NULL),
+            URI_ERROR_NULL);
+    EXPECT_EQ(uriInitArenaMemoryManager(&memory, &arena, NULL, 0, 0, NULL),
+            URI_ERROR_NULL);
+
+    memset(&backend, 0, sizeof(UriMemoryManager));
+    EXPECT_EQ(uriInitArenaMemoryManager(&memory, &arena, NULL, 0, 64, &backend),
+            URI_ERROR_MEMORY_MANAGER_INCOMPLETE);
+
+    EXPECT_EQ(uriResetMemoryArena(NULL), URI_ERROR_NULL);
+    uriFreeMemoryArena(NULL);
+}
+
+TEST(MemoryArenaSuite, FixedBufferExhaustion) {
+    UriMemoryManager memory;
+    UriMemoryArena arena;
+    long double buffer[16];
+
+    ASSERT_EQ(uriInitArenaMemoryManager(
+                      &memory, &arena, buffer, sizeof(buffer), 0, NULL),
+            URI_SUCCESS);
+    EXPECT_TRUE(memory.malloc(&memory, sizeof(buffer)) == NULL);
+    EXPECT_TRUE(memory.malloc(&memory, 1) != NULL);
+
+    uriFreeMemoryArena(&arena);
+}
+
+TEST(MemoryArenaSuite, ReallocGrowsMostRecentAllocationInPlace) {
+    UriMemoryManager memory;
+    UriMemoryArena arena;
+    long double buffer[64];
+
+    ASSERT_EQ(uriInitArenaMemoryManager(
+                      &memory, &arena, buffer, sizeof(buffer), 0, NULL),
+            URI_SUCCESS);
+
+    char * const first = static_cast<char *>(memory.malloc(&memory, 3));
+    ASSERT_TRUE(first != NULL);
+    memcpy(first, "abc", 3);
+
+    char * const grown = static_cast<char *>(memory.realloc(&memory, first, 100));
+    EXPECT_EQ(grown, first);
+
+    char * const second = static_cast<char *>(memory.malloc(&memory, 1));
+    ASSERT_TRUE(second != NULL);
+
+    char * const moved = static_cast<char *>(memory.realloc(&memory, grown, 200));
+    ASSERT_TRUE(moved != NULL);
+    EXPECT_NE(moved, grown);
+    EXPECT_EQ(memcmp(moved, "abc", 3), 0);
+
+    uriFreeMemoryArena(&arena);
+}
+
+TEST(MemoryArenaSuite, ResetReusesMemory) {
+    UriMemoryManager memory;
+    UriMemoryArena arena;
+    long double buffer[64];
+
+    ASSERT_EQ(uriInitArenaMemoryManager(
+                      &memory, &arena, buffer, sizeof(buffer), 0, NULL),
+            URI_SUCCESS);
+
+    void * const before = memory.malloc(&memory, 10);
+    ASSERT_TRUE(before != NULL);
+    ASSERT_TRUE(memory.malloc(&memory, 10) != NULL);
+
+    ASSERT_EQ(uriResetMemoryArena(&arena), URI_SUCCESS);
+    EXPECT_EQ(memory.malloc(&memory, 10), before);
+
+    uriFreeMemoryArena(&arena);
+}
+
+TEST(MemoryArenaSuite, ResetKeepsMostRecentChunk) {
+    UriMemoryManager memory;
+    UriMemoryArena arena;
+    FailingMemoryManager backend(1000);
+
+    ASSERT_EQ(uriInitArenaMemoryManager(&memory, &arena, NULL, 0, 256, &backend),
+            URI_SUCCESS);
+    EXPECT_EQ(backend.getCallCountAlloc(), 0U);
+
+    /* Three allocations overflow the first chunk */
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(memory.malloc(&memory, 100) != NULL);
+    }
+    ASSERT_EQ(backend.getCallCountAlloc(), 2U);
+    ASSERT_EQ(uriResetMemoryArena(&arena), URI_SUCCESS);
+    EXPECT_EQ(backend.getCallCountFree(), 1U);
+
+    /* Two allocations fit into the chunk kept by the reset */
+    for (int round = 0; round < 3; round++) {
+        ASSERT_TRUE(memory.malloc(&memory, 100) != NULL);
+        ASSERT_TRUE(memory.malloc(&memory, 100) != NULL);
+        ASSERT_EQ(uriResetMemoryArena(&arena), URI_SUCCESS);
+    }
+    EXPECT_EQ(backend.getCallCountAlloc(), 2U);
+    EXPECT_EQ(backend.getCallCountFree(), 1U);
+
+    uriFreeMemoryArena(&arena);
+    EXPECT_EQ(backend.getCallCountFree(), 2U);
+}
+
+TEST(MemoryArenaSuite, ParseNormalizeAndRecomposeWithReset) {
+    UriMemoryManager memory;
+    UriMemoryArena arena;
+    long double buffer[256];
+    FailingMemoryManager backend(1000);
+
+    ASSERT_EQ(uriInitArenaMemoryManager(
+                      &memory, &arena, buffer, sizeof(buffer), 512, &backend),
+            URI_SUCCESS);
+
+    const char * const inputs[][2] = {
+            {"HTTP://www.EXAMPLE.org/a/./b/../c?q#f", "http://www.example.org/a/c?q#f"},
+            {"file:///%7eme/x/../y", "file:///~me/y"},
+            {"mailto:Someone@Example.ORG", "mailto:Someone@Example.ORG"},
+    };
+
+    for (int round = 0; round < 2; round++) {
+        for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+            SCOPED_TRACE(inputs[i][0]);
+            const char * const first = inputs[i][0];
+            UriUriA uri;
+
+            ASSERT_EQ(uriParseSingleUriExMmA(
+                              &uri, first, first + strlen(first), NULL, &memory),
+                    URI_SUCCESS);
+            ASSERT_EQ(uriNormalizeSyntaxExMmA(&uri, (unsigned int)-1, &memory),
+                    URI_SUCCESS);
+            assertToString(&uri, inputs[i][1]);
+            uriFreeUriMembersMmA(&uri, &memory);
+
+            ASSERT_EQ(uriResetMemoryArena(&arena), URI_SUCCESS);
+        }
+    }
+    EXPECT_EQ(backend.getCallCountAlloc(), 0U);
+
+    uriFreeMemoryArena(&arena);
+}
+
+TEST(MemoryRecyclerSuite, PassesMemoryManagerTests) {
+    UriMemoryManager memory;
+    UriMemoryRecycler recycler;
+    FailingMemoryManager backend(1000);
+
+    ASSERT_EQ(uriInitRecyclingMemoryManager(&memory, &recycler, &backend), URI_SUCCESS);
+    ASSERT_EQ(uriTestMemoryManagerEx(&memory, URI_TRUE), URI_SUCCESS);
+
+    uriFreeMemoryRecycler(&recycler);
+    EXPECT_EQ(backend.getCallCountAlloc(), backend.getCallCountFree());
+}
+
+TEST(MemoryRecyclerSuite, InvalidArguments) {
+    UriMemoryManager memory;
+    UriMemoryRecycler recycler;
+    UriMemoryManager backend;
+
+    EXPECT_EQ(uriInitRecyclingMemoryManager(NULL, &recycler, NULL), URI_ERROR_NULL);
+    EXPECT_EQ(uriInitRecyclingMemoryManager(&memory, NULL, NULL), URI_ERROR_NULL);
+
+    memset(&backend, 0, sizeof(UriMemoryManager));
+    EXPECT_EQ(uriInitRecyclingMemoryManager(&memory, &recycler, &backend),
+            URI_ERROR_MEMORY_MANAGER_INCOMPLETE);
+
+    uriFreeMemoryRecycler(NULL);
+}
+
+TEST(MemoryRecyclerSuite, ReusesSmallAllocationsOnly) {
+    UriMemoryManager memory;
+    UriMemoryRecycler recycler;
+    FailingMemoryManager backend(1000);
+
+    ASSERT_EQ(uriInitRecyclingMemoryManager(&memory, &recycler, &backend), URI_SUCCESS);
+
+    void * const small = memory.malloc(&memory, 10);
+    ASSERT_TRUE(small != NULL);
+    memory.free(&memory, small);
+    EXPECT_EQ(memory.malloc(&memory, 12), small);
+    EXPECT_EQ(backend.getCallCountFree(), 0U);
+
+    void * const large = memory.malloc(&memory, 1000);
+    ASSERT_TRUE(large != NULL);
+    memory.free(&memory, large);
+    EXPECT_EQ(backend.getCallCountFree(), 1U);
+
+    memory.free(&memory, small);
+    uriFreeMemoryRecycler(&recycler);
+    EXPECT_EQ(backend.getCallCountAlloc(), backend.getCallCountFree());
+}
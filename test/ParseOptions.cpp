@@ -0,0 +1,273 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <uriparser/Uri.h>
+
+#include <cstring>
+#include <string>
+
+#include "FailingMemoryManager.h"
+
+namespace {
+
+bool rangeEquals(const UriTextRangeA * range, const char * expected) {
+    if (expected == NULL) {
+        return range->first == NULL;
+    }
+    return (range->first != NULL)
+           && (std::string(range->first, range->afterLast) == expected);
+}
+
+bool testSkipHostDataHelper(
+        const char * uriText, const char * expectedHostText, bool expectedIpFuture) {
+    FailingMemoryManager failingMemoryManager;
+    UriUriA uri;
+
+    if (uriParseSingleUriOptionsMmA(&uri, uriText, uriText + strlen(uriText), NULL,
+                URI_PARSE_SKIP_HOST_DATA, &failingMemoryManager)
+            != URI_SUCCESS) {
+        return false;
+    }
+
+    const bool success = (failingMemoryManager.getCallCountAlloc() == 0)
+                         && (uri.hostData.ip4 == NULL) && (uri.hostData.ip6 == NULL)
+                         && ((uri.hostData.ipFuture.first != NULL) == expectedIpFuture)
+                         && rangeEquals(&uri.hostText, expectedHostText);
+    uriFreeUriMembersMmA(&uri, &failingMemoryManager);
+    return success;
+}
+
+bool testSkipHostDataRoundTripHelper(const char * uriText) {
+    UriUriA uri;
+    UriUriA reparsed;
+    char recomposed[64];
+
+    if (uriParseSingleUriOptionsA(&uri, uriText, NULL, NULL, URI_PARSE_SKIP_HOST_DATA)
+            != URI_SUCCESS) {
+        return false;
+    }
+    if ((uriToStringA(recomposed, &uri, sizeof(recomposed), NULL) != URI_SUCCESS)
+            || (strcmp(recomposed, uriText) != 0)
+            || (uriParseSingleUriOptionsA(
+                        &reparsed, recomposed, NULL, NULL, URI_PARSE_SKIP_HOST_DATA)
+                    != URI_SUCCESS)) {
+        uriFreeUriMembersA(&uri);
+        return false;
+    }
+
+    const bool success =
+            uriEqualsUriA(&uri, &reparsed)
+            && (uriNormalizeSyntaxA(&reparsed) == URI_SUCCESS)
+            && (uriToStringA(recomposed, &reparsed, sizeof(recomposed), NULL)
+                    == URI_SUCCESS)
+            && (strcmp(recomposed, uriText) == 0);
+
+    uriFreeUriMembersA(&reparsed);
+    uriFreeUriMembersA(&uri);
+    return success;
+}
+
+bool testSkipHostDataSyntaxErrorHelper(const char * uriText) {
+    const char * const afterLast = uriText + strlen(uriText);
+    const char * expectedErrorPos = NULL;
+    const char * errorPos = NULL;
+    FailingMemoryManager failingMemoryManager;
+    UriUriA uri;
+
+    if (uriParseSingleUriExMmA(&uri, uriText, afterLast, &expectedErrorPos, NULL)
+            != URI_ERROR_SYNTAX) {
+        return false;
+    }
+    if (uriParseSingleUriOptionsMmA(&uri, uriText, afterLast, &errorPos,
+                URI_PARSE_SKIP_HOST_DATA, &failingMemoryManager)
+            != URI_ERROR_SYNTAX) {
+        return false;
+    }
+    return errorPos == expectedErrorPos;
+}
+
+bool testStopAfterAuthorityHelper(const char * uriText, const char * expectedScheme,
+        const char * expectedHostText, const char * expectedPortText) {
+    UriUriA uri;
+
+    if (uriParseSingleUriOptionsA(
+                &uri, uriText, NULL, NULL, URI_PARSE_STOP_AFTER_AUTHORITY)
+            != URI_SUCCESS) {
+        return false;
+    }
+
+    const bool success = rangeEquals(&uri.scheme, expectedScheme)
+                         && rangeEquals(&uri.hostText, expectedHostText)
+                         && rangeEquals(&uri.portText, expectedPortText)
+                         && (uri.pathHead == NULL) && (uri.query.first == NULL)
+                         && (uri.fragment.first == NULL);
+    uriFreeUriMembersA(&uri);
+    return success;
+}
+
+bool testKeepPartialHelper(const char * uriText, const char * expectedRecomposition,
+        int expectedErrorOffset) {
+    const char * errorPos = NULL;
+    FailingMemoryManager countingMemoryManager(1000);
+    UriUriA uri;
+
+    if ((uriParseSingleUriOptionsMmA(&uri, uriText, uriText + strlen(uriText), &errorPos,
+                 URI_PARSE_KEEP_PARTIAL, &countingMemoryManager)
+                != URI_ERROR_SYNTAX)
+            || (errorPos != uriText + expectedErrorOffset)) {
+        return false;
+    }
+
+    int charsRequired = 0;
+    bool success = uriToStringCharsRequiredA(&uri, &charsRequired) == URI_SUCCESS;
+    if (success) {
+        std::string recomposed(charsRequired + 1, '\0');
+        success = (uriToStringA(&recomposed[0], &uri, charsRequired + 1, NULL)
+                          == URI_SUCCESS)
+                  && (strcmp(recomposed.c_str(), expectedRecomposition) == 0);
+    }
+
+    uriFreeUriMembersMmA(&uri, &countingMemoryManager);
+    return success
+           && (countingMemoryManager.getCallCountAlloc()
+                   == countingMemoryManager.getCallCountFree());
+}
+
+}  // namespace
+
+TEST(ParseOptionsSuite, SkipHostDataAllocatesNothing) {
+    ASSERT_TRUE(testSkipHostDataHelper("http://1.2.3.4:80", "1.2.3.4", false));
+    ASSERT_TRUE(testSkipHostDataHelper("http://[::1]", "::1", false));
+    ASSERT_TRUE(testSkipHostDataHelper("http://[v7.x]", "v7.x", true));
+    ASSERT_TRUE(testSkipHostDataHelper("http://example.org", "example.org", false));
+}
+
+TEST(ParseOptionsSuite, SkipHostDataRoundTrips) {
+    ASSERT_TRUE(testSkipHostDataRoundTripHelper("http://[::1]:80/x"));
+    ASSERT_TRUE(testSkipHostDataRoundTripHelper("http://[v7.abc]/y"));
+    ASSERT_TRUE(testSkipHostDataRoundTripHelper("http://user@[2001:db8::7]/"));
+    ASSERT_TRUE(testSkipHostDataRoundTripHelper("http://1.2.3.4/z"));
+}
+
+TEST(ParseOptionsSuite, SkipHostDataStillChecksSyntax) {
+    ASSERT_TRUE(testSkipHostDataSyntaxErrorHelper("http://[::x]/"));
+    ASSERT_TRUE(testSkipHostDataSyntaxErrorHelper("http://[1:2:3:4:5:6:7:8:9]/"));
+    ASSERT_TRUE(testSkipHostDataSyntaxErrorHelper("http://[v7.]/"));
+}
+
+TEST(ParseOptionsSuite, StopAfterAuthority) {
+    ASSERT_TRUE(testStopAfterAuthorityHelper(
+            "http://user@example.org:8080/a/b?%zz#%zz", "http", "example.org", "8080"));
+    ASSERT_TRUE(testStopAfterAuthorityHelper(
+            "http://example.org?q", "http", "example.org", NULL));
+    ASSERT_TRUE(testStopAfterAuthorityHelper("//[::1]#f", NULL, "::1", NULL));
+    ASSERT_TRUE(testStopAfterAuthorityHelper(
+            "mailto:someone@example.org", "mailto", NULL, NULL));
+    ASSERT_TRUE(testStopAfterAuthorityHelper("a/b/c", NULL, NULL, NULL));
+}
+
+TEST(ParseOptionsSuite, StopAfterAuthorityStillChecksAuthority) {
+    const char * const first = "http://exa^mple.org/";
+    const char * errorPos = NULL;
+    UriUriA uri;
+
+    ASSERT_EQ(uriParseSingleUriOptionsA(
+                      &uri, first, NULL, &errorPos, URI_PARSE_STOP_AFTER_AUTHORITY),
+            URI_ERROR_SYNTAX);
+    EXPECT_EQ(errorPos, first + 10);
+}
+
+TEST(ParseOptionsSuite, SkipHostDataWithRawPath) {
+    const char * const first = "http://[::1]:8080/a/b/c?x";
+    const char * const afterLast = first + strlen(first);
+    FailingMemoryManager countingMemoryManager(1000);
+    UriUriA uri;
+
+    ASSERT_EQ(uriParseSingleUriOptionsMmA(&uri, first, afterLast, NULL,
+                      URI_PARSE_SKIP_HOST_DATA | URI_PARSE_RAW_PATH_ONLY,
+                      &countingMemoryManager),
+            URI_SUCCESS);
+    EXPECT_EQ(countingMemoryManager.getCallCountAlloc(), 1U);
+    EXPECT_TRUE(uri.hostData.ip6 == NULL);
+    ASSERT_TRUE(uri.pathHead != NULL);
+    EXPECT_EQ(uri.pathHead, uri.pathTail);
+    EXPECT_EQ(std::string(uri.pathHead->text.first, uri.pathHead->text.afterLast),
+            "a/b/c");
+
+    ASSERT_EQ(uriEnsurePathSegmentsMmA(&uri, &countingMemoryManager), URI_SUCCESS);
+    EXPECT_EQ(std::string(uri.pathTail->text.first, uri.pathTail->text.afterLast), "c");
+
+    uriFreeUriMembersMmA(&uri, &countingMemoryManager);
+    EXPECT_EQ(countingMemoryManager.getCallCountAlloc(),
+            countingMemoryManager.getCallCountFree());
+}
+
+TEST(ParseOptionsSuite, KeepPartialOnSyntaxError) {
+    ASSERT_TRUE(testKeepPartialHelper(
+            "http://example.org/a/b/c d", "http://example.org/a/b/c", 24));
+    ASSERT_TRUE(testKeepPartialHelper(
+            "http://example.org/a/b?q=%zz", "http://example.org/a/b", 26));
+    ASSERT_TRUE(testKeepPartialHelper("http://[::1x]/a", "http:", 11));
+    ASSERT_TRUE(testKeepPartialHelper("http://[v1.x/", "http:", 12));
+    ASSERT_TRUE(testKeepPartialHelper("http://[::1", "http:", 11));
+    ASSERT_TRUE(testKeepPartialHelper("http://user@ho^st/", "http:", 14));
+    ASSERT_TRUE(testKeepPartialHelper("http://us^er@host/a", "http:", 9));
+    ASSERT_TRUE(testKeepPartialHelper("http://host:8x/a", "http:", 14));
+    ASSERT_TRUE(testKeepPartialHelper("http://host^/a", "http:", 11));
+    ASSERT_TRUE(testKeepPartialHelper("http://host/a^b", "http://host/a", 13));
+    ASSERT_TRUE(testKeepPartialHelper("http://host?q^", "http://host?q", 13));
+    ASSERT_TRUE(testKeepPartialHelper("ht^tp://x", "ht", 2));
+}
+
+TEST(ParseOptionsSuite, KeepPartialKeepsHostData) {
+    const char * const first = "http://[::1]:8/a b";
+    const char * const afterLast = first + strlen(first);
+    FailingMemoryManager countingMemoryManager(1000);
+    UriUriA uri;
+
+    ASSERT_EQ(uriParseSingleUriOptionsMmA(&uri, first, afterLast, NULL,
+                      URI_PARSE_KEEP_PARTIAL, &countingMemoryManager),
+            URI_ERROR_SYNTAX);
+    EXPECT_EQ(std::string(uri.hostText.first, uri.hostText.afterLast), "::1");
+    ASSERT_TRUE(uri.hostData.ip6 != NULL);
+    EXPECT_EQ(uri.hostData.ip6->data[15], 1);
+    EXPECT_EQ(std::string(uri.portText.first, uri.portText.afterLast), "8");
+    ASSERT_TRUE(uri.pathHead != NULL);
+    EXPECT_EQ(std::string(uri.pathHead->text.first, uri.pathHead->text.afterLast), "a");
+
+    uriFreeUriMembersMmA(&uri, &countingMemoryManager);
+    EXPECT_EQ(countingMemoryManager.getCallCountAlloc(),
+            countingMemoryManager.getCallCountFree());
+}
+
+TEST(ParseOptionsSuite, KeepPartialStillFreesOnMallocFailure) {
+    const char * const first = "http://example.org/a/b/c d";
+    const char * const afterLast = first + strlen(first);
+    FailingMemoryManager failingMemoryManager(2);
+    UriUriA uri;
+
+    ASSERT_EQ(uriParseSingleUriOptionsMmA(&uri, first, afterLast, NULL,
+                      URI_PARSE_KEEP_PARTIAL, &failingMemoryManager),
+            URI_ERROR_MALLOC);
+    EXPECT_EQ(failingMemoryManager.getCallCountAlloc(),
+            failingMemoryManager.getCallCountFree() + 1);
+}
@@ -0,0 +1,109 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2026, Sebastian Pipping <sebastian@pipping.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <uriparser/Uri.h>
+
+#include <cstring>
+
+#include "FailingMemoryManager.h"
+
+namespace {
+
+bool toStringEquals(const UriUriA * uri, const char * expected) {
+    char buffer[100];
+    if (uriToStringA(buffer, uri, sizeof(buffer), NULL) != URI_SUCCESS) {
+        return false;
+    }
+    return strcmp(buffer, expected) == 0;
+}
+
+}  // namespace
+
+TEST(ParserContextSuite, SteadyStateParsingTakesNoAllocations) {
+    const char * const inputs[] = {
+            "http://user@1.2.3.4:80/a/b/c?q#f",
+            "https://[0000:0000:0000:0000:0000:0000:0000:0001]/x/y/z/",
+            "mailto:someone@example.org",
+            "../../a/b/c/d/e/f",
+    };
+    FailingMemoryManager backend(1000);
+    UriParserContextA context;
+
+    ASSERT_EQ(uriInitParserContextMmA(&context, &backend), URI_SUCCESS);
+
+    unsigned int allocsAfterFirstRound = 0;
+    for (int round = 0; round < 3; round++) {
+        for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+            SCOPED_TRACE(inputs[i]);
+            const char * const first = inputs[i];
+            UriUriA uri;
+
+            ASSERT_EQ(uriParseSingleUriContextA(
+                              &context, &uri, first, first + strlen(first), NULL),
+                    URI_SUCCESS);
+            EXPECT_TRUE(toStringEquals(&uri, first));
+            ASSERT_EQ(uriFreeUriMembersContextA(&context, &uri), URI_SUCCESS);
+        }
+        if (round == 0) {
+            allocsAfterFirstRound = backend.getCallCountAlloc();
+        }
+    }
+    EXPECT_GT(allocsAfterFirstRound, 0U);
+    EXPECT_EQ(backend.getCallCountAlloc(), allocsAfterFirstRound);
+    EXPECT_EQ(backend.getCallCountFree(), 0U);
+
+    uriFreeParserContextA(&context);
+    EXPECT_EQ(backend.getCallCountAlloc(), backend.getCallCountFree());
+}
+
+TEST(ParserContextSuite, SyntaxErrorKeepsMemoryForReuse) {
+    const char * const first = "http://example.org/a/b/c?%zz";
+    const char * errorPos = NULL;
+    FailingMemoryManager backend(1000);
+    UriParserContextA context;
+    UriUriA uri;
+
+    ASSERT_EQ(uriInitParserContextMmA(&context, &backend), URI_SUCCESS);
+    ASSERT_EQ(uriParseSingleUriContextA(
+                      &context, &uri, first, first + strlen(first), &errorPos),
+            URI_ERROR_SYNTAX);
+    EXPECT_EQ(errorPos, first + 26);
+    EXPECT_EQ(backend.getCallCountFree(), 0U);
+
+    uriFreeParserContextA(&context);
+    EXPECT_EQ(backend.getCallCountAlloc(), backend.getCallCountFree());
+}
+
+TEST(ParserContextSuite, InvalidArguments) {
+    UriParserContextA context;
+    UriUriA uri;
+    const char * const first = "a";
+
+    EXPECT_EQ(uriInitParserContextMmA(NULL, NULL), URI_ERROR_NULL);
+    EXPECT_EQ(uriParseSingleUriContextA(NULL, &uri, first, first + 1, NULL),
+            URI_ERROR_NULL);
+    EXPECT_EQ(uriFreeUriMembersContextA(NULL, &uri), URI_ERROR_NULL);
+    uriFreeParserContextA(NULL);
+
+    ASSERT_EQ(uriInitParserContextMmA(&context, NULL), URI_SUCCESS);
+    uriFreeParserContextA(&context);
+}
@@ -120,6 +120,11 @@ TEST(IsWellFormedHostIp6, MaxLengthViolation) {
             false);
 }
 
+TEST(IsWellFormedHostIp6, MaxLengthIp4Embedding) {
+    testIsWellFormedHostIp6("ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255", true);
+    testIsWellFormedHostIp6("ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.2550", false);
+}
+
 TEST(IsWellFormedHostIp6, NineQuads) {
     testIsWellFormedHostIp6("1:2:3:4:5:6:7:8:9", false);
 }
@@ -23,15 +23,26 @@
 #include <uriparser/UriIp4.h>
 #include <gtest/gtest.h>
 #include <memory>
+#include <string>
+#include <vector>
 #include <cstdio>
 #include <cstdlib>
 #include <cwchar>
 
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#endif
+
 using namespace std;
 
 extern "C" {
 UriBool uri_TESTING_ONLY_ParseIpSixA(const char * text);
+UriBool uri_TESTING_ONLY_ParseIpSixReferenceA(unsigned char * output, const char * text);
 UriBool uri_TESTING_ONLY_ParseIpFourA(const char * text);
+int uri_TESTING_ONLY_ParseIpFourAddressReferenceA(
+        unsigned char * octetOutput, const char * first, const char * afterLast);
 bool uriRangeEqualsA(const UriTextRangeA * a, const UriTextRangeA * b);
 }
 
@@ -309,6 +320,100 @@ TEST(UriSuite, TestIpSixOverread) {
     EXPECT_EQ(errorPos, uriText + sizeof(uriText));
 }
 
+namespace {
+void expectSameAsReferenceIpSix(const std::string & text) {
+    UriIp6 ip6;
+    unsigned char referenceOctets[16];
+    const UriBool referenceWellFormed =
+            uri_TESTING_ONLY_ParseIpSixReferenceA(referenceOctets, (text + "]").c_str());
+
+    // Public entry point
+    const int res = uriParseIpSixAddressA(&ip6, text.data(), text.data() + text.size());
+    ASSERT_EQ(res == URI_SUCCESS, referenceWellFormed == URI_TRUE)
+            << "\"" << text << "\"";
+    if (res == URI_SUCCESS) {
+        ASSERT_EQ(memcmp(ip6.data, referenceOctets, 16), 0) << "\"" << text << "\"";
+    }
+
+    // Bracketed inside a URI
+    const std::string uriText = "//[" + text + "]";
+    UriUriA uri;
+    const int uriRes = uriParseSingleUriExA(
+            &uri, uriText.data(), uriText.data() + uriText.size(), NULL);
+    if (text.find_first_of("vV") == std::string::npos) {
+        ASSERT_EQ(uriRes == URI_SUCCESS, referenceWellFormed == URI_TRUE)
+                << "\"" << uriText << "\"";
+    }
+    if (uriRes == URI_SUCCESS) {
+        if (uri.hostData.ip6 != NULL) {
+            ASSERT_EQ(memcmp(uri.hostData.ip6->data, referenceOctets, 16), 0)
+                    << "\"" << uriText << "\"";
+            ASSERT_EQ(uri.hostText.afterLast, uriText.data() + uriText.size() - 1);
+        }
+        uriFreeUriMembersA(&uri);
+    }
+}
+}  // namespace
+
+TEST(ParseIpSixAddressSuite, AgreesWithReferenceExhaustiveShort) {
+    const char alphabet[] = {'0', 'f', 'F', ':', '.', 'g'};
+    const size_t alphabetSize = sizeof(alphabet);
+    for (size_t len = 0; len <= 7; len++) {
+        size_t combinations = 1;
+        for (size_t i = 0; i < len; i++) {
+            combinations *= alphabetSize;
+        }
+        std::string text(len, ' ');
+        for (size_t n = 0; n < combinations; n++) {
+            size_t rest = n;
+            for (size_t i = 0; i < len; i++) {
+                text[i] = alphabet[rest % alphabetSize];
+                rest /= alphabetSize;
+            }
+            expectSameAsReferenceIpSix(text);
+            if (::testing::Test::HasFatalFailure()) {
+                return;
+            }
+        }
+    }
+}
+
+TEST(ParseIpSixAddressSuite, AgreesWithReferenceRandomGroups) {
+    const char * const groups[] = {"", "", "0", "1", "ab", "abc", "ffff", "FfFf", "12345",
+            "1.2.3.4", "255.255.255.255", "256.1.1.1", "01.2.3.4", "1.2.3", "g", "\x80",
+            "v1"};
+    const size_t groupCount = sizeof(groups) / sizeof(groups[0]);
+
+    unsigned int seed = 1;
+    for (int round = 0; round < 100000; round++) {
+        std::string text;
+        seed = seed * 1103515245U + 12345U;
+        const unsigned int groupsWanted = 1 + (seed >> 16) % 10;
+        for (unsigned int k = 0; k < groupsWanted; k++) {
+            if (k > 0) {
+                text += ':';
+            }
+            seed = seed * 1103515245U + 12345U;
+            text += groups[(seed >> 16) % groupCount];
+        }
+        expectSameAsReferenceIpSix(text);
+        if (::testing::Test::HasFatalFailure()) {
+            return;
+        }
+    }
+}
+
+TEST(ParseIpSixAddressSuite, FullLengthWithEmbeddedIpFour) {
+    const char * const text = "0000:0000:0000:0000:0000:ffff:192.168.0.1";
+    UriIp6 ip6;
+    const unsigned char expected[16] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 192, 168, 0, 1};
+    ASSERT_EQ(uriParseIpSixAddressA(&ip6, text, text + strlen(text)), URI_SUCCESS);
+    EXPECT_EQ(memcmp(ip6.data, expected, 16), 0);
+    expectSameAsReferenceIpSix(text);
+    expectSameAsReferenceIpSix("ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255");
+}
+
 TEST(UriSuite, TestUri) {
     UriParserStateA stateA;
     UriParserStateW stateW;
@@ -955,6 +1060,244 @@ TEST(UriSuite, TestEscaping) {
             testEscapingHelper(L"\x0a\x0dg", L"%0A%0Dg", SPACE_TO_PLUS, KEEP_UNMODIFIED));
 }
 
+TEST(UriSuite, TestEscapingLongRuns) {
+    char input[40];
+    char output[3 * sizeof(input) + 1];
+
+    for (int c = 1; c < 256; c++) {
+        for (size_t pos = 0; pos < sizeof(input); pos++) {
+            SCOPED_TRACE(c);
+            SCOPED_TRACE(pos);
+            memset(input, 'a', sizeof(input));
+            input[pos] = static_cast<char>(c);
+
+            std::string expected(pos, 'a');
+            if (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'))
+                    || ((c >= '0') && (c <= '9')) || (c == '-') || (c == '.')
+                    || (c == '_') || (c == '~')) {
+                expected += static_cast<char>(c);
+            } else {
+                char encoded[4];
+                snprintf(encoded, sizeof(encoded), "%%%02X", c);
+                expected += encoded;
+            }
+            expected.append(sizeof(input) - pos - 1, 'a');
+
+            const char * const afterLast = uriEscapeExA(input, input + sizeof(input),
+                    output, URI_FALSE, URI_FALSE);
+            ASSERT_EQ(std::string(output, afterLast - output), expected);
+        }
+    }
+}
+
+TEST(UriSuite, TestEscapingLongRunsKeepsOptions) {
+    const char * const input =
+            "abcdefghijklmnopqrstuvwxyz0123456789 ABCDEFGHIJKLMNOPQRSTUV"
+            "\r\nabcdefghijklmnopqrstuvwxyz0123456789\n";
+    char output[3 * 2 * 80];
+
+    uriEscapeExA(input, input + strlen(input), output, URI_TRUE, URI_TRUE);
+    EXPECT_STREQ(output,
+            "abcdefghijklmnopqrstuvwxyz0123456789+ABCDEFGHIJKLMNOPQRSTUV"
+            "%0D%0Aabcdefghijklmnopqrstuvwxyz0123456789%0D%0A");
+
+    // Zero-terminated input without explicit end
+    uriEscapeA(input, output, URI_FALSE, URI_FALSE);
+    EXPECT_STREQ(output,
+            "abcdefghijklmnopqrstuvwxyz0123456789%20ABCDEFGHIJKLMNOPQRSTUV"
+            "%0D%0Aabcdefghijklmnopqrstuvwxyz0123456789%0A");
+}
+
+TEST(UriSuite, TestEscapeCharsRequiredMatchesEscape) {
+    const char * const inputs[] = {
+            "",
+            "abc",
+            "abc def",
+            "\r",
+            "\n",
+            "\r\n",
+            "\n\r",
+            "g\r\ng\n\rg",
+            "~%/?#[]@!$&'()*+,;=:\xff",
+            "abcdefghijklmnopqrstuvwxyz0123456789 ABCDEFGHIJKLMNOPQRSTUV\r\n\r\n",
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        const char * const first = inputs[i];
+        const char * const afterLast = first + strlen(first);
+        for (int flags = 0; flags < 4; flags++) {
+            const UriBool spaceToPlus = (flags & 1) ? URI_TRUE : URI_FALSE;
+            const UriBool normalizeBreaks = (flags & 2) ? URI_TRUE : URI_FALSE;
+            char output[6 * 80];
+            const char * const terminator =
+                    uriEscapeExA(first, afterLast, output, spaceToPlus, normalizeBreaks);
+
+            int charsRequired = -1;
+            ASSERT_EQ(uriEscapeCharsRequiredExA(first, afterLast, spaceToPlus,
+                              normalizeBreaks, &charsRequired),
+                    URI_SUCCESS);
+            EXPECT_EQ(charsRequired, terminator - output);
+
+            // Zero-terminated input without explicit end
+            charsRequired = -1;
+            ASSERT_EQ(uriEscapeCharsRequiredExA(
+                              first, NULL, spaceToPlus, normalizeBreaks, &charsRequired),
+                    URI_SUCCESS);
+            EXPECT_EQ(charsRequired, terminator - output);
+
+            char * dest = NULL;
+            ASSERT_EQ(uriEscapeMallocExA(
+                              &dest, first, afterLast, spaceToPlus, normalizeBreaks),
+                    URI_SUCCESS);
+            EXPECT_STREQ(dest, output);
+            free(dest);
+        }
+    }
+}
+
+TEST(UriSuite, TestEscapeCharsRequiredWide) {
+    const wchar_t * const input = L"a b\r\n\x00ff\x0100";
+    int charsRequired = -1;
+    ASSERT_EQ(uriEscapeCharsRequiredExW(input, NULL, URI_FALSE, URI_TRUE, &charsRequired),
+            URI_SUCCESS);
+    EXPECT_EQ(charsRequired, 1 + 3 + 1 + 6 + 3 + 3);
+
+    wchar_t * dest = NULL;
+    ASSERT_EQ(uriEscapeMallocExW(&dest, input, NULL, URI_FALSE, URI_TRUE), URI_SUCCESS);
+    EXPECT_EQ(wcslen(dest), (size_t)charsRequired);
+    free(dest);
+}
+
+TEST(UriSuite, TestEscapeCharsRequiredNull) {
+    int charsRequired = -1;
+    ASSERT_EQ(uriEscapeCharsRequiredExA("abc", NULL, URI_FALSE, URI_FALSE, NULL),
+            URI_ERROR_NULL);
+    ASSERT_EQ(uriEscapeCharsRequiredExA(NULL, NULL, URI_FALSE, URI_FALSE, &charsRequired),
+            URI_SUCCESS);
+    EXPECT_EQ(charsRequired, 0);
+    ASSERT_EQ(uriEscapeMallocExA(NULL, "abc", NULL, URI_FALSE, URI_FALSE),
+            URI_ERROR_NULL);
+}
+
+TEST(UriSuite, TestEscapeComponent) {
+    const char * const input = "a b/c?d#e&f=g+h:i@j%k";
+    const struct {
+        UriEscapeComponent component;
+        const char * expected;
+    } cases[] = {
+            {URI_ESCAPE_UNRESERVED, "a%20b%2Fc%3Fd%23e%26f%3Dg%2Bh%3Ai%40j%25k"},
+            {URI_ESCAPE_USERINFO, "a%20b%2Fc%3Fd%23e&f=g+h:i%40j%25k"},
+            {URI_ESCAPE_SEGMENT, "a%20b%2Fc%3Fd%23e&f=g+h:i@j%25k"},
+            {URI_ESCAPE_PATH, "a%20b/c%3Fd%23e&f=g+h:i@j%25k"},
+            {URI_ESCAPE_QUERY_VALUE, "a%20b/c?d%23e%26f%3Dg%2Bh:i@j%25k"},
+            {URI_ESCAPE_FRAGMENT, "a%20b/c?d%23e&f=g+h:i@j%25k"},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        SCOPED_TRACE(i);
+        char output[3 * 32];
+        const char * const terminator = uriEscapeComponentExA(input,
+                input + strlen(input), output, cases[i].component, URI_FALSE, URI_FALSE);
+        EXPECT_STREQ(output, cases[i].expected);
+
+        int charsRequired = -1;
+        ASSERT_EQ(uriEscapeComponentCharsRequiredExA(input, NULL, cases[i].component,
+                          URI_FALSE, URI_FALSE, &charsRequired),
+                URI_SUCCESS);
+        EXPECT_EQ(charsRequired, terminator - output);
+    }
+
+    wchar_t outputWide[3 * 32];
+    uriEscapeComponentExW(L"a b/c?d", NULL, outputWide, URI_ESCAPE_PATH, URI_TRUE,
+            URI_FALSE);
+    EXPECT_STREQ(outputWide, L"a+b/c%3Fd");
+}
+
+TEST(UriSuite, TestEscapeComponentSpaceToPlusEscapesPlus) {
+    const char * const input = "q rstuvwxyzabcdefghijklmnopqrstuvwxyz+!";
+    const UriEscapeComponent components[] = {URI_ESCAPE_UNRESERVED, URI_ESCAPE_USERINFO,
+            URI_ESCAPE_SEGMENT, URI_ESCAPE_PATH, URI_ESCAPE_QUERY_VALUE,
+            URI_ESCAPE_FRAGMENT};
+
+    for (size_t i = 0; i < sizeof(components) / sizeof(components[0]); i++) {
+        SCOPED_TRACE(i);
+        char output[3 * 48];
+        const char * const terminator = uriEscapeComponentExA(input,
+                input + strlen(input), output, components[i], URI_TRUE, URI_FALSE);
+        const std::string expected =
+                std::string("q+rstuvwxyzabcdefghijklmnopqrstuvwxyz%2B")
+                + ((components[i] == URI_ESCAPE_UNRESERVED) ? "%21" : "!");
+        EXPECT_EQ(std::string(output), expected);
+
+        int charsRequired = -1;
+        ASSERT_EQ(uriEscapeComponentCharsRequiredExA(input, NULL, components[i],
+                          URI_TRUE, URI_FALSE, &charsRequired),
+                URI_SUCCESS);
+        EXPECT_EQ(charsRequired, terminator - output);
+    }
+}
+
+TEST(UriSuite, TestEscapeComponentRoundTrip) {
+    // All bytes but zero, in a long enough run to make use of block skipping
+    std::string input;
+    for (int round = 0; round < 2; round++) {
+        for (int c = 1; c < 256; c++) {
+            input += (char)c;
+        }
+        input += "abcdefghijklmnopqrstuvwxyz0123456789";
+    }
+    const char * const first = input.c_str();
+    const char * const afterLast = first + input.size();
+
+    std::vector<char> userInfo(3 * input.size() + 1);
+    std::vector<char> path(3 * input.size() + 1);
+    std::vector<char> queryValue(3 * input.size() + 1);
+    std::vector<char> fragment(3 * input.size() + 1);
+    uriEscapeComponentExA(
+            first, afterLast, &userInfo[0], URI_ESCAPE_USERINFO, URI_FALSE, URI_FALSE);
+    uriEscapeComponentExA(
+            first, afterLast, &path[0], URI_ESCAPE_PATH, URI_FALSE, URI_FALSE);
+    uriEscapeComponentExA(first, afterLast, &queryValue[0], URI_ESCAPE_QUERY_VALUE,
+            URI_TRUE, URI_FALSE);
+    uriEscapeComponentExA(
+            first, afterLast, &fragment[0], URI_ESCAPE_FRAGMENT, URI_FALSE, URI_FALSE);
+
+    const std::string text = std::string("http://") + &userInfo[0] + "@host/" + &path[0]
+            + "?k=" + &queryValue[0] + "&k2=v2#" + &fragment[0];
+    UriUriA uri;
+    ASSERT_EQ(uriParseSingleUriA(&uri, text.c_str(), NULL), URI_SUCCESS);
+
+    std::string userInfoText(uri.userInfo.first, uri.userInfo.afterLast);
+    uriUnescapeInPlaceA(&userInfoText[0]);
+    EXPECT_EQ(std::string(userInfoText.c_str()), input);
+
+    std::string fragmentText(uri.fragment.first, uri.fragment.afterLast);
+    uriUnescapeInPlaceA(&fragmentText[0]);
+    EXPECT_EQ(std::string(fragmentText.c_str()), input);
+
+    UriQueryListA * queryList = NULL;
+    int itemCount = 0;
+    ASSERT_EQ(uriDissectQueryMallocA(
+                      &queryList, &itemCount, uri.query.first, uri.query.afterLast),
+            URI_SUCCESS);
+    ASSERT_EQ(itemCount, 2);
+    EXPECT_EQ(std::string(queryList->value), input);
+    uriFreeQueryListA(queryList);
+
+    std::string pathText;
+    for (const UriPathSegmentA * walker = uri.pathHead; walker != NULL;
+            walker = walker->next) {
+        if (walker != uri.pathHead) {
+            pathText += '/';
+        }
+        pathText.append(walker->text.first, walker->text.afterLast);
+    }
+    uriUnescapeInPlaceA(&pathText[0]);
+    EXPECT_EQ(std::string(pathText.c_str()), input);
+
+    uriFreeUriMembersA(&uri);
+}
+
 namespace {
 bool testUnescapingHelper(const wchar_t * input, const wchar_t * output,
         bool plusToSpace = false,
@@ -1096,6 +1439,155 @@ TEST(UriSuite, TestUnescaping) {
     ASSERT_TRUE(testUnescapingHelper(
             L"%0a%0d%0a%0d", L"\x0a\x0d\x0a\x0d", PLUS_DONT_TOUCH, URI_BR_DONT_TOUCH));
 }
+TEST(UriSuite, TestUnescapingLongRunsMatchesWide) {
+    const char * const pieces[] = {"%41", "%0d", "%0A", "%0d%0a", "+", "%", "%4", "%4g",
+            "%%41", "\r\n", "%2B", "%ff"};
+    const size_t pieceCount = sizeof(pieces) / sizeof(pieces[0]);
+    const UriBreakConversion modes[] = {
+            URI_BR_TO_LF, URI_BR_TO_CRLF, URI_BR_TO_CR, URI_BR_DONT_TOUCH};
+
+    for (size_t p = 0; p < pieceCount; p++) {
+        for (size_t pos = 0; pos < 40; pos++) {
+            for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+                for (int plusToSpace = 0; plusToSpace < 2; plusToSpace++) {
+                    std::string input(40, 'a');
+                    input.insert(pos, pieces[p]);
+                    input.insert(pos / 2, pieces[(p + 1) % pieceCount]);
+                    SCOPED_TRACE(input);
+                    SCOPED_TRACE(m);
+                    SCOPED_TRACE(plusToSpace);
+
+                    std::vector<char> ansi(input.begin(), input.end());
+                    ansi.push_back('\0');
+                    std::vector<wchar_t> wide(input.begin(), input.end());
+                    wide.push_back(L'\0');
+
+                    const char * const ansiEnd = uriUnescapeInPlaceExA(ansi.data(),
+                            plusToSpace ? URI_TRUE : URI_FALSE, modes[m]);
+                    const wchar_t * const wideEnd = uriUnescapeInPlaceExW(wide.data(),
+                            plusToSpace ? URI_TRUE : URI_FALSE, modes[m]);
+
+                    ASSERT_EQ(ansiEnd - ansi.data(), wideEnd - wide.data());
+                    for (ptrdiff_t i = 0; i <= ansiEnd - ansi.data(); i++) {
+                        ASSERT_EQ(static_cast<unsigned char>(ansi[i]),
+                                static_cast<wchar_t>(wide[i]));
+                    }
+                }
+            }
+        }
+    }
+}
+
+namespace {
+const char * const unescapeSamples[] = {
+        "",
+        "abc",
+        "abc%20%41BC",
+        "%",
+        "%4",
+        "%4z",
+        "%%41",
+        "%%%",
+        "a+b%2Bc",
+        "%0D%0A%0a%0d%0D",
+        "%0d%0ax%0a%0d",
+        "abcdefghijklmnopqrstuvwxyz%41%42%43abcdefghijklmnopqrstuvwxyz+%",
+};
+}  // namespace
+
+TEST(UriSuite, TestUnescapeExMatchesInPlace) {
+    const UriBreakConversion modes[] = {
+            URI_BR_TO_LF, URI_BR_TO_CRLF, URI_BR_TO_CR, URI_BR_DONT_TOUCH};
+
+    for (size_t i = 0; i < sizeof(unescapeSamples) / sizeof(unescapeSamples[0]); i++) {
+        const std::string input = unescapeSamples[i];
+        for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+            for (int plusToSpace = 0; plusToSpace < 2; plusToSpace++) {
+                SCOPED_TRACE(input + " " + std::to_string(m) + " "
+                        + std::to_string(plusToSpace));
+                std::string expected = input;
+                uriUnescapeInPlaceExA(&expected[0], (UriBool)plusToSpace, modes[m]);
+                expected.resize(strlen(expected.c_str()));
+
+                std::vector<char> output(input.size() + 1);
+                const char * const terminator = uriUnescapeExA(input.data(),
+                        input.data() + input.size(), &output[0], (UriBool)plusToSpace,
+                        modes[m]);
+                EXPECT_EQ(std::string(&output[0]), expected);
+                EXPECT_EQ(terminator, &output[0] + expected.size());
+            }
+        }
+    }
+
+    // Range ends before the terminator, in the middle of a percent group
+    const char * const input = "abc%41def";
+    char output[16];
+    uriUnescapeExA(input, input + 5, output, URI_FALSE, URI_BR_DONT_TOUCH);
+    EXPECT_STREQ(output, "abc%4");
+
+    // Zero-terminated input without explicit end
+    wchar_t outputWide[16];
+    uriUnescapeExW(L"a+b%41", NULL, outputWide, URI_TRUE, URI_BR_DONT_TOUCH);
+    EXPECT_STREQ(outputWide, L"a bA");
+
+    EXPECT_TRUE(uriUnescapeExA("abc", NULL, NULL, URI_FALSE, URI_BR_DONT_TOUCH) == NULL);
+}
+
+TEST(UriSuite, TestUnescapeChunkMatchesWhole) {
+    const UriBreakConversion modes[] = {URI_BR_TO_CRLF, URI_BR_DONT_TOUCH};
+
+    for (size_t i = 0; i < sizeof(unescapeSamples) / sizeof(unescapeSamples[0]); i++) {
+        const std::string input = unescapeSamples[i];
+        for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+            std::vector<char> whole(input.size() + 1);
+            uriUnescapeExA(input.data(), input.data() + input.size(), &whole[0],
+                    URI_TRUE, modes[m]);
+
+            // Split into three chunks at every pair of positions
+            for (size_t split1 = 0; split1 <= input.size(); split1++) {
+                for (size_t split2 = split1; split2 <= input.size(); split2++) {
+                    SCOPED_TRACE(input + " " + std::to_string(split1) + " "
+                            + std::to_string(split2));
+                    const size_t splits[] = {0, split1, split2, input.size()};
+                    UriUnescapeStateA state;
+                    uriInitUnescapeStateA(&state);
+                    std::string joined;
+                    for (int chunk = 0; chunk < 3; chunk++) {
+                        std::vector<char> output(splits[chunk + 1] - splits[chunk] + 3);
+                        const char * const terminator = uriUnescapeChunkExA(&state,
+                                input.data() + splits[chunk],
+                                input.data() + splits[chunk + 1], &output[0], URI_TRUE,
+                                modes[m], (UriBool)(chunk == 2));
+                        ASSERT_TRUE(terminator != NULL);
+                        joined.append(&output[0], terminator - &output[0]);
+                    }
+                    EXPECT_EQ(joined, std::string(&whole[0]));
+                }
+            }
+        }
+    }
+}
+
+TEST(UriSuite, TestUnescapeChunkWide) {
+    UriUnescapeStateW state;
+    uriInitUnescapeStateW(&state);
+    const wchar_t * const first = L"a%4";
+    const wchar_t * const second = L"1%0";
+    wchar_t output[8];
+
+    EXPECT_EQ(uriUnescapeChunkExW(&state, first, first + 3, output, URI_FALSE,
+                      URI_BR_DONT_TOUCH, URI_FALSE),
+            output + 1);
+    EXPECT_STREQ(output, L"a");
+    EXPECT_EQ(uriUnescapeChunkExW(&state, second, second + 3, output, URI_FALSE,
+                      URI_BR_DONT_TOUCH, URI_FALSE),
+            output + 1);
+    EXPECT_STREQ(output, L"A");
+    EXPECT_EQ(uriUnescapeChunkExW(
+                      &state, NULL, NULL, output, URI_FALSE, URI_BR_DONT_TOUCH, URI_TRUE),
+            output + 2);
+    EXPECT_STREQ(output, L"%0");
+}
 
 namespace {
 bool testAddBaseHelper(const wchar_t * base, const wchar_t * rel,
@@ -2568,6 +3060,105 @@ TEST(ParseIpFourAddressSuite, FourSaneOctets) {
     EXPECT_EQ(octetOutput[3], 40);
 }
 
+namespace {
+void expectSameAsReferenceIpFour(const std::string & text) {
+    unsigned char octets[4] = {0, 0, 0, 0};
+    unsigned char referenceOctets[4] = {0, 0, 0, 0};
+    const char * const first = text.data();
+    const char * const afterLast = first + text.size();
+    const int res = uriParseIpFourAddressA(octets, first, afterLast);
+    const int referenceRes = uri_TESTING_ONLY_ParseIpFourAddressReferenceA(
+            referenceOctets, first, afterLast);
+    ASSERT_EQ(res, referenceRes) << "\"" << text << "\"";
+    if (res == URI_SUCCESS) {
+        ASSERT_EQ(memcmp(octets, referenceOctets, 4), 0) << "\"" << text << "\"";
+    }
+}
+}  // namespace
+
+TEST(ParseIpFourAddressSuite, AgreesWithReferenceExhaustiveShort) {
+    // All strings of up to 7 characters over an alphabet hitting every
+    // branch of the dec-octet grammar
+    const char alphabet[] = {'0', '1', '2', '5', '6', '9', '.', 'x'};
+    const size_t alphabetSize = sizeof(alphabet);
+    for (size_t len = 0; len <= 7; len++) {
+        size_t combinations = 1;
+        for (size_t i = 0; i < len; i++) {
+            combinations *= alphabetSize;
+        }
+        std::string text(len, ' ');
+        for (size_t n = 0; n < combinations; n++) {
+            size_t rest = n;
+            for (size_t i = 0; i < len; i++) {
+                text[i] = alphabet[rest % alphabetSize];
+                rest /= alphabetSize;
+            }
+            expectSameAsReferenceIpFour(text);
+            if (::testing::Test::HasFatalFailure()) {
+                return;
+            }
+        }
+    }
+}
+
+TEST(ParseIpFourAddressSuite, AgreesWithReferenceRandomTokens) {
+    const char * const tokens[] = {"0", "00", "01", "1", "9", "10", "25", "99", "100",
+            "199", "200", "249", "250", "255", "256", "260", "300", "999", "1000", "",
+            "a", "-1", " ", "\x80", "\xae", "\xb0"};
+    const size_t tokenCount = sizeof(tokens) / sizeof(tokens[0]);
+    const char separators[] = {'.', '.', '.', '.', '.', '.', ':', '/', '\0'};
+    const size_t separatorCount = sizeof(separators);
+
+    unsigned int seed = 1;
+    for (int round = 0; round < 200000; round++) {
+        std::string text;
+        seed = seed * 1103515245U + 12345U;
+        const unsigned int tokensWanted = 3 + (seed >> 16) % 3;
+        for (unsigned int k = 0; k < tokensWanted; k++) {
+            if (k > 0) {
+                seed = seed * 1103515245U + 12345U;
+                text += separators[(seed >> 16) % separatorCount];
+            }
+            seed = seed * 1103515245U + 12345U;
+            text += tokens[(seed >> 16) % tokenCount];
+        }
+        expectSameAsReferenceIpFour(text);
+        if (::testing::Test::HasFatalFailure()) {
+            return;
+        }
+    }
+}
+
+TEST(ParseIpFourAddressSuite, AllOctetValuesInAllPositions) {
+    for (int position = 0; position < 4; position++) {
+        for (int value = 0; value < 1000; value++) {
+            std::string text;
+            for (int i = 0; i < 4; i++) {
+                if (i > 0) {
+                    text += '.';
+                }
+                text += std::to_string((i == position) ? value : 255 - i);
+            }
+            expectSameAsReferenceIpFour(text);
+            if (::testing::Test::HasFatalFailure()) {
+                return;
+            }
+        }
+    }
+}
+
+TEST(ParseIpFourAddressSuite, WideCharsNotAliasingAsciiDigitsOrDots) {
+    unsigned char octets[4];
+    const wchar_t * const inputs[] = {
+            L"1.2.3.4\x0130", L"1.2.3\x012e" L"4", L"\x0131.2.3.4", L"1.2.3.4\x0100"};
+    EXPECT_EQ(uriParseIpFourAddressW(octets, L"1.2.3.4", L"1.2.3.4" + 7), URI_SUCCESS);
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        SCOPED_TRACE(i);
+        const wchar_t * const afterLast = inputs[i] + wcslen(inputs[i]);
+        EXPECT_EQ(uriParseIpFourAddressW(octets, inputs[i], afterLast), URI_ERROR_SYNTAX);
+    }
+}
+
 TEST(UriSuite, NoStackOverflowIssue282) {
     const size_t sizeBytes = 2 * 1024 * 1024;
 
@@ -2583,6 +3174,524 @@ TEST(UriSuite, NoStackOverflowIssue282) {
     delete[] uriString;
 }
 
+namespace {
+
+const size_t kSmallStackSize = 256 * 1024;
+
+void * parseRepetitionsOnSmallStack(void * /*arg*/) {
+    const size_t repeat = 256 * 1024;
+    const char * const inputs[][3] = {
+            // prefix, repeated part, suffix
+            {"", "/", ""},
+            {"", "a/", ""},
+            {"", "%41", ""},
+            {"a", "@", ""},
+            {"", "a", ":"},
+            {"//", "%41", "@host"},
+            {"//user:", "a", "@host"},
+            {"//", "%41", ""},
+            {"//host:", "1", ""},
+            {"//[v1.", "a", "]"},
+            {"?", "%41/?", ""},
+            {"#", "%41/?", ""},
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        SCOPED_TRACE(i);
+        std::string text(inputs[i][0]);
+        text.reserve(text.size() + repeat * strlen(inputs[i][1]) + strlen(inputs[i][2]));
+        for (size_t k = 0; k < repeat; k++) {
+            text += inputs[i][1];
+        }
+        text += inputs[i][2];
+
+        EXPECT_EQ(uriValidateUriExA(text.data(), text.data() + text.size(), NULL),
+                URI_SUCCESS);
+
+        UriUriA uri;
+        EXPECT_EQ(uriParseSingleUriExA(
+                          &uri, text.data(), text.data() + text.size(), NULL),
+                URI_SUCCESS);
+        uriFreeUriMembersA(&uri);
+    }
+    return NULL;
+}
+
+#ifdef _WIN32
+DWORD WINAPI parseRepetitionsOnSmallStackWin32(LPVOID arg) {
+    parseRepetitionsOnSmallStack(arg);
+    return 0;
+}
+#endif
+
+}  // namespace
+
+TEST(UriSuite, NoStackOverflowForAnyRepetition) {
+    // NOTE: A parser that recursed per character would overflow this stack
+#ifdef _WIN32
+    HANDLE const thread = CreateThread(NULL, kSmallStackSize,
+            parseRepetitionsOnSmallStackWin32, NULL, STACK_SIZE_PARAM_IS_A_RESERVATION,
+            NULL);
+    ASSERT_TRUE(thread != NULL);
+    ASSERT_EQ(WaitForSingleObject(thread, INFINITE), WAIT_OBJECT_0);
+    CloseHandle(thread);
+#else
+    pthread_attr_t attributes;
+    pthread_t thread;
+    ASSERT_EQ(pthread_attr_init(&attributes), 0);
+    ASSERT_EQ(pthread_attr_setstacksize(&attributes, kSmallStackSize), 0);
+    ASSERT_EQ(pthread_create(&thread, &attributes, parseRepetitionsOnSmallStack, NULL),
+            0);
+    ASSERT_EQ(pthread_join(thread, NULL), 0);
+    pthread_attr_destroy(&attributes);
+#endif
+}
+
+TEST(ParseBatchSuite, MixedValidAndInvalidItems) {
+    const char * const firsts[] = {"http://example.org/a", "http://[::1/", NULL, "b?c#d"};
+    const size_t count = sizeof(firsts) / sizeof(firsts[0]);
+    UriUriA uris[count];
+    int errorCodes[count];
+    const char * errorPositions[count];
+
+    EXPECT_EQ(uriParseBatchExMmA(uris, firsts, NULL, count, errorCodes, errorPositions,
+                      NULL),
+            URI_ERROR_SYNTAX);
+
+    EXPECT_EQ(errorCodes[0], URI_SUCCESS);
+    EXPECT_EQ(errorCodes[1], URI_ERROR_SYNTAX);
+    EXPECT_EQ(errorCodes[2], URI_ERROR_NULL);
+    EXPECT_EQ(errorCodes[3], URI_SUCCESS);
+
+    EXPECT_TRUE(errorPositions[0] == NULL);
+    EXPECT_EQ(errorPositions[1], firsts[1] + 11);
+    EXPECT_TRUE(errorPositions[2] == NULL);
+    EXPECT_TRUE(errorPositions[3] == NULL);
+
+    EXPECT_EQ(std::string(uris[0].hostText.first, uris[0].hostText.afterLast),
+            "example.org");
+    EXPECT_EQ(std::string(uris[3].fragment.first, uris[3].fragment.afterLast), "d");
+
+    for (size_t i = 0; i < count; i++) {
+        uriFreeUriMembersA(&uris[i]);
+    }
+}
+
+TEST(ParseBatchSuite, ExplicitAfterLastsMatchSingleParse) {
+    const wchar_t * const text = L"http://a/b?c#d";
+    const wchar_t * const firsts[] = {text, text, text};
+    const wchar_t * const afterLasts[] = {text + 8, text + 10, text + wcslen(text)};
+    UriUriW uris[3];
+    int errorCodes[3];
+
+    ASSERT_EQ(uriParseBatchExMmW(uris, firsts, afterLasts, 3, errorCodes, NULL, NULL),
+            URI_SUCCESS);
+
+    for (size_t i = 0; i < 3; i++) {
+        UriUriW single;
+        EXPECT_EQ(errorCodes[i], URI_SUCCESS);
+        ASSERT_EQ(uriParseSingleUriExMmW(&single, firsts[i], afterLasts[i], NULL, NULL),
+                URI_SUCCESS);
+        EXPECT_EQ(uriEqualsUriW(&uris[i], &single), URI_TRUE);
+        uriFreeUriMembersW(&single);
+        uriFreeUriMembersW(&uris[i]);
+    }
+}
+
+TEST(ParseBatchSuite, InvalidParameters) {
+    const char * const firsts[] = {"a"};
+    UriUriA uri;
+
+    EXPECT_EQ(uriParseBatchExMmA(NULL, firsts, NULL, 1, NULL, NULL, NULL),
+            URI_ERROR_NULL);
+    EXPECT_EQ(uriParseBatchExMmA(&uri, NULL, NULL, 1, NULL, NULL, NULL), URI_ERROR_NULL);
+    EXPECT_EQ(uriParseBatchExMmA(NULL, NULL, NULL, 0, NULL, NULL, NULL), URI_SUCCESS);
+}
+
+TEST(ParseBatchSuite, ParallelMatchesSequential) {
+    const size_t count = 1000;
+    const unsigned int threadCount = 4;
+    std::vector<std::string> texts;
+    for (size_t i = 0; i < count; i++) {
+        char text[100];
+        snprintf(text, sizeof(text),
+                (i % 97 == 13) ? "http://[%u/x" : "http://host%u.test/a/b?q#f",
+                (unsigned int)i);
+        texts.push_back(text);
+    }
+    std::vector<const char *> firsts;
+    for (size_t i = 0; i < count; i++) {
+        firsts.push_back(texts[i].c_str());
+    }
+
+    UriMemoryManager memoryManagers[threadCount];
+    UriMemoryArena arenas[threadCount];
+    UriMemoryManager * memories[threadCount];
+    for (unsigned int i = 0; i < threadCount; i++) {
+        ASSERT_EQ(uriInitArenaMemoryManager(
+                          &memoryManagers[i], &arenas[i], NULL, 0, 4096, NULL),
+                URI_SUCCESS);
+        memories[i] = &memoryManagers[i];
+    }
+
+    std::vector<UriUriA> expectedUris(count);
+    std::vector<int> expectedErrorCodes(count);
+    std::vector<const char *> expectedErrorPositions(count);
+    const int expectedRes = uriParseBatchExMmA(&expectedUris[0], &firsts[0], NULL, count,
+            &expectedErrorCodes[0], &expectedErrorPositions[0], NULL);
+    EXPECT_EQ(expectedRes, URI_ERROR_SYNTAX);
+
+    std::vector<UriUriA> uris(count);
+    std::vector<int> errorCodes(count);
+    std::vector<const char *> errorPositions(count);
+    std::vector<unsigned int> memoryIndices(count);
+    const int res = uriParseBatchParallelExMmA(&uris[0], &firsts[0], NULL, count,
+            &errorCodes[0], &errorPositions[0], threadCount, memories,
+            &memoryIndices[0]);
+    EXPECT_EQ(res, expectedRes);
+
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(errorCodes[i], expectedErrorCodes[i]);
+        EXPECT_EQ(errorPositions[i], expectedErrorPositions[i]);
+        ASSERT_LT(memoryIndices[i], threadCount);
+        if (errorCodes[i] == URI_SUCCESS) {
+            EXPECT_EQ(uriEqualsUriA(&uris[i], &expectedUris[i]), URI_TRUE);
+            uriFreeUriMembersMmA(&uris[i], memories[memoryIndices[i]]);
+            uriFreeUriMembersA(&expectedUris[i]);
+        }
+    }
+
+    for (unsigned int i = 0; i < threadCount; i++) {
+        uriFreeMemoryArena(&arenas[i]);
+    }
+}
+
+TEST(ParseBatchSuite, ParallelDefaultMemoryManager) {
+    const char * const firsts[] = {"a", "b:c", "//d/e", "#f"};
+    const size_t count = sizeof(firsts) / sizeof(firsts[0]);
+    UriUriA uris[count];
+
+    for (unsigned int threadCount = 0; threadCount < 3; threadCount++) {
+        ASSERT_EQ(uriParseBatchParallelExMmA(uris, firsts, NULL, count, NULL, NULL,
+                          threadCount, NULL, NULL),
+                URI_SUCCESS);
+        for (size_t i = 0; i < count; i++) {
+            uriFreeUriMembersA(&uris[i]);
+        }
+    }
+}
+
+TEST(ParseBatchSuite, ParallelIncompleteMemoryManager) {
+    const char * const firsts[] = {"a"};
+    UriUriA uri;
+    UriMemoryManager incomplete;
+    memset(&incomplete, 0, sizeof(incomplete));
+    UriMemoryManager * const memories[] = {NULL, &incomplete};
+
+    EXPECT_EQ(uriParseBatchParallelExMmA(&uri, firsts, NULL, 1, NULL, NULL, 2, memories,
+                      NULL),
+            URI_ERROR_MEMORY_MANAGER_INCOMPLETE);
+}
+
+TEST(ValidateSuite, AgreesWithParsing) {
+    const char * const inputs[] = {
+            "http://[::1]/",
+            "http://[::1.2.3.4]:80/",
+            "http://[1:2:3:4:5:6:7:8]",
+            "http://[1:2:3:4:5:6:7:8:9]",
+            "http://[::1",
+            "http://[v7.x]/",
+            "http://[vz.x]/",
+            "http://1.2.3.4/",
+            "http://1.2.3.400/",
+            "http://user@host:80/a/b?c#d",
+            "http://user@host:8a/",
+            "http://a/%zz",
+            "http://a/b c",
+            "1http:",
+            "//a:b@/",
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        SCOPED_TRACE(inputs[i]);
+        UriUriA uri;
+        const char * parseErrorPos = NULL;
+        const char * validateErrorPos = NULL;
+
+        const int parseRes = uriParseSingleUriA(&uri, inputs[i], &parseErrorPos);
+        if (parseRes == URI_SUCCESS) {
+            uriFreeUriMembersA(&uri);
+        }
+
+        EXPECT_EQ(uriValidateUriExA(inputs[i], NULL, &validateErrorPos), parseRes);
+        EXPECT_EQ(validateErrorPos, parseErrorPos);
+    }
+}
+
+TEST(ValidateSuite, ExplicitRangeAndWideCharacters) {
+    const wchar_t * const text = L"http://example.org/ with trailing garbage";
+    const wchar_t * errorPos = NULL;
+
+    EXPECT_EQ(uriValidateUriExW(text, text + 19, &errorPos), URI_SUCCESS);
+    EXPECT_EQ(uriValidateUriExW(text, NULL, &errorPos), URI_ERROR_SYNTAX);
+    EXPECT_EQ(errorPos, text + 19);
+    EXPECT_EQ(uriValidateUriExW(NULL, NULL, NULL), URI_ERROR_NULL);
+}
+
+TEST(RepairSuite, CleanInputIsParsedInPlace) {
+    const char * const input = "http://example.org/a?b#c";
+    char out[16] = "untouched";
+    int charsRequired = -1;
+    UriBool repaired = URI_TRUE;
+    UriUriA uri;
+
+    ASSERT_EQ(uriParseSingleUriRepairA(&uri, input, NULL, out, sizeof(out),
+                      &charsRequired, &repaired, NULL),
+            URI_SUCCESS);
+    EXPECT_EQ(charsRequired, 0);
+    EXPECT_EQ(repaired, URI_FALSE);
+    EXPECT_EQ(uri.scheme.first, input);
+    EXPECT_STREQ(out, "untouched");
+    uriFreeUriMembersA(&uri);
+}
+
+TEST(RepairSuite, EscapesPerComponent) {
+    const char * const inputs[][2] = {
+            {"http://example.org/a b", "http://example.org/a%20b"},
+            {"http://example.org/a|b^c", "http://example.org/a%7Cb%5Ec"},
+            {"http://example.org/\xC3\xA4", "http://example.org/%C3%A4"},
+            {"http://example.org/100%", "http://example.org/100%25"},
+            {"http://example.org/%41%zz", "http://example.org/%41%25zz"},
+            {"http://us er@exa mple.org:80/", "http://us%20er@exa%20mple.org:80/"},
+            {"http://a@b@c/", "http://a%40b@c/"},
+            {"http://[::1]/a b", "http://[::1]/a%20b"},
+            {"http://a/?q=a b&r=/?", "http://a/?q=a%20b&r=/?"},
+            {"http://a/#f#g h", "http://a/#f%23g%20h"},
+            {"ht^tp://x", "ht%5Etp%3A//x"},
+            {"a b:c/d:e", "a%20b%3Ac/d:e"},
+            {"http://h/a/b?q=1#f g", "http://h/a/b?q=1#f%20g"},
+            {"x/y:z/a b", "x/y:z/a%20b"},
+            {"http://@@h/", "http://%40@h/"},
+            {"http://u:p w@h/", "http://u:p%20w@h/"},
+            {"http://h/a b?c d#e f", "http://h/a%20b?c%20d#e%20f"},
+            {"%zz:a", "%25zz%3Aa"},
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        SCOPED_TRACE(inputs[i][0]);
+        const char * const input = inputs[i][0];
+        std::vector<char> out(3 * strlen(input) + 1);
+        int charsRequired = 0;
+        UriBool repaired = URI_FALSE;
+        UriUriA uri;
+
+        ASSERT_EQ(uriParseSingleUriRepairMmA(&uri, input, input + strlen(input),
+                          out.data(), static_cast<int>(out.size()), &charsRequired,
+                          &repaired, NULL, NULL),
+                URI_SUCCESS);
+        EXPECT_EQ(repaired, URI_TRUE);
+        EXPECT_STREQ(out.data(), inputs[i][1]);
+        EXPECT_EQ(charsRequired, static_cast<int>(strlen(inputs[i][1])));
+
+        /* Same as parsing the repaired copy */
+        UriUriA expected;
+        ASSERT_EQ(uriParseSingleUriA(&expected, out.data(), NULL), URI_SUCCESS);
+        EXPECT_EQ(uriEqualsUriA(&uri, &expected), URI_TRUE);
+        uriFreeUriMembersA(&expected);
+        uriFreeUriMembersA(&uri);
+    }
+}
+
+TEST(RepairSuite, UnrepairableInput) {
+    const char * const input = "http://[::1x]/a b";
+    char out[3 * 17 + 1];
+    const char * errorPos = NULL;
+    UriUriA uri;
+
+    ASSERT_EQ(uriParseSingleUriRepairA(
+                      &uri, input, NULL, out, sizeof(out), NULL, NULL, &errorPos),
+            URI_ERROR_SYNTAX);
+    EXPECT_EQ(errorPos, out + 11);
+    EXPECT_STREQ(out, input);
+
+    /* Ports are copied as is, they cannot be user info without an "@" */
+    const char * const port = "http://h:80a b/";
+    ASSERT_EQ(uriParseSingleUriRepairA(
+                      &uri, port, NULL, out, sizeof(out), NULL, NULL, &errorPos),
+            URI_ERROR_SYNTAX);
+    EXPECT_EQ(errorPos, out + 11);
+
+    EXPECT_EQ(uriParseSingleUriRepairA(
+                      NULL, input, NULL, out, sizeof(out), NULL, NULL, NULL),
+            URI_ERROR_NULL);
+    EXPECT_EQ(uriParseSingleUriRepairA(
+                      &uri, input, NULL, NULL, sizeof(out), NULL, NULL, NULL),
+            URI_ERROR_NULL);
+}
+
+TEST(RepairSuite, OutputCapacity) {
+    const char * const input = "http://example.org/a b|c";
+    const char * const expected = "http://example.org/a%20b%7Cc";
+    const int length = static_cast<int>(strlen(expected));
+    std::vector<char> out(length + 1);
+    int charsRequired = 0;
+    UriBool repaired = URI_TRUE;
+    UriUriA uri;
+
+    EXPECT_EQ(uriParseSingleUriRepairA(&uri, input, NULL, out.data(), length,
+                      &charsRequired, &repaired, NULL),
+            URI_ERROR_OUTPUT_TOO_LARGE);
+    EXPECT_EQ(charsRequired, length);
+    EXPECT_EQ(repaired, URI_FALSE);
+    EXPECT_EQ(uriParseSingleUriRepairA(
+                      &uri, input, NULL, out.data(), 0, &charsRequired, NULL, NULL),
+            URI_ERROR_OUTPUT_TOO_LARGE);
+    EXPECT_EQ(charsRequired, length);
+
+    ASSERT_EQ(uriParseSingleUriRepairA(&uri, input, NULL, out.data(), length + 1,
+                      &charsRequired, &repaired, NULL),
+            URI_SUCCESS);
+    EXPECT_EQ(repaired, URI_TRUE);
+    EXPECT_STREQ(out.data(), expected);
+    uriFreeUriMembersA(&uri);
+
+    /* Clean input needs no room at all */
+    ASSERT_EQ(uriParseSingleUriRepairA(
+                      &uri, expected, NULL, out.data(), 0, &charsRequired, NULL, NULL),
+            URI_SUCCESS);
+    EXPECT_EQ(charsRequired, 0);
+    uriFreeUriMembersA(&uri);
+}
+
+TEST(RepairSuite, WideCharacters) {
+    const wchar_t * const input = L"http://example.org/a b";
+    wchar_t out[3 * 22 + 1];
+    UriBool repaired = URI_FALSE;
+    UriUriW uri;
+
+    ASSERT_EQ(uriParseSingleUriRepairW(&uri, input, NULL, out,
+                      sizeof(out) / sizeof(out[0]), NULL, &repaired, NULL),
+            URI_SUCCESS);
+    EXPECT_EQ(repaired, URI_TRUE);
+    EXPECT_STREQ(out, L"http://example.org/a%20b");
+    uriFreeUriMembersW(&uri);
+}
+
+TEST(RepairSuite, WideCharactersBeyondAscii) {
+    const wchar_t * const inputs[][2] = {
+            {L"http://h/a\x4E2D" L"b c", L"http://h/a%E4%B8%ADb%20c"},
+            {L"http://h/\x00E4?\x65E5\x672C", L"http://h/%C3%A4?%E6%97%A5%E6%9C%AC"},
+#if WCHAR_MAX > 0xFFFF
+            {L"http://h/#\x1F600", L"http://h/#%F0%9F%98%80"},
+#else
+            {L"http://h/#\xD83D\xDE00", L"http://h/#%F0%9F%98%80"},
+#endif
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        SCOPED_TRACE(i);
+        const wchar_t * const input = inputs[i][0];
+        std::vector<wchar_t> out(12 * wcslen(input) + 1);
+        UriBool repaired = URI_FALSE;
+        UriUriW uri;
+
+        ASSERT_EQ(uriParseSingleUriRepairW(&uri, input, NULL, out.data(),
+                          static_cast<int>(out.size()), NULL, &repaired, NULL),
+                URI_SUCCESS);
+        EXPECT_EQ(repaired, URI_TRUE);
+        EXPECT_STREQ(out.data(), inputs[i][1]);
+        uriFreeUriMembersW(&uri);
+    }
+}
+
+TEST(IriSuite, ParseAndRecomposeAsUri) {
+    const char * const input = "http://b\xC3\xBC" "cher.example/stra\xC3\x9F" "e"
+                               "?q=\xE6\x97\xA5\xE6\x9C\xAC#frag\xE2\x82\xAC";
+    const char * const expected = "http://b%C3%BCcher.example/stra%C3%9Fe"
+                                  "?q=%E6%97%A5%E6%9C%AC#frag%E2%82%AC";
+    UriUriA uri;
+
+    ASSERT_EQ(uriParseSingleUriOptionsA(&uri, input, NULL, NULL, URI_PARSE_DEFAULT),
+            URI_ERROR_SYNTAX);
+    ASSERT_EQ(uriParseSingleUriOptionsA(&uri, input, NULL, NULL, URI_PARSE_IRI),
+            URI_SUCCESS);
+    EXPECT_EQ(std::string(uri.hostText.first, uri.hostText.afterLast),
+            "b\xC3\xBC" "cher.example");
+
+    int charsRequired = 0;
+    ASSERT_EQ(uriToStringAsUriCharsRequiredA(&uri, &charsRequired), URI_SUCCESS);
+    EXPECT_EQ(charsRequired, static_cast<int>(strlen(expected)));
+
+    std::vector<char> buffer(charsRequired + 1);
+    int charsWritten = 0;
+    ASSERT_EQ(uriToStringAsUriA(buffer.data(), &uri, charsRequired + 1, &charsWritten),
+            URI_SUCCESS);
+    EXPECT_STREQ(buffer.data(), expected);
+    EXPECT_EQ(charsWritten, charsRequired + 1);
+    EXPECT_EQ(uriToStringAsUriA(buffer.data(), &uri, charsRequired, NULL),
+            URI_ERROR_TOSTRING_TOO_LONG);
+
+    uriFreeUriMembersA(&uri);
+}
+
+TEST(IriSuite, AcceptedWhereIunreservedIs) {
+    const char * const inputs[] = {
+            "\xE6\x97\xA5/x", // first segment of relative reference
+            "a\xC3\xA4/b:c", // scheme-like start
+            "//\xC3\xBC:pw@host/",
+            "//host\xC3\xA4:80/",
+            "mailto:\xC3\xA4@example.org",
+            "http://a/?\xEE\x80\x80", // iprivate in query
+            "http://a/\xF0\x9F\x98\x80",
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        SCOPED_TRACE(inputs[i]);
+        UriUriA uri;
+        ASSERT_EQ(uriParseSingleUriOptionsA(&uri, inputs[i], NULL, NULL, URI_PARSE_IRI),
+                URI_SUCCESS);
+        uriFreeUriMembersA(&uri);
+    }
+}
+
+TEST(IriSuite, RejectsMalformedAndDisallowed) {
+    const char * const inputs[][2] = {
+            // input, offset of error
+            {"http://a/\xC3", "9"}, // truncated
+            {"http://a/\xC0\xAF", "9"}, // overlong
+            {"http://a/\xED\xA0\x80", "9"}, // surrogate
+            {"http://a/\xC2\x80", "9"}, // not a ucschar
+            {"http://a/\xEE\x80\x80", "9"}, // iprivate outside of query
+            {"http://a/#\xEE\x80\x80", "10"}, // iprivate in fragment
+            {"\xC3\xA4:b", "2"}, // not a scheme
+            {"a\xC3\xA4:b", "3"},
+            {"http://[\xC3\xA4]/", "8"},
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        SCOPED_TRACE(inputs[i][0]);
+        const char * errorPos = NULL;
+        UriUriA uri;
+        ASSERT_EQ(uriParseSingleUriOptionsA(
+                          &uri, inputs[i][0], NULL, &errorPos, URI_PARSE_IRI),
+                URI_ERROR_SYNTAX);
+        EXPECT_EQ(errorPos, inputs[i][0] + atoi(inputs[i][1]));
+    }
+}
+
+TEST(IriSuite, WideCharacters) {
+    const wchar_t * const input = L"http://b\u00FCcher/\u65E5?\uE000";
+    UriUriW uri;
+
+    ASSERT_EQ(uriParseSingleUriOptionsW(&uri, input, NULL, NULL, URI_PARSE_IRI),
+            URI_SUCCESS);
+
+    wchar_t buffer[64];
+    ASSERT_EQ(uriToStringAsUriW(buffer, &uri, 64, NULL), URI_SUCCESS);
+    EXPECT_STREQ(buffer, L"http://b%C3%BCcher/%E6%97%A5?%EE%80%80");
+    uriFreeUriMembersW(&uri);
+}
+
 int main(int argc, char ** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();